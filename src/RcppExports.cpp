@@ -11,124 +11,197 @@ Rcpp::Rostream<false>& Rcpp::Rcerr = Rcpp::Rcpp_cerr_get();
 #endif
 
 // mgrs_to_latlng
-DataFrame mgrs_to_latlng(std::vector < std::string > MGRS, bool degrees, bool include_mgrs_ref);
-RcppExport SEXP _mgrs_mgrs_to_latlng(SEXP MGRSSEXP, SEXP degreesSEXP, SEXP include_mgrs_refSEXP) {
+DataFrame mgrs_to_latlng(CharacterVector MGRS, bool degrees, bool include_mgrs_ref, int nthreads, bool include_error_code, SEXP converter);
+RcppExport SEXP _mgrs_mgrs_to_latlng(SEXP MGRSSEXP, SEXP degreesSEXP, SEXP include_mgrs_refSEXP, SEXP nthreadsSEXP, SEXP include_error_codeSEXP, SEXP converterSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
-    Rcpp::traits::input_parameter< std::vector < std::string > >::type MGRS(MGRSSEXP);
+    Rcpp::traits::input_parameter< CharacterVector >::type MGRS(MGRSSEXP);
     Rcpp::traits::input_parameter< bool >::type degrees(degreesSEXP);
     Rcpp::traits::input_parameter< bool >::type include_mgrs_ref(include_mgrs_refSEXP);
-    rcpp_result_gen = Rcpp::wrap(mgrs_to_latlng(MGRS, degrees, include_mgrs_ref));
+    Rcpp::traits::input_parameter< int >::type nthreads(nthreadsSEXP);
+    Rcpp::traits::input_parameter< bool >::type include_error_code(include_error_codeSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type converter(converterSEXP);
+    rcpp_result_gen = Rcpp::wrap(mgrs_to_latlng(MGRS, degrees, include_mgrs_ref, nthreads, include_error_code, converter));
     return rcpp_result_gen;
 END_RCPP
 }
 // latlng_to_mgrs
-String latlng_to_mgrs(double latitude, double longitude, bool degrees, int precision);
-RcppExport SEXP _mgrs_latlng_to_mgrs(SEXP latitudeSEXP, SEXP longitudeSEXP, SEXP degreesSEXP, SEXP precisionSEXP) {
+CharacterVector latlng_to_mgrs(NumericVector latitude, NumericVector longitude, bool degrees, IntegerVector precision, SEXP converter, std::string accuracy);
+RcppExport SEXP _mgrs_latlng_to_mgrs(SEXP latitudeSEXP, SEXP longitudeSEXP, SEXP degreesSEXP, SEXP precisionSEXP, SEXP converterSEXP, SEXP accuracySEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
-    Rcpp::traits::input_parameter< double >::type latitude(latitudeSEXP);
-    Rcpp::traits::input_parameter< double >::type longitude(longitudeSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type latitude(latitudeSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type longitude(longitudeSEXP);
     Rcpp::traits::input_parameter< bool >::type degrees(degreesSEXP);
-    Rcpp::traits::input_parameter< int >::type precision(precisionSEXP);
-    rcpp_result_gen = Rcpp::wrap(latlng_to_mgrs(latitude, longitude, degrees, precision));
+    Rcpp::traits::input_parameter< IntegerVector >::type precision(precisionSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type converter(converterSEXP);
+    Rcpp::traits::input_parameter< std::string >::type accuracy(accuracySEXP);
+    rcpp_result_gen = Rcpp::wrap(latlng_to_mgrs(latitude, longitude, degrees, precision, converter, accuracy));
     return rcpp_result_gen;
 END_RCPP
 }
 // utm_to_mgrs
-String utm_to_mgrs(long zone, std::string hemisphere, double easting, double northing, long precision);
-RcppExport SEXP _mgrs_utm_to_mgrs(SEXP zoneSEXP, SEXP hemisphereSEXP, SEXP eastingSEXP, SEXP northingSEXP, SEXP precisionSEXP) {
+CharacterVector utm_to_mgrs(IntegerVector zone, CharacterVector hemisphere, NumericVector easting, NumericVector northing, IntegerVector precision, SEXP converter);
+RcppExport SEXP _mgrs_utm_to_mgrs(SEXP zoneSEXP, SEXP hemisphereSEXP, SEXP eastingSEXP, SEXP northingSEXP, SEXP precisionSEXP, SEXP converterSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
-    Rcpp::traits::input_parameter< long >::type zone(zoneSEXP);
-    Rcpp::traits::input_parameter< std::string >::type hemisphere(hemisphereSEXP);
-    Rcpp::traits::input_parameter< double >::type easting(eastingSEXP);
-    Rcpp::traits::input_parameter< double >::type northing(northingSEXP);
-    Rcpp::traits::input_parameter< long >::type precision(precisionSEXP);
-    rcpp_result_gen = Rcpp::wrap(utm_to_mgrs(zone, hemisphere, easting, northing, precision));
+    Rcpp::traits::input_parameter< IntegerVector >::type zone(zoneSEXP);
+    Rcpp::traits::input_parameter< CharacterVector >::type hemisphere(hemisphereSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type easting(eastingSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type northing(northingSEXP);
+    Rcpp::traits::input_parameter< IntegerVector >::type precision(precisionSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type converter(converterSEXP);
+    rcpp_result_gen = Rcpp::wrap(utm_to_mgrs(zone, hemisphere, easting, northing, precision, converter));
     return rcpp_result_gen;
 END_RCPP
 }
 // mgrs_to_utm
-DataFrame mgrs_to_utm(std::vector < std::string > mgrs_string, bool include_mgrs_ref);
-RcppExport SEXP _mgrs_mgrs_to_utm(SEXP mgrs_stringSEXP, SEXP include_mgrs_refSEXP) {
+DataFrame mgrs_to_utm(CharacterVector mgrs_string, bool include_mgrs_ref, int nthreads, bool include_error_code, SEXP converter);
+RcppExport SEXP _mgrs_mgrs_to_utm(SEXP mgrs_stringSEXP, SEXP include_mgrs_refSEXP, SEXP nthreadsSEXP, SEXP include_error_codeSEXP, SEXP converterSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
-    Rcpp::traits::input_parameter< std::vector < std::string > >::type mgrs_string(mgrs_stringSEXP);
+    Rcpp::traits::input_parameter< CharacterVector >::type mgrs_string(mgrs_stringSEXP);
     Rcpp::traits::input_parameter< bool >::type include_mgrs_ref(include_mgrs_refSEXP);
-    rcpp_result_gen = Rcpp::wrap(mgrs_to_utm(mgrs_string, include_mgrs_ref));
+    Rcpp::traits::input_parameter< int >::type nthreads(nthreadsSEXP);
+    Rcpp::traits::input_parameter< bool >::type include_error_code(include_error_codeSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type converter(converterSEXP);
+    rcpp_result_gen = Rcpp::wrap(mgrs_to_utm(mgrs_string, include_mgrs_ref, nthreads, include_error_code, converter));
     return rcpp_result_gen;
 END_RCPP
 }
 // ups_to_mgrs
-String ups_to_mgrs(std::string hemisphere, double easting, double northing, long precision);
-RcppExport SEXP _mgrs_ups_to_mgrs(SEXP hemisphereSEXP, SEXP eastingSEXP, SEXP northingSEXP, SEXP precisionSEXP) {
+CharacterVector ups_to_mgrs(CharacterVector hemisphere, NumericVector easting, NumericVector northing, IntegerVector precision, SEXP converter);
+RcppExport SEXP _mgrs_ups_to_mgrs(SEXP hemisphereSEXP, SEXP eastingSEXP, SEXP northingSEXP, SEXP precisionSEXP, SEXP converterSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
-    Rcpp::traits::input_parameter< std::string >::type hemisphere(hemisphereSEXP);
-    Rcpp::traits::input_parameter< double >::type easting(eastingSEXP);
-    Rcpp::traits::input_parameter< double >::type northing(northingSEXP);
-    Rcpp::traits::input_parameter< long >::type precision(precisionSEXP);
-    rcpp_result_gen = Rcpp::wrap(ups_to_mgrs(hemisphere, easting, northing, precision));
+    Rcpp::traits::input_parameter< CharacterVector >::type hemisphere(hemisphereSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type easting(eastingSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type northing(northingSEXP);
+    Rcpp::traits::input_parameter< IntegerVector >::type precision(precisionSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type converter(converterSEXP);
+    rcpp_result_gen = Rcpp::wrap(ups_to_mgrs(hemisphere, easting, northing, precision, converter));
     return rcpp_result_gen;
 END_RCPP
 }
 // mgrs_to_ups
-DataFrame mgrs_to_ups(std::vector < std::string > mgrs_string, bool include_mgrs_ref);
-RcppExport SEXP _mgrs_mgrs_to_ups(SEXP mgrs_stringSEXP, SEXP include_mgrs_refSEXP) {
+DataFrame mgrs_to_ups(CharacterVector mgrs_string, bool include_mgrs_ref, int nthreads, bool include_error_code, SEXP converter);
+RcppExport SEXP _mgrs_mgrs_to_ups(SEXP mgrs_stringSEXP, SEXP include_mgrs_refSEXP, SEXP nthreadsSEXP, SEXP include_error_codeSEXP, SEXP converterSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
-    Rcpp::traits::input_parameter< std::vector < std::string > >::type mgrs_string(mgrs_stringSEXP);
+    Rcpp::traits::input_parameter< CharacterVector >::type mgrs_string(mgrs_stringSEXP);
     Rcpp::traits::input_parameter< bool >::type include_mgrs_ref(include_mgrs_refSEXP);
-    rcpp_result_gen = Rcpp::wrap(mgrs_to_ups(mgrs_string, include_mgrs_ref));
+    Rcpp::traits::input_parameter< int >::type nthreads(nthreadsSEXP);
+    Rcpp::traits::input_parameter< bool >::type include_error_code(include_error_codeSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type converter(converterSEXP);
+    rcpp_result_gen = Rcpp::wrap(mgrs_to_ups(mgrs_string, include_mgrs_ref, nthreads, include_error_code, converter));
+    return rcpp_result_gen;
+END_RCPP
+}
+// mgrs_error_summary
+DataFrame mgrs_error_summary(IntegerVector error_code);
+RcppExport SEXP _mgrs_mgrs_error_summary(SEXP error_codeSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< IntegerVector >::type error_code(error_codeSEXP);
+    rcpp_result_gen = Rcpp::wrap(mgrs_error_summary(error_code));
     return rcpp_result_gen;
 END_RCPP
 }
 // ups_to_latlng
-NumericVector ups_to_latlng(std::string hemisphere, double easting, double northing, bool degrees);
-RcppExport SEXP _mgrs_ups_to_latlng(SEXP hemisphereSEXP, SEXP eastingSEXP, SEXP northingSEXP, SEXP degreesSEXP) {
+DataFrame ups_to_latlng(CharacterVector hemisphere, NumericVector easting, NumericVector northing, bool degrees, SEXP converter);
+RcppExport SEXP _mgrs_ups_to_latlng(SEXP hemisphereSEXP, SEXP eastingSEXP, SEXP northingSEXP, SEXP degreesSEXP, SEXP converterSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
-    Rcpp::traits::input_parameter< std::string >::type hemisphere(hemisphereSEXP);
-    Rcpp::traits::input_parameter< double >::type easting(eastingSEXP);
-    Rcpp::traits::input_parameter< double >::type northing(northingSEXP);
+    Rcpp::traits::input_parameter< CharacterVector >::type hemisphere(hemisphereSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type easting(eastingSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type northing(northingSEXP);
     Rcpp::traits::input_parameter< bool >::type degrees(degreesSEXP);
-    rcpp_result_gen = Rcpp::wrap(ups_to_latlng(hemisphere, easting, northing, degrees));
+    Rcpp::traits::input_parameter< SEXP >::type converter(converterSEXP);
+    rcpp_result_gen = Rcpp::wrap(ups_to_latlng(hemisphere, easting, northing, degrees, converter));
     return rcpp_result_gen;
 END_RCPP
 }
 // utm_to_latlng
-NumericVector utm_to_latlng(long zone, std::string hemisphere, double easting, double northing, bool degrees);
-RcppExport SEXP _mgrs_utm_to_latlng(SEXP zoneSEXP, SEXP hemisphereSEXP, SEXP eastingSEXP, SEXP northingSEXP, SEXP degreesSEXP) {
+DataFrame utm_to_latlng(IntegerVector zone, CharacterVector hemisphere, NumericVector easting, NumericVector northing, bool degrees, SEXP converter);
+RcppExport SEXP _mgrs_utm_to_latlng(SEXP zoneSEXP, SEXP hemisphereSEXP, SEXP eastingSEXP, SEXP northingSEXP, SEXP degreesSEXP, SEXP converterSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< IntegerVector >::type zone(zoneSEXP);
+    Rcpp::traits::input_parameter< CharacterVector >::type hemisphere(hemisphereSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type easting(eastingSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type northing(northingSEXP);
+    Rcpp::traits::input_parameter< bool >::type degrees(degreesSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type converter(converterSEXP);
+    rcpp_result_gen = Rcpp::wrap(utm_to_latlng(zone, hemisphere, easting, northing, degrees, converter));
+    return rcpp_result_gen;
+END_RCPP
+}
+// latlng_to_utm
+DataFrame latlng_to_utm(NumericVector latitude, NumericVector longitude, int zone_override, bool degrees, SEXP converter);
+RcppExport SEXP _mgrs_latlng_to_utm(SEXP latitudeSEXP, SEXP longitudeSEXP, SEXP zone_overrideSEXP, SEXP degreesSEXP, SEXP converterSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
-    Rcpp::traits::input_parameter< long >::type zone(zoneSEXP);
-    Rcpp::traits::input_parameter< std::string >::type hemisphere(hemisphereSEXP);
-    Rcpp::traits::input_parameter< double >::type easting(eastingSEXP);
-    Rcpp::traits::input_parameter< double >::type northing(northingSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type latitude(latitudeSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type longitude(longitudeSEXP);
+    Rcpp::traits::input_parameter< int >::type zone_override(zone_overrideSEXP);
     Rcpp::traits::input_parameter< bool >::type degrees(degreesSEXP);
-    rcpp_result_gen = Rcpp::wrap(utm_to_latlng(zone, hemisphere, easting, northing, degrees));
+    Rcpp::traits::input_parameter< SEXP >::type converter(converterSEXP);
+    rcpp_result_gen = Rcpp::wrap(latlng_to_utm(latitude, longitude, zone_override, degrees, converter));
+    return rcpp_result_gen;
+END_RCPP
+}
+// latlng_to_ups
+DataFrame latlng_to_ups(NumericVector latitude, NumericVector longitude, bool degrees, SEXP converter);
+RcppExport SEXP _mgrs_latlng_to_ups(SEXP latitudeSEXP, SEXP longitudeSEXP, SEXP degreesSEXP, SEXP converterSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< NumericVector >::type latitude(latitudeSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type longitude(longitudeSEXP);
+    Rcpp::traits::input_parameter< bool >::type degrees(degreesSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type converter(converterSEXP);
+    rcpp_result_gen = Rcpp::wrap(latlng_to_ups(latitude, longitude, degrees, converter));
+    return rcpp_result_gen;
+END_RCPP
+}
+// mgrs_converter
+SEXP mgrs_converter(std::string ellipsoid, int nthreads, int cache_size, std::string engine);
+RcppExport SEXP _mgrs_mgrs_converter(SEXP ellipsoidSEXP, SEXP nthreadsSEXP, SEXP cache_sizeSEXP, SEXP engineSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< std::string >::type ellipsoid(ellipsoidSEXP);
+    Rcpp::traits::input_parameter< int >::type nthreads(nthreadsSEXP);
+    Rcpp::traits::input_parameter< int >::type cache_size(cache_sizeSEXP);
+    Rcpp::traits::input_parameter< std::string >::type engine(engineSEXP);
+    rcpp_result_gen = Rcpp::wrap(mgrs_converter(ellipsoid, nthreads, cache_size, engine));
     return rcpp_result_gen;
 END_RCPP
 }
 
 static const R_CallMethodDef CallEntries[] = {
-    {"_mgrs_mgrs_to_latlng", (DL_FUNC) &_mgrs_mgrs_to_latlng, 3},
-    {"_mgrs_latlng_to_mgrs", (DL_FUNC) &_mgrs_latlng_to_mgrs, 4},
-    {"_mgrs_utm_to_mgrs", (DL_FUNC) &_mgrs_utm_to_mgrs, 5},
-    {"_mgrs_mgrs_to_utm", (DL_FUNC) &_mgrs_mgrs_to_utm, 2},
-    {"_mgrs_ups_to_mgrs", (DL_FUNC) &_mgrs_ups_to_mgrs, 4},
-    {"_mgrs_mgrs_to_ups", (DL_FUNC) &_mgrs_mgrs_to_ups, 2},
-    {"_mgrs_ups_to_latlng", (DL_FUNC) &_mgrs_ups_to_latlng, 4},
-    {"_mgrs_utm_to_latlng", (DL_FUNC) &_mgrs_utm_to_latlng, 5},
+    {"_mgrs_mgrs_to_latlng", (DL_FUNC) &_mgrs_mgrs_to_latlng, 6},
+    {"_mgrs_latlng_to_mgrs", (DL_FUNC) &_mgrs_latlng_to_mgrs, 6},
+    {"_mgrs_utm_to_mgrs", (DL_FUNC) &_mgrs_utm_to_mgrs, 6},
+    {"_mgrs_mgrs_to_utm", (DL_FUNC) &_mgrs_mgrs_to_utm, 5},
+    {"_mgrs_ups_to_mgrs", (DL_FUNC) &_mgrs_ups_to_mgrs, 5},
+    {"_mgrs_mgrs_to_ups", (DL_FUNC) &_mgrs_mgrs_to_ups, 5},
+    {"_mgrs_mgrs_error_summary", (DL_FUNC) &_mgrs_mgrs_error_summary, 1},
+    {"_mgrs_ups_to_latlng", (DL_FUNC) &_mgrs_ups_to_latlng, 5},
+    {"_mgrs_utm_to_latlng", (DL_FUNC) &_mgrs_utm_to_latlng, 6},
+    {"_mgrs_latlng_to_utm", (DL_FUNC) &_mgrs_latlng_to_utm, 5},
+    {"_mgrs_latlng_to_ups", (DL_FUNC) &_mgrs_latlng_to_ups, 4},
+    {"_mgrs_mgrs_converter", (DL_FUNC) &_mgrs_mgrs_converter, 4},
     {NULL, NULL, 0}
 };
 
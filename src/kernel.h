@@ -0,0 +1,171 @@
+#ifndef KERNEL_H
+  #define KERNEL_H
+
+/***************************************************************************/
+/*
+ * ABSTRACT
+ *
+ *    This private header holds what the batch kernels of the projection
+ *    components share: the attributes that compile them, and branch-free
+ *    forms of sin, cos and atan2 that loops over them can vectorize.  It is
+ *    not installed; each function is static and inlined where it is used.
+ */
+
+
+/***************************************************************************/
+/*
+ *                              INCLUDES
+ */
+
+#include <math.h>
+
+/*
+ *    math.h      - Standard C math library, and __GLIBC__ where it is glibc
+ */
+
+
+/***************************************************************************/
+/*                               DEFINES
+ *
+ */
+
+#define TWO_OVER_PI  6.36619772367581382433e-01  /* 2 over PI                  */
+#define PIO2_1       1.57079632673412561417e+00  /* PI over 2, first 33 bits  */
+#define PIO2_1T      6.07710050650619224932e-11  /* PI over 2 less PIO2_1     */
+#define ROUND_MAGIC  6755399441055744.0  /* 1.5 * 2^52, (x + it) - it rounds x */
+#define PI_HI        3.14159265358979311600e+00  /* PI rounded to double      */
+#define PI_LO        1.22464679914735317720e-16  /* PI less PI_HI             */
+#define PIO2_HI      1.57079632679489655800e+00  /* PI over 2 rounded         */
+#define PIO2_LO      6.12323399573676603587e-17  /* PI over 2 less PIO2_HI    */
+#define PIO4_HI      7.85398163397448278999e-01  /* PI over 4 rounded         */
+#define PIO4_LO      3.06161699786838301793e-17  /* PI over 4 less PIO4_HI    */
+#define TAN_PI_8     4.14213562373095048802e-01  /* tan(PI/8)                 */
+#define TAN_3PI_8    2.41421356237309504880e+00  /* tan(3 PI/8)               */
+
+/*
+ * The batch kernels are compiled once per instruction set (SSE2, AVX2 and
+ * AVX-512) and the best one the processor supports is picked when the
+ * library is loaded.  The pick is made by an ifunc resolver, so this is
+ * only done with GCC on x86-64 glibc; musl and the other C libraries lack
+ * ifuncs.  The kernels also turn on the vectorizer, which R's -O2 leaves
+ * off, and let it if-convert their selects; nothing else about the build
+ * changes.  Multiplies and adds are never fused, so every clone computes
+ * exactly what the scalar code does, whether or not it is vectorized.
+ * Other compilers and platforms get one build of the kernels, left to
+ * their own vectorizer.
+ */
+#if defined(__GNUC__)
+  #define FORCE_INLINE inline __attribute__((always_inline))
+#else
+  #define FORCE_INLINE
+#endif
+
+#if defined(__GNUC__) && !defined(__clang__) && (__GNUC__ >= 6) && \
+    defined(__x86_64__) && defined(__GLIBC__)
+  #define BATCH_KERNEL __attribute__((target_clones("avx512f", "avx2", "default"), \
+                                      optimize("tree-vectorize", "fp-contract=off", "no-trapping-math")))
+#else
+  #define BATCH_KERNEL
+#endif
+
+
+/***************************************************************************/
+/*                              FUNCTIONS
+ *
+ */
+
+static FORCE_INLINE void Sin_Cos (double Angle,
+                                  double *Sin_Angle,
+                                  double *Cos_Angle)
+{ /* BEGIN Sin_Cos */
+  /*
+   * The function Sin_Cos returns the sine and cosine of an angle with the
+   * fdlibm kernel polynomials, after subtracting the nearest multiple of
+   * PI/2.  It has no branches, integer conversions or library calls, so
+   * that loops over it vectorize.  The reduction is exact to double
+   * precision for angles within +/- 10^5 radians.
+   *
+   *    Angle         : Angle in radians                            (input)
+   *    Sin_Angle     : Sine of Angle                               (output)
+   *    Cos_Angle     : Cosine of Angle                             (output)
+   */
+
+  double q = (Angle * TWO_OVER_PI + ROUND_MAGIC) - ROUND_MAGIC; /* multiple of PI/2 */
+  double m = q - 4.e0 * ((q * 0.25e0 + ROUND_MAGIC) - ROUND_MAGIC); /* q mod 4, -2 to 2 */
+  double x = (Angle - q * PIO2_1) - q * PIO2_1T;
+  double z = x * x;
+  double hz;
+  double w;
+  double s;
+  double c;
+  int    odd = (fabs(m) == 1.e0);
+
+  s = x + z * x * (-1.66666666666666324348e-01 + z * (8.33333333332248946124e-03
+      + z * (-1.98412698298579493134e-04 + z * (2.75573137070700676789e-06
+      + z * (-2.50507602534068634195e-08 + z * 1.58969099521155010221e-10)))));
+  hz = 0.5e0 * z;
+  w = 1.e0 - hz;
+  c = w + (((1.e0 - w) - hz) + z * z * (4.16666666666666019037e-02
+      + z * (-1.38888888888741095749e-03 + z * (2.48015872894767294178e-05
+      + z * (-2.75573143513906633035e-07 + z * (2.08757232129817482790e-09
+      + z * -1.13596475577881948265e-11))))));
+  w = odd ? c : s;
+  c = odd ? s : c;
+  *Sin_Angle = ((m < 0.e0) || (m > 1.5e0)) ? -w : w;
+  *Cos_Angle = ((m > 0.5e0) || (m < -1.5e0)) ? -c : c;
+} /* END OF Sin_Cos */
+
+
+static FORCE_INLINE double Atan (double x)
+{ /* BEGIN Atan */
+  /*
+   * The function Atan returns the arc tangent of x >= 0 with the fdlibm
+   * polynomial, after taking x to within tan(PI/8) of zero with
+   * atan(x) = PI/4 + atan((x - 1) / (x + 1)) or PI/2 + atan(-1 / x).  Like
+   * Sin_Cos it has no branches or library calls.
+   *
+   *    x             : Tangent, zero or more                       (input)
+   */
+
+  int    big = (x > TAN_3PI_8);
+  int    mid = (x > TAN_PI_8);
+  double y = big ? -1.e0 / x : (mid ? (x - 1.e0) / (x + 1.e0) : x);
+  double hi = big ? PIO2_HI : (mid ? PIO4_HI : 0.e0);
+  double lo = big ? PIO2_LO : (mid ? PIO4_LO : 0.e0);
+  double z = y * y;
+  double w = z * z;
+  double s1;
+  double s2;
+
+  s1 = z * (3.33333333333329318027e-01 + w * (1.42857142725034663711e-01
+       + w * (9.09088713343650656196e-02 + w * (6.66107313738753120669e-02
+       + w * (4.97687799461593236017e-02 + w * 1.62858201153657823623e-02)))));
+  s2 = w * (-1.99999999998764832476e-01 + w * (-1.11111104054623557880e-01
+       + w * (-7.69187620504482999495e-02 + w * (-5.83357013379057348645e-02
+       + w * -3.65315727442169155270e-02))));
+  return (hi - ((y * (s1 + s2) - lo) - y));
+} /* END OF Atan */
+
+
+static FORCE_INLINE double Atan2 (double y,
+                                  double x)
+{ /* BEGIN Atan2 */
+  /*
+   * The function Atan2 returns atan2(y, x), the angle of the point (x, y),
+   * from Atan of the smaller over the larger of |x| and |y|.  It matches
+   * atan2 for signed zeros; both x and y zero is not handled.
+   *
+   *    y             : Ordinate                                    (input)
+   *    x             : Abscissa                                    (input)
+   */
+
+  double ay = fabs(y);
+  double ax = fabs(x);
+  double angle = Atan((ay > ax) ? ax / ay : ay / ax);
+
+  angle = (ay > ax) ? (PIO2_HI - angle) + PIO2_LO : angle;
+  angle = (x < 0.e0) ? (PI_HI - angle) + PI_LO : angle;
+  return (copysign(angle, y));
+} /* END OF Atan2 */
+
+#endif /* KERNEL_H */
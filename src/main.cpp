@@ -1,4 +1,9 @@
 #include <Rcpp.h>
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <thread>
+#include <vector>
 
 #include "ups.h"
 #include "utm.h"
@@ -6,6 +11,162 @@
 
 using namespace Rcpp;
 
+// length of the result when recycling arguments R-style (0 if any is empty)
+static R_xlen_t recycled_length(std::initializer_list < R_xlen_t > lengths) {
+  R_xlen_t n = 0;
+  for (R_xlen_t len : lengths) {
+    if (len == 0) return(0);
+    n = std::max(n, len);
+  }
+  return(n);
+}
+
+// Ellipsoid state, thread count and chunk size a conversion runs with. The
+// bindings use the WGS 84 default below unless they are handed one made by
+// mgrs_converter(); either way it is only read once set, so any number of
+// calls (and their threads) can share it.
+struct Converter {
+  MGRS_Context ctx;
+  int nthreads;
+  R_xlen_t cache_size;
+};
+
+static const R_xlen_t default_cache_size = 10000;
+
+// Ellipsoids mgrs_converter() accepts, by GEOTRANS two-letter code
+static const struct {
+  const char *code;
+  const char *name;
+  double a;
+  double inv_f;
+} ellipsoids[] = {
+  { "AA", "Airy 1830", 6377563.396, 299.3249646 },
+  { "AM", "Modified Airy", 6377340.189, 299.3249646 },
+  { "AN", "Australian National", 6378160.0, 298.25 },
+  { "BN", "Bessel 1841 (Namibia)", 6377483.865, 299.1528128 },
+  { "BR", "Bessel 1841", 6377397.155, 299.1528128 },
+  { "CC", "Clarke 1866", 6378206.4, 294.9786982 },
+  { "CD", "Clarke 1880", 6378249.145, 293.465 },
+  { "EA", "Everest 1830", 6377276.345, 300.8017 },
+  { "FA", "Modified Fischer 1960", 6378155.0, 298.3 },
+  { "HE", "Helmert 1906", 6378200.0, 298.3 },
+  { "HO", "Hough 1960", 6378270.0, 297.0 },
+  { "ID", "Indonesian 1974", 6378160.0, 298.247 },
+  { "IN", "International 1924", 6378388.0, 297.0 },
+  { "KA", "Krassovsky 1940", 6378245.0, 298.3 },
+  { "RF", "GRS 80", 6378137.0, 298.257222101 },
+  { "SA", "South American 1969", 6378160.0, 298.25 },
+  { "WD", "WGS 72", 6378135.0, 298.26 },
+  { "WE", "WGS 84", 6378137.0, 298.257223563 }
+};
+
+static const Converter *default_converter() {
+  static Converter cv;
+  static bool ready = (
+    cv.nthreads = 1,
+    cv.cache_size = default_cache_size,
+    Set_MGRS_Parameters_Ctx(&cv.ctx, 6378137.0, 1 / 298.257223563, "WE") == MGRS_NO_ERROR
+  );
+  (void)ready;
+  return(&cv);
+}
+
+// The converter a binding was handed, or the default one for NULL
+static const Converter *get_converter(SEXP converter) {
+  if (Rf_isNull(converter)) return(default_converter());
+  if ((TYPEOF(converter) != EXTPTRSXP) || !Rf_inherits(converter, "mgrs_converter")) {
+    Rcpp::stop("`converter` must be NULL or made by mgrs_converter()");
+  }
+  const Converter *cv = (const Converter *)R_ExternalPtrAddr(converter);
+  if (cv == NULL) {
+    Rcpp::stop("`converter` is no longer valid (converters do not survive being saved); create a new one with mgrs_converter()");
+  }
+  return(cv);
+}
+
+static int check_nthreads(int nthreads) {
+  if ((nthreads == NA_INTEGER) || (nthreads < 1)) {
+    Rcpp::stop("`nthreads` must be a positive integer");
+  }
+  return(nthreads);
+}
+
+// `nthreads` as given, or the converter's thread count when it is NA
+static int resolve_nthreads(int nthreads, const Converter *cv) {
+  return((nthreads == NA_INTEGER) ? cv->nthreads : check_nthreads(nthreads));
+}
+
+// Run body(ctx, begin, end) over [0, n) in chunks of cv->cache_size rows
+// spread over nthreads threads (the calling thread included). The threads
+// share the converter's context, which is only read, so a call does not
+// copy its tables. Rows never depend on which thread converts them, so
+// results are identical for any thread count. body must not touch the R
+// API: only the calling thread checks for user interrupts, and if one
+// arrives the workers stop after their current chunk before it is rethrown.
+// An exception thrown by body on a worker (std::bad_alloc, say) likewise
+// stops the other threads and is rethrown on the calling thread, where
+// Rcpp turns it into an R error.
+template < typename Body >
+static void convert_chunks(const Converter *cv, R_xlen_t n, int nthreads, Body body) {
+
+  const R_xlen_t chunk = cv->cache_size;
+  const R_xlen_t n_chunks = (n + chunk - 1) / chunk;
+  const int n_threads = (int)std::max < R_xlen_t > (1, std::min < R_xlen_t > (nthreads, n_chunks));
+
+  const MGRS_Context *ctx = &cv->ctx;
+  std::atomic < R_xlen_t > next_chunk(0);
+  std::atomic < bool > stop_workers(false);
+
+  auto run_chunk = [&](R_xlen_t c) {
+    body(ctx, c * chunk, std::min(n, (c + 1) * chunk));
+  };
+
+  std::vector < std::thread > workers;
+  std::vector < std::exception_ptr > worker_errors(n_threads);
+  workers.reserve(n_threads);
+
+  try {
+    for (int t=1; t<n_threads; t++) {
+      workers.emplace_back([&, t]() {
+        try {
+          R_xlen_t c;
+          while (!stop_workers && ((c = next_chunk++) < n_chunks)) run_chunk(c);
+        } catch (...) {
+          worker_errors[t] = std::current_exception();
+          stop_workers = true;
+        }
+      });
+    }
+    R_xlen_t c;
+    while (!stop_workers && ((c = next_chunk++) < n_chunks)) {
+      Rcpp::checkUserInterrupt();
+      run_chunk(c);
+    }
+  } catch (...) {
+    stop_workers = true;
+    for (auto &w : workers) w.join();
+    throw;
+  }
+
+  for (auto &w : workers) w.join();
+  for (auto &e : worker_errors) {
+    if (e) std::rethrow_exception(e);
+  }
+
+}
+
+// The C strings of a character vector, read in place. STRING_PTR_RO() (which
+// may have to materialize an ALTREP vector) and CHAR() are R API calls, so
+// the pointers are all resolved here on the calling thread and worker
+// threads only read memory. NA strings read as "NA", which never parses.
+static std::vector < const char * > string_ptrs(const CharacterVector &x) {
+  const R_xlen_t n = x.size();
+  const SEXP *elts = STRING_PTR_RO(x);
+  std::vector < const char * > ptrs(n);
+  for (R_xlen_t i=0; i<n; i++) ptrs[i] = CHAR(elts[i]);
+  return(ptrs);
+}
+
 //' Convert an MGRS string to latitude/longitude
 //'
 //' @md
@@ -14,35 +175,57 @@ using namespace Rcpp;
 //' @param degrees convert to degrees? Default: `TRUE`
 //' @param include_mgrs_ref if `TRUE` the data frame returned fill include
 //'        the MGRS reference in a column named `mgrs`. Default: `TRUE`.
+//' @param nthreads number of threads to convert with. Results do not depend
+//'        on it. Default: `NA`, the thread count of `converter` (`1`
+//'        without one)
+//' @param include_error_code if `TRUE` the data frame returned will include
+//'        the raw `MGRS_*_ERROR` bitmask of each row in an integer column
+//'        named `error_code` (`0` for rows that converted). See
+//'        [mgrs_error_summary()]. Default: `FALSE`.
+//' @param converter an [mgrs_converter()] to convert with, for another
+//'        ellipsoid or to reuse one set of precomputed tables across calls.
+//'        Default: `NULL` (WGS 84)
 //' @export
 //' @return `data.frame`
 //' @examples
 //' mgrs_to_latlng("15TWG0000049776")
 // [[Rcpp::export]]
-DataFrame mgrs_to_latlng(std::vector < std::string > MGRS, bool degrees = true,
-                         bool include_mgrs_ref = true) {
+DataFrame mgrs_to_latlng(CharacterVector MGRS, bool degrees = true,
+                         bool include_mgrs_ref = true, int nthreads = NA_INTEGER,
+                         bool include_error_code = false, SEXP converter = R_NilValue) {
 
-  double lat, lng;
-  long ret, err_ct = 0;
-  NumericVector lat_vec(MGRS.size());
-  NumericVector lng_vec(MGRS.size());
-
-  for (unsigned int i=0; i<MGRS.size(); i++) {
-
-    if ((i % 10000) == 0) Rcpp::checkUserInterrupt();
+  const Converter *cv = get_converter(converter);
 
-    ret = Convert_MGRS_To_Geodetic((char *)MGRS[i].c_str(), &lat, &lng);
+  R_xlen_t n = MGRS.size();
+  const std::vector < const char * > mgrs_in = string_ptrs(MGRS);
+  NumericVector lat_vec(n);
+  NumericVector lng_vec(n);
+  double *lat_out = lat_vec.begin();
+  double *lng_out = lng_vec.begin();
+  IntegerVector code_vec(include_error_code ? n : 0);
+  int *code_out = include_error_code ? code_vec.begin() : NULL;
+  std::atomic < long > errors(0);
 
-    if (ret != UTM_NO_ERROR) {
-      err_ct += 1;
-      lat_vec[i] = NA_REAL;
-      lng_vec[i] = NA_REAL;
-    } else {
-      lat_vec[i] = degrees ? lat * 180.0/PI : lat;
-      lng_vec[i] = degrees ? lng * 180.0/PI : lng;
+  convert_chunks(cv, n, resolve_nthreads(nthreads, cv),
+    [&](const MGRS_Context *ctx, R_xlen_t begin, R_xlen_t end) {
+      std::vector < long > codes(end - begin);
+      errors += Convert_MGRS_To_Geodetic_Batch_Ctx(ctx, mgrs_in.data() + begin, end - begin,
+                                                   lat_out + begin, lng_out + begin,
+                                                   codes.data());
+      for (R_xlen_t i=begin; i<end; i++) {
+        if (code_out) code_out[i] = (int)codes[i - begin];
+        if (codes[i - begin] != MGRS_NO_ERROR) {
+          lat_out[i] = NA_REAL;
+          lng_out[i] = NA_REAL;
+        } else if (degrees) {
+          lat_out[i] = lat_out[i] * 180.0/PI;
+          lng_out[i] = lng_out[i] * 180.0/PI;
+        }
+      }
     }
+  );
 
-  }
+  long err_ct = errors;
 
   if (err_ct > 0) {
     Rcpp::warning(
@@ -51,87 +234,202 @@ DataFrame mgrs_to_latlng(std::vector < std::string > MGRS, bool degrees = true,
     );
   }
 
+  DataFrame out;
+
   if (include_mgrs_ref) {
-    return(
-      DataFrame::create(
-        _["mgrs"] = MGRS,
-        _["lat"] = lat_vec,
-        _["lng"] = lng_vec,
-        _["stringsAsFactors"] = false
-      )
+    out = DataFrame::create(
+      _["mgrs"] = MGRS,
+      _["lat"] = lat_vec,
+      _["lng"] = lng_vec,
+      _["stringsAsFactors"] = false
     );
   } else {
-    return(
-      DataFrame::create(
-        _["lat"] = lat_vec,
-        _["lng"] = lng_vec,
-        _["stringsAsFactors"] = false
-      )
+    out = DataFrame::create(
+      _["lat"] = lat_vec,
+      _["lng"] = lng_vec,
+      _["stringsAsFactors"] = false
     );
   }
 
+  if (include_error_code) out.push_back(code_vec, "error_code");
+
+  return(out);
+
 }
 
 //' Convert latitude/longitude to MGRS string
 //'
 //' @md
-//' @param latitude,longitude coordinates
+//' @note vectorized
+//' @param latitude,longitude numeric vectors of coordinates (same length)
 //' @param degrees are latitude/longitude in degrees? Default: `TRUE`
-//' @param precision 0:5; level of precision for the conversion. Default `5`
+//' @param precision 0:5; level of precision for the conversion. Either one
+//'        value for all coordinates or one per coordinate (recycled). Default `5`
+//' @param converter an [mgrs_converter()] to convert with, for another
+//'        ellipsoid or to reuse one set of precomputed tables across calls.
+//'        Default: `NULL` (WGS 84)
+//' @param accuracy `"exact"` or `"fast"`. With `"fast"`, coordinates at
+//'        precisions up to `3` (100 m) are projected mostly in single
+//'        precision, and those that land within a meter of a grid line are
+//'        projected again in double precision, so the strings are always
+//'        the same as with `"exact"`. Default: `"exact"`
+//' @return character vector of MGRS strings. Coordinates that cannot be
+//'         converted are turned into `NA` (with one warning for all of them).
 //' @export
 //' @examples
 //' latlng_to_mgrs(42, -93)
+//' latlng_to_mgrs(c(42, 48.20535), c(-93, 16.34593), precision = c(5, 2))
+//' latlng_to_mgrs(42, -93, precision = 2, accuracy = "fast")
 // [[Rcpp::export]]
-String latlng_to_mgrs(double latitude, double longitude,
-                      bool degrees = true, int precision = 5) {
+CharacterVector latlng_to_mgrs(NumericVector latitude, NumericVector longitude,
+                               bool degrees = true,
+                               IntegerVector precision = IntegerVector::create(5),
+                               SEXP converter = R_NilValue,
+                               std::string accuracy = "exact") {
+
+  const Converter *cv = get_converter(converter);
+
+  if ((accuracy != "exact") && (accuracy != "fast")) {
+    Rcpp::stop("`accuracy` must be one of exact, fast");
+  }
+  const bool fast = (accuracy == "fast");
+
+  R_xlen_t n = latitude.size();
+
+  if (longitude.size() != n) {
+    Rcpp::stop("`latitude` and `longitude` must be the same length");
+  }
+
+  if ((precision.size() == 0) && (n > 0)) {
+    Rcpp::stop("`precision` must have at least one value");
+  }
+
+  const double *lat = latitude.begin();
+  const double *lng = longitude.begin();
+  std::vector < double > lat_rad, lng_rad;
 
   if (degrees) {
-    latitude *= PI / 180.0;
-    longitude *= PI / 180.0;
+    lat_rad.resize(n);
+    lng_rad.resize(n);
+    for (R_xlen_t i=0; i<n; i++) {
+      lat_rad[i] = latitude[i] * PI / 180.0;
+      lng_rad[i] = longitude[i] * PI / 180.0;
+    }
+    lat = lat_rad.data();
+    lng = lng_rad.data();
   }
 
-  char buf[80];
-  int ret;
+  // one precision for all rows, or one per row after recycling
+  std::vector < long > prec(precision.size() == 1 ? 1 : n);
+  for (R_xlen_t i=0; i<(R_xlen_t)prec.size(); i++) {
+    prec[i] = precision[i % precision.size()];
+  }
 
-  ret = Convert_Geodetic_To_MGRS(latitude, longitude, precision, buf);
+  const R_xlen_t chunk = std::min(cv->cache_size, n);
+  std::vector < char > buf(chunk * MGRS_STRING_LENGTH);
+  CharacterVector out(n);
+  long err_ct = 0;
+
+  for (R_xlen_t start=0; start<n; start+=chunk) {
+
+    Rcpp::checkUserInterrupt();
+
+    R_xlen_t len = std::min(chunk, n - start);
+
+    err_ct += (fast ? Convert_Geodetic_To_MGRS_Fast_Batch_Ctx : Convert_Geodetic_To_MGRS_Batch_Ctx)(
+      &cv->ctx, lat + start, lng + start, len,
+      (prec.size() == 1) ? prec.data() : prec.data() + start,
+      (prec.size() == 1) ? 1 : len,
+      buf.data(), NULL
+    );
+
+    for (R_xlen_t i=0; i<len; i++) {
+      const char *row = buf.data() + i * MGRS_STRING_LENGTH;
+      if (row[0] == '\0') {
+        out[start + i] = NA_STRING;
+      } else {
+        out[start + i] = Rf_mkChar(row);
+      }
+    }
 
-  if (ret != MGRS_NO_ERROR) {
-    Rcpp::warning("Error converting latitude/longitude to MGRS");
-    return(NA_STRING);
-  } else {
-    return(std::string(buf));
   }
 
+  if (err_ct > 0) {
+    Rcpp::warning(
+      "%d error%s encountered while converting %d latitude/longitude pairs.\nErrant pairs will be turned into `NA` MGRS strings.",
+      err_ct, (err_ct > 1 ? "s" : ""), n
+    );
+  }
+
+  return(out);
+
 }
 
 //' Convert UTM to MGRS
 //'
 //' @md
+//' @note vectorized; arguments are recycled to the length of the longest one
 //' @param zone 1:60
 //' @param hemisphere South (`S`) or North (`N`)
 //' @param easting,northing easting (X) / northing (Y) (meters)
 //' @param precision 0:5; level of precision for the conversion. Default `5`
+//' @param converter an [mgrs_converter()] to convert with, for another
+//'        ellipsoid or to reuse one set of precomputed tables across calls.
+//'        Default: `NULL` (WGS 84)
+//' @return character vector of MGRS strings. Coordinates that cannot be
+//'         converted are turned into `NA` (with one warning for all of them).
 //' @export
 //' @examples
 //' utm_to_mgrs(48, "N", 377299, 1483035)
+//' utm_to_mgrs(48, "N", c(377299, 377399), c(1483035, 1483135), precision = 3)
 // [[Rcpp::export]]
-String utm_to_mgrs(long zone, std::string hemisphere,
-                   double easting, double northing,
-                   long precision = 5) {
+CharacterVector utm_to_mgrs(IntegerVector zone, CharacterVector hemisphere,
+                            NumericVector easting, NumericVector northing,
+                            IntegerVector precision = IntegerVector::create(5),
+                            SEXP converter = R_NilValue) {
 
-  char buf[80];
-  long ret;
+  const Converter *cv = get_converter(converter);
 
-  ret = Convert_UTM_To_MGRS(zone, hemisphere.c_str()[0], easting, northing,
-                            precision, (char *)&buf);
+  R_xlen_t n = recycled_length({ zone.size(), hemisphere.size(), easting.size(),
+                                 northing.size(), precision.size() });
+  CharacterVector out(n);
+  char buf[MGRS_STRING_LENGTH];
+  long ret, err_ct = 0;
+
+  for (R_xlen_t i=0; i<n; i++) {
+
+    if ((i % 10000) == 0) Rcpp::checkUserInterrupt();
+
+    int z = zone[i % zone.size()];
+    SEXP h = STRING_ELT(hemisphere, i % hemisphere.size());
+    double e = easting[i % easting.size()];
+    double nn = northing[i % northing.size()];
+    int p = precision[i % precision.size()];
+
+    if ((z == NA_INTEGER) || (h == NA_STRING) || ISNAN(e) || ISNAN(nn)) {
+      ret = MGRS_STRING_ERROR;
+    } else {
+      ret = Convert_UTM_To_MGRS_Ctx(&cv->ctx, z, CHAR(h)[0], e, nn, p, buf);
+    }
+
+    if (ret != MGRS_NO_ERROR) {
+      err_ct += 1;
+      out[i] = NA_STRING;
+    } else {
+      out[i] = Rf_mkChar(buf);
+    }
 
-  if (ret != UTM_NO_ERROR) {
-    Rcpp::warning("Error converting UTM to MGRS");
-    return(NA_STRING);
-  } else {
-    return(std::string(buf));
   }
 
+  if (err_ct > 0) {
+    Rcpp::warning(
+      "%d error%s encountered while converting %d UTM coordinates.\nErrant coordinates will be turned into `NA` MGRS strings.",
+      err_ct, (err_ct > 1 ? "s" : ""), n
+    );
+  }
+
+  return(out);
+
 }
 
 //' Convert MGRS to UTM
@@ -141,94 +439,169 @@ String utm_to_mgrs(long zone, std::string hemisphere,
 //' @param mgrs_string acharacter vector of MGRS strings
 //' @param include_mgrs_ref if `TRUE` the data frame returned fill include
 //'        the MGRS reference in a column named `mgrs`. Default: `TRUE`.
+//' @param nthreads number of threads to convert with. Results do not depend
+//'        on it. Default: `NA`, the thread count of `converter` (`1`
+//'        without one)
+//' @param include_error_code if `TRUE` the data frame returned will include
+//'        the raw `MGRS_*_ERROR` bitmask of each row in an integer column
+//'        named `error_code` (`0` for rows that converted). See
+//'        [mgrs_error_summary()]. Default: `FALSE`.
+//' @param converter an [mgrs_converter()] to convert with, for another
+//'        ellipsoid or to reuse one set of precomputed tables across calls.
+//'        Default: `NULL` (WGS 84)
 //' @return `data.frame`
 //' @export
 //' @examples
 //' mgrs_to_utm("48PUV7729883034")
 // [[Rcpp::export]]
-DataFrame mgrs_to_utm(std::vector < std::string > mgrs_string, bool include_mgrs_ref = true) {
+DataFrame mgrs_to_utm(CharacterVector mgrs_string, bool include_mgrs_ref = true,
+                      int nthreads = NA_INTEGER, bool include_error_code = false,
+                      SEXP converter = R_NilValue) {
 
-  long zone;
-  char h_buf[80];
-  double easting, northing;
-  long ret;
-  IntegerVector zonev = IntegerVector(mgrs_string.size());
-  StringVector hemispherev = StringVector(mgrs_string.size());
-  NumericVector eastingv = NumericVector(mgrs_string.size());
-  NumericVector northingv = NumericVector(mgrs_string.size());
-
-  for (unsigned int i=0; i<mgrs_string.size(); i++) {
+  const Converter *cv = get_converter(converter);
 
-    ret = Convert_MGRS_To_UTM((char *)mgrs_string[i].c_str(), &zone, h_buf, &easting, &northing);
+  R_xlen_t n = mgrs_string.size();
+  const std::vector < const char * > mgrs_in = string_ptrs(mgrs_string);
+  IntegerVector zonev = IntegerVector(n);
+  StringVector hemispherev = StringVector(n);
+  NumericVector eastingv = NumericVector(n);
+  NumericVector northingv = NumericVector(n);
+  int *zone_out = zonev.begin();
+  double *easting_out = eastingv.begin();
+  double *northing_out = northingv.begin();
+  std::vector < char > hemisphere_out(n);  // 0 marks a failed row
+  IntegerVector code_vec(include_error_code ? n : 0);
+  int *code_out = include_error_code ? code_vec.begin() : NULL;
+  std::atomic < long > errors(0);
 
-    if (ret != MGRS_NO_ERROR) {
-      Rcpp::warning("Error converting MGRS to UTM");
-      zonev[i] = NA_INTEGER;
-      hemispherev[i] = NA_STRING;
-      eastingv[i] = NA_REAL;
-      northingv[i] = NA_REAL;
-    } else {
-      h_buf[1] = '\0';
-      zonev[i] = zone;
-      hemispherev[i] = std::string(h_buf);
-      eastingv[i] = easting;
-      northingv[i] = northing;
+  convert_chunks(cv, n, resolve_nthreads(nthreads, cv),
+    [&](const MGRS_Context *ctx, R_xlen_t begin, R_xlen_t end) {
+      long zone, ret, chunk_errors = 0;
+      char hemisphere;
+      double easting, northing;
+      for (R_xlen_t i=begin; i<end; i++) {
+        ret = Convert_MGRS_To_UTM_Ctx(ctx, mgrs_in[i], &zone, &hemisphere, &easting, &northing);
+        if (code_out) code_out[i] = (int)ret;
+        if (ret != MGRS_NO_ERROR) {
+          chunk_errors += 1;
+          zone_out[i] = NA_INTEGER;
+          hemisphere_out[i] = 0;
+          easting_out[i] = NA_REAL;
+          northing_out[i] = NA_REAL;
+        } else {
+          zone_out[i] = zone;
+          hemisphere_out[i] = hemisphere;
+          easting_out[i] = easting;
+          northing_out[i] = northing;
+        }
+      }
+      errors += chunk_errors;
     }
+  );
 
+  for (R_xlen_t i=0; i<n; i++) {
+    hemispherev[i] = hemisphere_out[i] ? Rf_mkCharLen(&hemisphere_out[i], 1) : NA_STRING;
   }
 
+  long err_ct = errors;
+
+  if (err_ct > 0) {
+    Rcpp::warning(
+      "%d error%s encountered while converting %d MGRS input strings to UTM.\nErrant MGRS strings will be turned into `NA` rows.",
+      err_ct, (err_ct > 1 ? "s" : ""), n
+    );
+  }
+
+  DataFrame out;
+
   if (include_mgrs_ref) {
-    return(
-      DataFrame::create(
-        _["mgrs"] = mgrs_string,
-        _["zone"] = zonev,
-        _["hemisphere"] = hemispherev,
-        _["easting"] = eastingv,
-        _["northing"] = northingv,
-        _["stringsAsFactors"] = false
-      )
+    out = DataFrame::create(
+      _["mgrs"] = mgrs_string,
+      _["zone"] = zonev,
+      _["hemisphere"] = hemispherev,
+      _["easting"] = eastingv,
+      _["northing"] = northingv,
+      _["stringsAsFactors"] = false
     );
   } else {
-    return(
-      DataFrame::create(
-        _["zone"] = zonev,
-        _["hemisphere"] = hemispherev,
-        _["easting"] = eastingv,
-        _["northing"] = northingv,
-        _["stringsAsFactors"] = false
-      )
+    out = DataFrame::create(
+      _["zone"] = zonev,
+      _["hemisphere"] = hemispherev,
+      _["easting"] = eastingv,
+      _["northing"] = northingv,
+      _["stringsAsFactors"] = false
     );
   }
 
+  if (include_error_code) out.push_back(code_vec, "error_code");
+
+  return(out);
+
 }
 
 //' Convert UPS to MGRS
 //'
 //' @md
+//' @note vectorized; arguments are recycled to the length of the longest one
 //' @param hemisphere South (`S`) or North (`N`)
 //' @param easting,northing easting (X) / northing (Y) (meters)
 //' @param precision 0:5; level of precision for the conversion. Default `5`
+//' @param converter an [mgrs_converter()] to convert with, for another
+//'        ellipsoid or to reuse one set of precomputed tables across calls.
+//'        Default: `NULL` (WGS 84)
+//' @return character vector of MGRS strings. Coordinates that cannot be
+//'         converted are turned into `NA` (with one warning for all of them).
 //' @export
 //' @examples
 //' ups_to_mgrs("N", 2426773, 1530125)
+//' ups_to_mgrs(c("N", "S"), 2426773, 1530125)
 // [[Rcpp::export]]
-String ups_to_mgrs(std::string hemisphere,
-                   double easting, double northing,
-                   long precision = 5) {
+CharacterVector ups_to_mgrs(CharacterVector hemisphere,
+                            NumericVector easting, NumericVector northing,
+                            IntegerVector precision = IntegerVector::create(5),
+                            SEXP converter = R_NilValue) {
 
-  char buf[80];
-  long ret;
+  const Converter *cv = get_converter(converter);
 
-  ret = Convert_UPS_To_MGRS(hemisphere.c_str()[0], easting, northing,
-                            precision, (char *)&buf);
+  R_xlen_t n = recycled_length({ hemisphere.size(), easting.size(),
+                                 northing.size(), precision.size() });
+  CharacterVector out(n);
+  char buf[MGRS_STRING_LENGTH];
+  long ret, err_ct = 0;
 
-  if (ret != UPS_NO_ERROR) {
-    Rcpp::warning("Error converting UPS to MGRS");
-    return(NA_STRING);
-  } else {
-    return(std::string(buf));
+  for (R_xlen_t i=0; i<n; i++) {
+
+    if ((i % 10000) == 0) Rcpp::checkUserInterrupt();
+
+    SEXP h = STRING_ELT(hemisphere, i % hemisphere.size());
+    double e = easting[i % easting.size()];
+    double nn = northing[i % northing.size()];
+    int p = precision[i % precision.size()];
+
+    if ((h == NA_STRING) || ISNAN(e) || ISNAN(nn)) {
+      ret = MGRS_STRING_ERROR;
+    } else {
+      ret = Convert_UPS_To_MGRS_Ctx(&cv->ctx, CHAR(h)[0], e, nn, p, buf);
+    }
+
+    if (ret != MGRS_NO_ERROR) {
+      err_ct += 1;
+      out[i] = NA_STRING;
+    } else {
+      out[i] = Rf_mkChar(buf);
+    }
+
+  }
+
+  if (err_ct > 0) {
+    Rcpp::warning(
+      "%d error%s encountered while converting %d UPS coordinates.\nErrant coordinates will be turned into `NA` MGRS strings.",
+      err_ct, (err_ct > 1 ? "s" : ""), n
+    );
   }
 
+  return(out);
+
 }
 
 //' Convert MGRS to UPS
@@ -238,134 +611,617 @@ String ups_to_mgrs(std::string hemisphere,
 //' @param mgrs_string a character vector of MGRS strings
 //' @param include_mgrs_ref if `TRUE` the data frame returned fill include
 //'        the MGRS reference in a column named `mgrs`. Default: `TRUE`.
+//' @param nthreads number of threads to convert with. Results do not depend
+//'        on it. Default: `NA`, the thread count of `converter` (`1`
+//'        without one)
+//' @param include_error_code if `TRUE` the data frame returned will include
+//'        the raw `MGRS_*_ERROR` bitmask of each row in an integer column
+//'        named `error_code` (`0` for rows that converted). See
+//'        [mgrs_error_summary()]. Default: `FALSE`.
+//' @param converter an [mgrs_converter()] to convert with, for another
+//'        ellipsoid or to reuse one set of precomputed tables across calls.
+//'        Default: `NULL` (WGS 84)
 //' @return `data.frame`
 //' @export
 //' @examples
 //' mgrs_to_ups("ZGC2677330125")
 // [[Rcpp::export]]
-DataFrame mgrs_to_ups(std::vector < std::string > mgrs_string, bool include_mgrs_ref = true) {
+DataFrame mgrs_to_ups(CharacterVector mgrs_string, bool include_mgrs_ref = true,
+                      int nthreads = NA_INTEGER, bool include_error_code = false,
+                      SEXP converter = R_NilValue) {
 
-  char h_buf[80];
-  double easting, northing;
-  long ret;
-  StringVector hemispherev = StringVector(mgrs_string.size());
-  NumericVector eastingv = NumericVector(mgrs_string.size());
-  NumericVector northingv = NumericVector(mgrs_string.size());
+  const Converter *cv = get_converter(converter);
 
-  for (unsigned int i=0; i<mgrs_string.size(); i++) {
+  R_xlen_t n = mgrs_string.size();
+  const std::vector < const char * > mgrs_in = string_ptrs(mgrs_string);
+  StringVector hemispherev = StringVector(n);
+  NumericVector eastingv = NumericVector(n);
+  NumericVector northingv = NumericVector(n);
+  double *easting_out = eastingv.begin();
+  double *northing_out = northingv.begin();
+  std::vector < char > hemisphere_out(n);  // 0 marks a failed row
+  IntegerVector code_vec(include_error_code ? n : 0);
+  int *code_out = include_error_code ? code_vec.begin() : NULL;
+  std::atomic < long > errors(0);
 
-    ret = Convert_MGRS_To_UPS((char *)mgrs_string[i].c_str(), h_buf, &easting, &northing);
-
-    if (ret != MGRS_NO_ERROR) {
-      Rcpp::warning("Error converting MGRS to UTM");
-      hemispherev[i] = NA_STRING;
-      eastingv[i] = NA_REAL;
-      northingv[i] = NA_REAL;
-    } else {
-      h_buf[1] = '\0';
-      hemispherev[i] = std::string(h_buf);
-      eastingv[i] = easting;
-      northingv[i] = northing;
+  convert_chunks(cv, n, resolve_nthreads(nthreads, cv),
+    [&](const MGRS_Context *ctx, R_xlen_t begin, R_xlen_t end) {
+      long ret, chunk_errors = 0;
+      char hemisphere;
+      double easting, northing;
+      for (R_xlen_t i=begin; i<end; i++) {
+        ret = Convert_MGRS_To_UPS_Ctx(ctx, mgrs_in[i], &hemisphere, &easting, &northing);
+        if (code_out) code_out[i] = (int)ret;
+        if (ret != MGRS_NO_ERROR) {
+          chunk_errors += 1;
+          hemisphere_out[i] = 0;
+          easting_out[i] = NA_REAL;
+          northing_out[i] = NA_REAL;
+        } else {
+          hemisphere_out[i] = hemisphere;
+          easting_out[i] = easting;
+          northing_out[i] = northing;
+        }
+      }
+      errors += chunk_errors;
     }
+  );
 
+  for (R_xlen_t i=0; i<n; i++) {
+    hemispherev[i] = hemisphere_out[i] ? Rf_mkCharLen(&hemisphere_out[i], 1) : NA_STRING;
   }
 
+  long err_ct = errors;
+
+  if (err_ct > 0) {
+    Rcpp::warning(
+      "%d error%s encountered while converting %d MGRS input strings to UPS.\nErrant MGRS strings will be turned into `NA` rows.",
+      err_ct, (err_ct > 1 ? "s" : ""), n
+    );
+  }
+
+  DataFrame out;
+
   if (include_mgrs_ref) {
-    return(
-      DataFrame::create(
-        _["mgrs"] = mgrs_string,
-        _["hemisphere"] = hemispherev,
-        _["easting"] = eastingv,
-        _["northing"] = northingv,
-        _["stringsAsFactors"] = false
-      )
+    out = DataFrame::create(
+      _["mgrs"] = mgrs_string,
+      _["hemisphere"] = hemispherev,
+      _["easting"] = eastingv,
+      _["northing"] = northingv,
+      _["stringsAsFactors"] = false
     );
   } else {
-    return(
-      DataFrame::create(
-        _["hemisphere"] = hemispherev,
-        _["easting"] = eastingv,
-        _["northing"] = northingv,
-        _["stringsAsFactors"] = false
-      )
+    out = DataFrame::create(
+      _["hemisphere"] = hemispherev,
+      _["easting"] = eastingv,
+      _["northing"] = northingv,
+      _["stringsAsFactors"] = false
     );
   }
 
+  if (include_error_code) out.push_back(code_vec, "error_code");
+
+  return(out);
+
+}
+
+// MGRS_*_ERROR bits reported by mgrs_error_summary(), in bit order
+static const struct {
+  const char *name;
+  int bit;
+} mgrs_error_bits[] = {
+  { "MGRS_LAT_ERROR", MGRS_LAT_ERROR },
+  { "MGRS_LON_ERROR", MGRS_LON_ERROR },
+  { "MGRS_STRING_ERROR", MGRS_STRING_ERROR },
+  { "MGRS_PRECISION_ERROR", MGRS_PRECISION_ERROR },
+  { "MGRS_A_ERROR", MGRS_A_ERROR },
+  { "MGRS_INV_F_ERROR", MGRS_INV_F_ERROR },
+  { "MGRS_EASTING_ERROR", MGRS_EASTING_ERROR },
+  { "MGRS_NORTHING_ERROR", MGRS_NORTHING_ERROR },
+  { "MGRS_ZONE_ERROR", MGRS_ZONE_ERROR },
+  { "MGRS_HEMISPHERE_ERROR", MGRS_HEMISPHERE_ERROR },
+  { "MGRS_LAT_WARNING", MGRS_LAT_WARNING }
+};
+
+//' Count rows per MGRS error bit
+//'
+//' @md
+//' @param error_code integer vector of `MGRS_*_ERROR` bitmasks, e.g. the
+//'        `error_code` column returned by [mgrs_to_latlng()], [mgrs_to_utm()]
+//'        or [mgrs_to_ups()] with `include_error_code = TRUE`
+//' @return `data.frame` with one row per error bit: its name (`error`), its
+//'         value (`bit`) and the number of rows that have it set (`rows`).
+//'         Rows with several bits set are counted once for each of them;
+//'         `NA` codes are skipped.
+//' @export
+//' @examples
+//' x <- suppressWarnings(
+//'   mgrs_to_utm(c("48PUV7729883034", "48PUV77298830", "48PIV7729883034"),
+//'               include_error_code = TRUE)
+//' )
+//' mgrs_error_summary(x$error_code)
+// [[Rcpp::export]]
+DataFrame mgrs_error_summary(IntegerVector error_code) {
+
+  const int n_bits = sizeof(mgrs_error_bits) / sizeof(mgrs_error_bits[0]);
+  std::vector < R_xlen_t > counts(n_bits);
+  CharacterVector errorv(n_bits);
+  IntegerVector bitv(n_bits);
+  NumericVector rowsv(n_bits);
+
+  for (R_xlen_t i=0; i<error_code.size(); i++) {
+    int code = error_code[i];
+    if ((code == NA_INTEGER) || (code == MGRS_NO_ERROR)) continue;
+    for (int b=0; b<n_bits; b++) {
+      if (code & mgrs_error_bits[b].bit) counts[b] += 1;
+    }
+  }
+
+  for (int b=0; b<n_bits; b++) {
+    errorv[b] = mgrs_error_bits[b].name;
+    bitv[b] = mgrs_error_bits[b].bit;
+    rowsv[b] = (double)counts[b];
+  }
+
+  return(
+    DataFrame::create(
+      _["error"] = errorv,
+      _["bit"] = bitv,
+      _["rows"] = rowsv,
+      _["stringsAsFactors"] = false
+    )
+  );
+
 }
 
 //' Convert UPS to Latitude/Longitude
 //'
 //' @md
+//' @note vectorized; arguments are recycled to the length of the longest one
 //' @param hemisphere South (`S`) or North (`N`)
 //' @param easting,northing easting (X) / northing (Y) (meters)
 //' @param degrees convert to degrees? Default: `TRUE`
+//' @param converter an [mgrs_converter()] to convert with, for another
+//'        ellipsoid or to reuse one set of precomputed tables across calls.
+//'        Default: `NULL` (WGS 84)
+//' @return `data.frame` with `lat` and `lng` columns. Coordinates that cannot
+//'         be converted are turned into `NA` pairs (with one warning for all of them).
 //' @export
 //' @examples
 //' ups_to_latlng("N", 2426773, 1530125)
+//' ups_to_latlng(c("N", "S"), 2426773, 1530125)
 // [[Rcpp::export]]
-NumericVector ups_to_latlng(std::string hemisphere,
-                            double easting, double northing,
-                            bool degrees = true) {
+DataFrame ups_to_latlng(CharacterVector hemisphere,
+                        NumericVector easting, NumericVector northing,
+                        bool degrees = true, SEXP converter = R_NilValue) {
 
-  double lat, lng;
-  long ret;
+  const Converter *cv = get_converter(converter);
 
-  ret = Convert_UPS_To_Geodetic(hemisphere.c_str()[0], easting, northing, &lat, &lng);
+  R_xlen_t n = recycled_length({ hemisphere.size(), easting.size(), northing.size() });
+  NumericVector lat_vec(n);
+  NumericVector lng_vec(n);
+  double *lat_out = lat_vec.begin();
+  double *lng_out = lng_vec.begin();
+  const R_xlen_t chunk = std::min(cv->cache_size, n);
+  std::vector < char > hemispheres(chunk);
+  std::vector < double > eastings(chunk);
+  std::vector < double > northings(chunk);
+  std::vector < long > codes(chunk);
+  long err_ct = 0;
 
-  NumericVector coords;
+  // the rows of a chunk are unprojected hemisphere by hemisphere by the
+  // batch Polar Stereographic kernel
+  for (R_xlen_t begin=0; begin<n; begin+=chunk) {
 
-  if (ret != UPS_NO_ERROR) {
-    Rcpp::warning("Error converting UPS to latitude/longitude");
-    coords = NumericVector::create(
-      _["lat"] = NA_REAL,
-      _["lng"] = NA_REAL
-    );
-  } else {
-    coords = NumericVector::create(
-      _["lat"] = degrees ? lat * 180.0/PI : lat,
-      _["lng"] = degrees ? lng * 180.0/PI : lng
+    Rcpp::checkUserInterrupt();
+
+    R_xlen_t len = std::min(chunk, n - begin);
+
+    for (R_xlen_t j=0; j<len; j++) {
+      R_xlen_t i = begin + j;
+      SEXP h = STRING_ELT(hemisphere, i % hemisphere.size());
+      eastings[j] = easting[i % easting.size()];
+      northings[j] = northing[i % northing.size()];
+      // missing values get an invalid hemisphere (UPS_HEMISPHERE_ERROR)
+      hemispheres[j] = ((h == NA_STRING) || ISNAN(eastings[j]) ||
+                        ISNAN(northings[j])) ? '\0' : CHAR(h)[0];
+    }
+
+    err_ct += Convert_UPS_To_Geodetic_Batch_Ctx(&cv->ctx.ups, hemispheres.data(),
+                                                eastings.data(), northings.data(), len,
+                                                lat_out + begin, lng_out + begin, codes.data());
+
+    for (R_xlen_t j=0; j<len; j++) {
+      R_xlen_t i = begin + j;
+      if (codes[j] != UPS_NO_ERROR) {
+        lat_out[i] = NA_REAL;
+        lng_out[i] = NA_REAL;
+      } else if (degrees) {
+        lat_out[i] = lat_out[i] * 180.0/PI;
+        lng_out[i] = lng_out[i] * 180.0/PI;
+      }
+    }
+
+  }
+
+  if (err_ct > 0) {
+    Rcpp::warning(
+      "%d error%s encountered while converting %d UPS coordinates.\nErrant coordinates will be turned into `NA` pairs.",
+      err_ct, (err_ct > 1 ? "s" : ""), n
     );
   }
 
-  return(coords);
+  return(
+    DataFrame::create(
+      _["lat"] = lat_vec,
+      _["lng"] = lng_vec
+    )
+  );
 
 }
 
 //' Convert UTM to Latitude/Longitude
 //'
 //' @md
+//' @note vectorized; arguments are recycled to the length of the longest one
 //' @param zone 1:60
 //' @param hemisphere South (`S`) or North (`N`)
 //' @param easting,northing easting (X) / northing (Y) (meters)
 //' @param degrees convert to degrees? Default: `TRUE`
+//' @param converter an [mgrs_converter()] to convert with, for another
+//'        ellipsoid or to reuse one set of precomputed tables across calls.
+//'        Default: `NULL` (WGS 84)
+//' @return `data.frame` with `lat` and `lng` columns. Coordinates that cannot
+//'         be converted are turned into `NA` pairs (with one warning for all of them).
 //' @export
 //' @examples
 //' utm_to_latlng(48, "N", 377299, 1483035)
+//' utm_to_latlng(c(48, 33), "N", c(377299, 505004), c(1483035, 5344996))
 // [[Rcpp::export]]
-NumericVector utm_to_latlng(long zone, std::string hemisphere,
-                            double easting, double northing,
-                            bool degrees = true) {
+DataFrame utm_to_latlng(IntegerVector zone, CharacterVector hemisphere,
+                        NumericVector easting, NumericVector northing,
+                        bool degrees = true, SEXP converter = R_NilValue) {
+
+  const Converter *cv = get_converter(converter);
+
+  R_xlen_t n = recycled_length({ zone.size(), hemisphere.size(),
+                                 easting.size(), northing.size() });
+  NumericVector lat_vec(n);
+  NumericVector lng_vec(n);
+  double *lat_out = lat_vec.begin();
+  double *lng_out = lng_vec.begin();
+  const R_xlen_t chunk = std::min(cv->cache_size, n);
+  std::vector < long > zones(chunk);
+  std::vector < char > hemispheres(chunk);
+  std::vector < double > eastings(chunk);
+  std::vector < double > northings(chunk);
+  std::vector < long > codes(chunk);
+  long err_ct = 0;
+
+  // the Transverse Mercator parameters of every zone/hemisphere are
+  // computed once per ellipsoid, and the rows of a chunk are unprojected
+  // zone by zone by the batch kernel
+  for (R_xlen_t begin=0; begin<n; begin+=chunk) {
 
-  double lat, lng;
-  long ret;
+    Rcpp::checkUserInterrupt();
 
-  ret = Convert_UTM_To_Geodetic(zone, hemisphere.c_str()[0], easting, northing, &lat, &lng);
+    R_xlen_t len = std::min(chunk, n - begin);
 
-  NumericVector coords;
+    for (R_xlen_t j=0; j<len; j++) {
+      R_xlen_t i = begin + j;
+      int z = zone[i % zone.size()];
+      SEXP h = STRING_ELT(hemisphere, i % hemisphere.size());
+      eastings[j] = easting[i % easting.size()];
+      northings[j] = northing[i % northing.size()];
+      hemispheres[j] = (h == NA_STRING) ? '\0' : CHAR(h)[0];
+      // missing values get an invalid zone (UTM_ZONE_ERROR)
+      zones[j] = ((z == NA_INTEGER) || (h == NA_STRING) ||
+                  ISNAN(eastings[j]) || ISNAN(northings[j])) ? 0 : z;
+    }
+
+    err_ct += Convert_UTM_To_Geodetic_Batch_Ctx(&cv->ctx.utm, zones.data(), hemispheres.data(),
+                                                eastings.data(), northings.data(), len,
+                                                lat_out + begin, lng_out + begin, codes.data());
 
-  if (ret != UTM_NO_ERROR) {
-    Rcpp::warning("Error converting UTM to latitude/longitude");
-    coords = NumericVector::create(
-      _["lat"] = NA_REAL,
-      _["lng"] = NA_REAL
+    for (R_xlen_t j=0; j<len; j++) {
+      R_xlen_t i = begin + j;
+      if (codes[j] != UTM_NO_ERROR) {
+        lat_out[i] = NA_REAL;
+        lng_out[i] = NA_REAL;
+      } else if (degrees) {
+        lat_out[i] = lat_out[i] * 180.0/PI;
+        lng_out[i] = lng_out[i] * 180.0/PI;
+      }
+    }
+
+  }
+
+  if (err_ct > 0) {
+    Rcpp::warning(
+      "%d error%s encountered while converting %d UTM coordinates.\nErrant coordinates will be turned into `NA` pairs.",
+      err_ct, (err_ct > 1 ? "s" : ""), n
     );
-  } else {
-    coords = NumericVector::create(
-      _["lat"] = degrees ? lat * 180.0/PI : lat,
-      _["lng"] = degrees ? lng * 180.0/PI : lng
+  }
+
+  return(
+    DataFrame::create(
+      _["lat"] = lat_vec,
+      _["lng"] = lng_vec
+    )
+  );
+
+}
+
+//' Convert Latitude/Longitude to UTM
+//'
+//' @md
+//' @note vectorized
+//' @param latitude,longitude numeric vectors of coordinates (same length)
+//' @param zone_override 0:60; UTM zone to use instead of the natural one for
+//'        every coordinate (it must be adjacent to the natural zone). `0`
+//'        (the default) means no override.
+//' @param degrees are latitude/longitude in degrees? Default: `TRUE`
+//' @param converter an [mgrs_converter()] to convert with, for another
+//'        ellipsoid or to reuse one set of precomputed tables across calls.
+//'        Default: `NULL` (WGS 84)
+//' @return `data.frame` with `zone`, `hemisphere`, `easting` and `northing`
+//'         columns. Coordinates that cannot be converted are turned into `NA`
+//'         rows (with one warning for all of them).
+//' @export
+//' @examples
+//' latlng_to_utm(13.41250, 103.86667)
+//' latlng_to_utm(c(13.41250, 48.24948), c(103.86667, 16.41449))
+// [[Rcpp::export]]
+DataFrame latlng_to_utm(NumericVector latitude, NumericVector longitude,
+                        int zone_override = 0, bool degrees = true,
+                        SEXP converter = R_NilValue) {
+
+  const Converter *cv = get_converter(converter);
+
+  R_xlen_t n = latitude.size();
+
+  if (longitude.size() != n) {
+    Rcpp::stop("`latitude` and `longitude` must be the same length");
+  }
+
+  if ((zone_override < 0) || (zone_override > 60)) {
+    Rcpp::stop("`zone_override` must be between 0 and 60");
+  }
+
+  IntegerVector zonev(n);
+  CharacterVector hemispherev(n);
+  NumericVector eastingv(n);
+  NumericVector northingv(n);
+  long zone, ret, err_ct = 0;
+  char hemisphere;
+  double easting, northing;
+
+  for (R_xlen_t i=0; i<n; i++) {
+
+    if ((i % 10000) == 0) Rcpp::checkUserInterrupt();
+
+    double lat = degrees ? latitude[i] * PI / 180.0 : latitude[i];
+    double lng = degrees ? longitude[i] * PI / 180.0 : longitude[i];
+
+    if (ISNAN(lat) || ISNAN(lng)) {
+      ret = UTM_LAT_ERROR;
+    } else {
+      ret = Convert_Geodetic_To_UTM_Override_Ctx(&cv->ctx.utm, zone_override, lat, lng,
+                                                 &zone, &hemisphere, &easting, &northing);
+    }
+
+    if (ret != UTM_NO_ERROR) {
+      err_ct += 1;
+      zonev[i] = NA_INTEGER;
+      hemispherev[i] = NA_STRING;
+      eastingv[i] = NA_REAL;
+      northingv[i] = NA_REAL;
+    } else {
+      zonev[i] = zone;
+      hemispherev[i] = Rf_mkCharLen(&hemisphere, 1);
+      eastingv[i] = easting;
+      northingv[i] = northing;
+    }
+
+  }
+
+  if (err_ct > 0) {
+    Rcpp::warning(
+      "%d error%s encountered while converting %d latitude/longitude pairs.\nErrant pairs will be turned into `NA` rows.",
+      err_ct, (err_ct > 1 ? "s" : ""), n
     );
   }
 
-  return(coords);
+  return(
+    DataFrame::create(
+      _["zone"] = zonev,
+      _["hemisphere"] = hemispherev,
+      _["easting"] = eastingv,
+      _["northing"] = northingv,
+      _["stringsAsFactors"] = false
+    )
+  );
+
+}
+
+//' Convert Latitude/Longitude to UPS
+//'
+//' @md
+//' @note vectorized. Only latitudes north of 83.5 or south of -79.5 degrees
+//'       are within UPS coverage.
+//' @param latitude,longitude numeric vectors of coordinates (same length)
+//' @param degrees are latitude/longitude in degrees? Default: `TRUE`
+//' @param converter an [mgrs_converter()] to convert with, for another
+//'        ellipsoid or to reuse one set of precomputed tables across calls.
+//'        Default: `NULL` (WGS 84)
+//' @return `data.frame` with `hemisphere`, `easting` and `northing` columns.
+//'         Coordinates that cannot be converted are turned into `NA` rows
+//'         (with one warning for all of them).
+//' @export
+//' @examples
+//' latlng_to_ups(84.28723, 42.24790)
+//' latlng_to_ups(c(84.28723, -84.28723), c(42.24790, 137.75210))
+// [[Rcpp::export]]
+DataFrame latlng_to_ups(NumericVector latitude, NumericVector longitude,
+                        bool degrees = true, SEXP converter = R_NilValue) {
+
+  const Converter *cv = get_converter(converter);
+
+  R_xlen_t n = latitude.size();
+
+  if (longitude.size() != n) {
+    Rcpp::stop("`latitude` and `longitude` must be the same length");
+  }
+
+  CharacterVector hemispherev(n);
+  NumericVector eastingv(n);
+  NumericVector northingv(n);
+  double *easting_out = eastingv.begin();
+  double *northing_out = northingv.begin();
+  const R_xlen_t chunk = std::min(cv->cache_size, n);
+  std::vector < double > lats(chunk);
+  std::vector < double > lngs(chunk);
+  std::vector < char > hemispheres(chunk);
+  std::vector < long > codes(chunk);
+  long err_ct = 0;
+
+  // the rows of a chunk are projected hemisphere by hemisphere by the
+  // batch Polar Stereographic kernel
+  for (R_xlen_t begin=0; begin<n; begin+=chunk) {
+
+    Rcpp::checkUserInterrupt();
+
+    R_xlen_t len = std::min(chunk, n - begin);
+
+    for (R_xlen_t j=0; j<len; j++) {
+      R_xlen_t i = begin + j;
+      lats[j] = degrees ? latitude[i] * PI / 180.0 : latitude[i];
+      lngs[j] = degrees ? longitude[i] * PI / 180.0 : longitude[i];
+      // missing values get an invalid latitude (UPS_LAT_ERROR)
+      if (ISNAN(lats[j]) || ISNAN(lngs[j])) lats[j] = 0.0;
+    }
+
+    err_ct += Convert_Geodetic_To_UPS_Batch_Ctx(&cv->ctx.ups, lats.data(), lngs.data(), len,
+                                                hemispheres.data(), easting_out + begin,
+                                                northing_out + begin, codes.data());
+
+    for (R_xlen_t j=0; j<len; j++) {
+      R_xlen_t i = begin + j;
+      if (codes[j] != UPS_NO_ERROR) {
+        hemispherev[i] = NA_STRING;
+        easting_out[i] = NA_REAL;
+        northing_out[i] = NA_REAL;
+      } else {
+        hemispherev[i] = Rf_mkCharLen(&hemispheres[j], 1);
+      }
+    }
+
+  }
+
+  if (err_ct > 0) {
+    Rcpp::warning(
+      "%d error%s encountered while converting %d latitude/longitude pairs.\nErrant pairs will be turned into `NA` rows.",
+      err_ct, (err_ct > 1 ? "s" : ""), n
+    );
+  }
+
+  return(
+    DataFrame::create(
+      _["hemisphere"] = hemispherev,
+      _["easting"] = eastingv,
+      _["northing"] = northingv,
+      _["stringsAsFactors"] = false
+    )
+  );
+
+}
+
+//' Create a reusable MGRS converter
+//'
+//' Conversions run on tables derived from the ellipsoid: the Transverse
+//' Mercator parameters of every UTM zone and the polar stereographic
+//' parameters of both UPS hemispheres. A converter computes them once and
+//' keeps them, with a thread count and a chunk size, behind an external
+//' pointer that every vectorized function accepts as `converter`. Converters
+//' are read-only once made, never touch process-wide state and may be shared
+//' by any number of calls. They do not survive being saved and reloaded.
+//'
+//' @md
+//' @param ellipsoid two-letter GEOTRANS ellipsoid code: `AA` (Airy 1830),
+//'        `AM` (Modified Airy), `AN` (Australian National), `BN` (Bessel
+//'        1841, Namibia), `BR` (Bessel 1841), `CC` (Clarke 1866), `CD`
+//'        (Clarke 1880), `EA` (Everest 1830), `FA` (Modified Fischer 1960),
+//'        `HE` (Helmert 1906), `HO` (Hough 1960), `ID` (Indonesian 1974),
+//'        `IN` (International 1924), `KA` (Krassovsky 1940), `RF` (GRS 80),
+//'        `SA` (South American 1969), `WD` (WGS 72) or `WE` (WGS 84).
+//'        Default: `"WE"`
+//' @param nthreads number of threads the functions taking `nthreads` convert
+//'        with when theirs is left at `NA`. Default: `1`
+//' @param cache_size number of rows each thread converts at a time. Results
+//'        do not depend on it. Default: `10000`
+//' @param engine Transverse Mercator series the UTM conversions evaluate:
+//'        `"thomas"`, the GEOTRANS series in powers of the distance from
+//'        the central meridian, or `"kruger"`, Krüger's series in the third
+//'        flattening to 6th order. They agree to within 0.01 mm inside the
+//'        standard 6 degree zones; beyond 9 degrees from the central
+//'        meridian the Thomas series drifts (by about 100 m at 30 degrees)
+//'        while the Krüger series stays within a few nanometers. Default:
+//'        `"thomas"`
+//' @return an object of class `mgrs_converter`
+//' @export
+//' @examples
+//' cv <- mgrs_converter(nthreads = 2)
+//' mgrs_to_latlng("15TWG0000049776", converter = cv)
+//' latlng_to_mgrs(42, -93, converter = mgrs_converter("IN"))
+//' latlng_to_utm(78.2, 20.9, converter = mgrs_converter(engine = "kruger"))
+// [[Rcpp::export]]
+SEXP mgrs_converter(std::string ellipsoid = "WE", int nthreads = 1,
+                    int cache_size = 10000, std::string engine = "thomas") {
+
+  const int n_ellipsoids = sizeof(ellipsoids) / sizeof(ellipsoids[0]);
+  int e = 0;
+
+  while ((e < n_ellipsoids) && (ellipsoid != ellipsoids[e].code)) e++;
+
+  if (e == n_ellipsoids) {
+    std::string codes;
+    for (int i=0; i<n_ellipsoids; i++) codes += (i ? ", " : "") + std::string(ellipsoids[i].code);
+    Rcpp::stop("`ellipsoid` must be one of " + codes);
+  }
+
+  check_nthreads(nthreads);
+
+  if ((cache_size == NA_INTEGER) || (cache_size < 1)) {
+    Rcpp::stop("`cache_size` must be a positive integer");
+  }
+
+  long tm_engine;
+  if (engine == "thomas") {
+    tm_engine = TRANMERC_THOMAS;
+  } else if (engine == "kruger") {
+    tm_engine = TRANMERC_KRUGER;
+  } else {
+    Rcpp::stop("`engine` must be one of thomas, kruger");
+  }
+
+  Converter *cv = new Converter();
+  cv->nthreads = nthreads;
+  cv->cache_size = cache_size;
+
+  if (Set_MGRS_Parameters_Ctx(&cv->ctx, ellipsoids[e].a, 1 / ellipsoids[e].inv_f,
+                              ellipsoids[e].code) != MGRS_NO_ERROR) {
+    delete cv;
+    Rcpp::stop("could not set up the %s ellipsoid", ellipsoids[e].name);
+  }
+  Set_UTM_Engine_Ctx(&cv->ctx.utm, tm_engine);
+
+  XPtr < Converter > out(cv, true);
+  out.attr("class") = "mgrs_converter";
+  out.attr("ellipsoid") = ellipsoids[e].code;
+  out.attr("nthreads") = nthreads;
+  out.attr("cache_size") = cache_size;
+  out.attr("engine") = engine;
+
+  return(out);
 
 }
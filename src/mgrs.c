@@ -77,18 +77,16 @@
 /*
  *                               INCLUDES
  */
-#include <ctype.h>
 #include <math.h>
-#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include "ups.h"
 #include "utm.h"
 #include "mgrs.h"
 
 /*
- *      ctype.h     - Standard C character handling library
  *      math.h      - Standard C math library
- *      stdio.h     - Standard C input/output library
+ *      stdlib.h    - Standard C general utilities library
  *      string.h    - Standard C string handling library
  *      ups.h       - Universal Polar Stereographic (UPS) projection
  *      utm.h       - Universal Transverse Mercator (UTM) projection
@@ -147,11 +145,32 @@
 #define MIN_EAST_NORTH 0
 #define MAX_EAST_NORTH 4000000
 
+#define MGRS_IS_DIGIT(c) ((unsigned char)((c) - '0') < 10)  /* ASCII only, */
+#define MGRS_IS_ALPHA(c) ((unsigned char)(((c) | 0x20) - 'a') < 26) /* no locale */
 
-/* Ellipsoid parameters, default to WGS 84 */
-double MGRS_a = 6378137.0;    /* Semi-major axis of ellipsoid in meters */
-double MGRS_f = 1 / 298.257223563; /* Flattening of ellipsoid           */
-char   MGRS_Ellipsoid_Code[3] = {'W','E',0};
+#define BATCH_SORT_MIN_COUNT  4096  /* Batches this long are converted zone by zone */
+#define BATCH_KEY_SOUTH_POLE   120  /* Batch keys 0-119 are (zone - 1) * 2 + south */
+#define BATCH_KEY_NORTH_POLE   121
+#define BATCH_KEY_INVALID      122
+#define BATCH_KEYS             123
+#define BATCH_BLOCK            256  /* Rows projected to UTM at a time */
+#define FAST_MAX_PRECISION       3  /* Finer rows are always projected exactly */
+
+
+/* Ellipsoid parameters used by the non-reentrant functions, default to WGS 84 */
+static MGRS_Context MGRS_Default_Context =
+  {
+    6378137.0,                          /* Semi-major axis of ellipsoid in meters */
+    1 / 298.257223563,                  /* Flattening of ellipsoid           */
+    {'W','E',0},                        /* 2-letter code for ellipsoid       */
+    TRUE,                               /* AA letter pattern                 */
+    {6378137.0, 1 / 298.257223563, 0, TRANMERC_THOMAS, .Zone_Parameters = {{{0}}}},
+                                        /* UTM state, no zone override      */
+    {6378137.0, 1 / 298.257223563, .Hemisphere_Parameters = {{0}}}
+                                        /* UPS state                        */
+  };
+/* UTM zone parameters of MGRS_Default_Context are built on first use */
+static long MGRS_Default_Context_Set = 0;
 
 
 /*
@@ -214,11 +233,78 @@ static const UPS_Constant UPS_Constant_Table[4] =
   {LETTER_Y, LETTER_J, LETTER_Z, LETTER_P, 800000.0, 1300000.0},
   {LETTER_Z, LETTER_A, LETTER_J, LETTER_P, 2000000.0, 1300000.0}};
 
+/* Latitude_Band_Table index of each latitude band letter, -1 if none */
+static const signed char Latitude_Band_Index[26] =
+  { -1, -1,  0,  1,  2,  3,  4,  5, -1,  6,  7,  8,  9, 10, -1, 11,
+    12, 13, 14, 15, 16, 17, 18, 19, -1, -1};
+
+/*
+ * The 100,000m square letters of the UTM zones.  A zone's column letters
+ * depend on its set number (1-6) modulo 3, i.e. (zone - 1) % 3, and the
+ * northing of its row letter A on the ellipsoid's letter pattern (AA or AL)
+ * and on the parity of the set number, i.e. of the zone.  I and O are never
+ * used.
+ */
+
+/* Column letter of the squares easting 100,000m - 900,000m, by set */
+static const signed char Column_Letter_Table[3][8] =
+  {{LETTER_A, LETTER_B, LETTER_C, LETTER_D, LETTER_E, LETTER_F, LETTER_G, LETTER_H},
+  {LETTER_J, LETTER_K, LETTER_L, LETTER_M, LETTER_N, LETTER_P, LETTER_Q, LETTER_R},
+  {LETTER_S, LETTER_T, LETTER_U, LETTER_V, LETTER_W, LETTER_X, LETTER_Y, LETTER_Z}};
+
+/* Row letter of the squares 0m - 2,000,000m north of row letter A */
+static const signed char Row_Letter_Table[20] =
+  {LETTER_A, LETTER_B, LETTER_C, LETTER_D, LETTER_E, LETTER_F, LETTER_G,
+  LETTER_H, LETTER_J, LETTER_K, LETTER_L, LETTER_M, LETTER_N, LETTER_P,
+  LETTER_Q, LETTER_R, LETTER_S, LETTER_T, LETTER_U, LETTER_V};
+
+/* False northing of row letter A, by pattern (AA, AL) and set parity (odd, even) */
+static const double Pattern_Offset_Table[2][2] =
+  {{0.0, 500000.0},
+  {1000000.0, 1500000.0}};
+
+/* Easting in 100,000m of each column letter, by set, -1 if not in the set */
+static const signed char Column_Square_Table[3][26] =
+  {{ 1,  2,  3,  4,  5,  6,  7,  8, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+  {-1, -1, -1, -1, -1, -1, -1, -1, -1,  1,  2,  3,  4,  5, -1,  6,
+     7,  8, -1, -1, -1, -1, -1, -1, -1, -1},
+  {-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1,  1,  2,  3,  4,  5,  6,  7,  8}};
+
+/* Northing in 100,000m (modulo 2,000,000m) of each row letter, by pattern
+ * (AA, AL) and set parity (odd, even), -1 if not a row letter */
+static const signed char Row_Square_Table[2][2][26] =
+  {{{ 0,  1,  2,  3,  4,  5,  6,  7, -1,  8,  9, 10, 11, 12, -1, 13,
+     14, 15, 16, 17, 18, 19, -1, -1, -1, -1},
+   {15, 16, 17, 18, 19,  0,  1,  2, -1,  3,  4,  5,  6,  7, -1,  8,
+     9, 10, 11, 12, 13, 14, -1, -1, -1, -1}},
+  {{10, 11, 12, 13, 14, 15, 16, 17, -1, 18, 19,  0,  1,  2, -1,  3,
+      4,  5,  6,  7,  8,  9, -1, -1, -1, -1},
+   { 5,  6,  7,  8,  9, 10, 11, 12, -1, 13, 14, 15, 16, 17, -1, 18,
+     19,  0,  1,  2,  3,  4, -1, -1, -1, -1}}};
+
 /***************************************************************************/
 /*
  *                              FUNCTIONS
  */
 
+static MGRS_Context *Default_MGRS_Context (void)
+/*
+ * The function Default_MGRS_Context returns the context used by the
+ * non-reentrant functions, computing its UTM zone parameters on first use.
+ */
+{ /* Default_MGRS_Context */
+  if (!MGRS_Default_Context_Set)
+  {
+    Set_MGRS_Parameters_Ctx (&MGRS_Default_Context, MGRS_Default_Context.a,
+                             MGRS_Default_Context.f, MGRS_Default_Context.Ellipsoid_Code);
+    MGRS_Default_Context_Set = 1;
+  }
+  return (&MGRS_Default_Context);
+} /* Default_MGRS_Context */
+
+
 long Get_Latitude_Band_Min_Northing(long letter, double* min_northing, double* northing_offset)
 /*
  * The function Get_Latitude_Band_Min_Northing receives a latitude band letter
@@ -229,22 +315,13 @@ long Get_Latitude_Band_Min_Northing(long letter, double* min_northing, double* n
  *   min_northing  : Minimum northing for that letter	(output)
  */
 { /* Get_Latitude_Band_Min_Northing */
+  long band = ((letter >= LETTER_A) && (letter <= LETTER_Z)) ? Latitude_Band_Index[letter] : -1;
   long error_code = MGRS_NO_ERROR;
 
-  if ((letter >= LETTER_C) && (letter <= LETTER_H))
-  {
-    *min_northing = Latitude_Band_Table[letter-2].min_northing;
-    *northing_offset = Latitude_Band_Table[letter-2].northing_offset;
-  }
-  else if ((letter >= LETTER_J) && (letter <= LETTER_N))
+  if (band >= 0)
   {
-    *min_northing = Latitude_Band_Table[letter-3].min_northing;
-    *northing_offset = Latitude_Band_Table[letter-3].northing_offset;
-  }
-  else if ((letter >= LETTER_P) && (letter <= LETTER_X))
-  {
-    *min_northing = Latitude_Band_Table[letter-4].min_northing;
-    *northing_offset = Latitude_Band_Table[letter-4].northing_offset;
+    *min_northing = Latitude_Band_Table[band].min_northing;
+    *northing_offset = Latitude_Band_Table[band].northing_offset;
   }
   else
     error_code |= MGRS_STRING_ERROR;
@@ -264,22 +341,13 @@ long Get_Latitude_Range(long letter, double* north, double* south)
  *   north    : Southern latitude boundary for that letter	(output)
  */
 { /* Get_Latitude_Range */
+  long band = ((letter >= LETTER_A) && (letter <= LETTER_Z)) ? Latitude_Band_Index[letter] : -1;
   long error_code = MGRS_NO_ERROR;
 
-  if ((letter >= LETTER_C) && (letter <= LETTER_H))
-  {
-    *north = Latitude_Band_Table[letter-2].north * DEG_TO_RAD;
-    *south = Latitude_Band_Table[letter-2].south * DEG_TO_RAD;
-  }
-  else if ((letter >= LETTER_J) && (letter <= LETTER_N))
+  if (band >= 0)
   {
-    *north = Latitude_Band_Table[letter-3].north * DEG_TO_RAD;
-    *south = Latitude_Band_Table[letter-3].south * DEG_TO_RAD;
-  }
-  else if ((letter >= LETTER_P) && (letter <= LETTER_X))
-  {
-    *north = Latitude_Band_Table[letter-4].north * DEG_TO_RAD;
-    *south = Latitude_Band_Table[letter-4].south * DEG_TO_RAD;
+    *north = Latitude_Band_Table[band].north * DEG_TO_RAD;
+    *south = Latitude_Band_Table[band].south * DEG_TO_RAD;
   }
   else
     error_code |= MGRS_STRING_ERROR;
@@ -316,7 +384,7 @@ long Get_Latitude_Letter(double latitude, int* letter)
 } /* Get_Latitude_Letter */
 
 
-long Check_Zone(char* MGRS, long* zone_exists)
+long Check_Zone(const char* MGRS, long* zone_exists)
 /*
  * The function Check_Zone receives an MGRS coordinate string.
  * If a zone is given, TRUE is returned. Otherwise, FALSE
@@ -336,7 +404,7 @@ long Check_Zone(char* MGRS, long* zone_exists)
   while (MGRS[i] == ' ')
     i++;
   j = i;
-  while (isdigit(MGRS[i]))
+  while (MGRS_IS_DIGIT(MGRS[i]))
     i++;
   num_digits = i - j;
   if (num_digits <= 2)
@@ -351,6 +419,84 @@ long Check_Zone(char* MGRS, long* zone_exists)
 } /* Check_Zone */
 
 
+static const char Digit_Pairs[] =
+  "00010203040506070809"
+  "10111213141516171819"
+  "20212223242526272829"
+  "30313233343536373839"
+  "40414243444546474849"
+  "50515253545556575859"
+  "60616263646566676869"
+  "70717273747576777879"
+  "80818283848586878889"
+  "90919293949596979899";
+
+/* Divisors that truncate a 100,000 meter square offset to 0 - 5 digits */
+static const double Precision_Divisor[MAX_PRECISION + 1] =
+  {100000.0, 10000.0, 1000.0, 100.0, 10.0, 1.0};
+
+
+static double Grid_Square_Offset (double Value)
+/*
+ * The function Grid_Square_Offset returns fmod (Value, 100000.0).  Values
+ * an easting or northing can take are reduced with one truncating division
+ * and an exact subtraction; anything else falls back to fmod.
+ *
+ *   Value          : Easting or northing value       (input)
+ */
+{ /* Grid_Square_Offset */
+  long squares;
+
+  if ((Value >= 0.0) && (Value < 2147483648.0))
+  {
+    squares = (long)(Value / ONEHT);
+    Value -= squares * ONEHT;
+    if (Value < 0.0)
+      Value += ONEHT;
+    else if (Value >= ONEHT)
+      Value -= ONEHT;
+    return (Value);
+  }
+  return (fmod (Value, ONEHT));
+} /* Grid_Square_Offset */
+
+
+static long Write_Digits (char* MGRS,
+                          long Value,
+                          long Width)
+/*
+ * The function Write_Digits writes Value zero-padded to Width digits, as
+ * sprintf "%*.*ld" does with Width for both, and returns the number of
+ * characters written.  |Value| must be less than 10 to the power Width.
+ *
+ *   MGRS           : Output buffer                   (output)
+ *   Value          : Value to write                  (input)
+ *   Width          : Number of digits                (input)
+ */
+{ /* Write_Digits */
+  long length = 0;
+  char *end;
+
+  if (Value < 0)
+  {
+    MGRS[length++] = '-';
+    Value = -Value;
+  }
+  length += Width;
+  end = MGRS + length;
+  while (Width >= 2)
+  {
+    end -= 2;
+    memcpy (end, Digit_Pairs + 2 * (Value % 100), 2);
+    Value /= 100;
+    Width -= 2;
+  }
+  if (Width)
+    end[-1] = (char)('0' + Value);
+  return (length);
+} /* Write_Digits */
+
+
 long Make_MGRS_String (char* MGRS,
                        long Zone,
                        int Letters[MGRS_LETTERS],
@@ -379,27 +525,31 @@ long Make_MGRS_String (char* MGRS,
 
   i = 0;
   if (Zone)
-    i = sprintf (MGRS+i,"%2.2ld",Zone);
+  {
+    memcpy (MGRS, Digit_Pairs + 2 * Zone, 2);
+    i = 2;
+  }
   else
-    strncpy(MGRS, "  ", 2);  // 2 spaces
+    memcpy (MGRS, "  ", 2);  // 2 spaces
 
   for (j=0;j<3;j++)
     MGRS[i++] = alphabet[Letters[j]];
-  divisor = pow (10.0, (5 - Precision));
-  Easting = fmod (Easting, 100000.0);
+  divisor = Precision_Divisor[Precision];
+  Easting = Grid_Square_Offset (Easting);
   if (Easting >= 99999.5)
     Easting = 99999.0;
   east = (long)(Easting/divisor);
-  i += sprintf (MGRS+i, "%*.*ld", (int)Precision, (int)Precision, east);
-  Northing = fmod (Northing, 100000.0);
+  i += Write_Digits (MGRS+i, east, Precision);
+  Northing = Grid_Square_Offset (Northing);
   if (Northing >= 99999.5)
     Northing = 99999.0;
   north = (long)(Northing/divisor);
-  i += sprintf (MGRS+i, "%*.*ld", (int)Precision, (int)Precision, north);
+  i += Write_Digits (MGRS+i, north, Precision);
+  MGRS[i] = 0;
   return (error_code);
 } /* Make_MGRS_String */
 
-long Break_MGRS_String (char* MGRS,
+long Break_MGRS_String (const char* MGRS,
                         long* Zone,
                         long Letters[MGRS_LETTERS],
                         double* Easting,
@@ -417,85 +567,79 @@ long Break_MGRS_String (char* MGRS,
  *   Precision      : Precision level of MGRS string  (output)
  */
 { /* Break_MGRS_String */
-  long num_digits;
-  long num_letters;
-  long i = 0;
-  long j = 0;
+  static const long Powers_Of_Ten[MAX_PRECISION + 1] =
+    {1, 10, 100, 1000, 10000, 100000};
+  char digit[2 * MAX_PRECISION];
+  const char *c = MGRS;
+  long num_digits = 0;
+  long zone = 0;
+  long east = 0;
+  long north = 0;
+  long n;
   long error_code = MGRS_NO_ERROR;
 
-  while (MGRS[i] == ' ')
-    i++;  /* skip any leading blanks */
-  j = i;
-  while (isdigit(MGRS[i]))
-    i++;
-  num_digits = i - j;
-  if (num_digits <= 2)
-    if (num_digits > 0)
+  while (*c == ' ')
+    c++;  /* skip any leading blanks */
+
+  /* get zone */
+  while (MGRS_IS_DIGIT(*c))
+  {
+    zone = zone * 10 + (*c++ - '0');
+    if (++num_digits > 2)
+      break;
+  }
+  if (num_digits > 2)
+  {
+    error_code |= MGRS_STRING_ERROR;
+    while (MGRS_IS_DIGIT(*c))
+      c++;
+  }
+  else
+  {
+    *Zone = zone;
+    if ((num_digits > 0) && ((zone < 1) || (zone > 60)))
+      error_code |= MGRS_STRING_ERROR;
+  }
+
+  /* get letters */
+  if (MGRS_IS_ALPHA(c[0]) && MGRS_IS_ALPHA(c[1]) && MGRS_IS_ALPHA(c[2])
+      && !MGRS_IS_ALPHA(c[3]))
+  {
+    for (n = 0; n < MGRS_LETTERS; n++)
     {
-      char zone_string[3];
-      /* get zone */
-      strncpy (zone_string, MGRS+j, 2);
-      zone_string[2] = 0;
-      sscanf (zone_string, "%ld", Zone);
-      if ((*Zone < 1) || (*Zone > 60))
+      Letters[n] = (c[n] & ~0x20) - 'A';
+      if ((Letters[n] == LETTER_I) || (Letters[n] == LETTER_O))
         error_code |= MGRS_STRING_ERROR;
     }
-    else
-      *Zone = 0;
+    c += MGRS_LETTERS;
+  }
   else
+  {
     error_code |= MGRS_STRING_ERROR;
-  j = i;
+    while (MGRS_IS_ALPHA(*c))
+      c++;
+  }
 
-  while (isalpha(MGRS[i]))
-    i++;
-  num_letters = i - j;
-  if (num_letters == 3)
+  /* get easting & northing */
+  num_digits = 0;
+  while (MGRS_IS_DIGIT(*c))
   {
-    /* get letters */
-    Letters[0] = (toupper(MGRS[j]) - (long)'A');
-    if ((Letters[0] == LETTER_I) || (Letters[0] == LETTER_O))
-      error_code |= MGRS_STRING_ERROR;
-    Letters[1] = (toupper(MGRS[j+1]) - (long)'A');
-    if ((Letters[1] == LETTER_I) || (Letters[1] == LETTER_O))
-      error_code |= MGRS_STRING_ERROR;
-    Letters[2] = (toupper(MGRS[j+2]) - (long)'A');
-    if ((Letters[2] == LETTER_I) || (Letters[2] == LETTER_O))
-      error_code |= MGRS_STRING_ERROR;
+    if (num_digits < 2 * MAX_PRECISION)
+      digit[num_digits] = *c - '0';
+    num_digits++;
+    c++;
   }
-  else
-    error_code |= MGRS_STRING_ERROR;
-  j = i;
-  while (isdigit(MGRS[i]))
-    i++;
-  num_digits = i - j;
-  if ((num_digits <= 10) && (num_digits%2 == 0))
+  if ((num_digits <= 2 * MAX_PRECISION) && (num_digits%2 == 0))
   {
-    long n;
-    char east_string[6];
-    char north_string[6];
-    long east;
-    long north;
-    double multiplier;
-    /* get easting & northing */
     n = num_digits/2;
     *Precision = n;
-    if (n > 0)
-    {
-      strncpy (east_string, MGRS+j, n);
-      east_string[n] = 0;
-      sscanf (east_string, "%ld", &east);
-      strncpy (north_string, MGRS+j+n, n);
-      north_string[n] = 0;
-      sscanf (north_string, "%ld", &north);
-      multiplier = pow (10.0, 5 - n);
-      *Easting = east * multiplier;
-      *Northing = north * multiplier;
-    }
-    else
+    for (num_digits = 0; num_digits < n; num_digits++)
     {
-      *Easting = 0.0;
-      *Northing = 0.0;
+      east = east * 10 + digit[num_digits];
+      north = north * 10 + digit[n + num_digits];
     }
+    *Easting = (double)(east * Powers_Of_Ten[MAX_PRECISION - n]);
+    *Northing = (double)(north * Powers_Of_Ten[MAX_PRECISION - n]);
   }
   else
     error_code |= MGRS_STRING_ERROR;
@@ -504,72 +648,8 @@ long Break_MGRS_String (char* MGRS,
 } /* Break_MGRS_String */
 
 
-void Get_Grid_Values (long zone,
-                      long* ltr2_low_value,
-                      long* ltr2_high_value,
-                      double *pattern_offset)
-/*
- * The function getGridValues sets the letter range used for
- * the 2nd letter in the MGRS coordinate string, based on the set
- * number of the utm zone. It also sets the pattern offset using a
- * value of A for the second letter of the grid square, based on
- * the grid pattern and set number of the utm zone.
- *
- *    zone            : Zone number             (input)
- *    ltr2_low_value  : 2nd letter low number   (output)
- *    ltr2_high_value : 2nd letter high number  (output)
- *    pattern_offset  : Pattern offset          (output)
- */
-{ /* BEGIN Get_Grid_Values */
-  long set_number;    /* Set number (1-6) based on UTM zone number */
-  long aa_pattern;    /* Pattern based on ellipsoid code */
-
-  set_number = zone % 6;
-
-  if (!set_number)
-    set_number = 6;
-
-  if (!strcmp(MGRS_Ellipsoid_Code,CLARKE_1866) || !strcmp(MGRS_Ellipsoid_Code, CLARKE_1880) ||
-      !strcmp(MGRS_Ellipsoid_Code,BESSEL_1841) || !strcmp(MGRS_Ellipsoid_Code,BESSEL_1841_NAMIBIA))
-    aa_pattern = FALSE;
-  else
-    aa_pattern = TRUE;
-
-  if ((set_number == 1) || (set_number == 4))
-  {
-    *ltr2_low_value = LETTER_A;
-    *ltr2_high_value = LETTER_H;
-  }
-  else if ((set_number == 2) || (set_number == 5))
-  {
-    *ltr2_low_value = LETTER_J;
-    *ltr2_high_value = LETTER_R;
-  }
-  else if ((set_number == 3) || (set_number == 6))
-  {
-    *ltr2_low_value = LETTER_S;
-    *ltr2_high_value = LETTER_Z;
-  }
-
-  /* False northing at A for second letter of grid square */
-  if (aa_pattern)
-  {
-    if ((set_number % 2) ==  0)
-      *pattern_offset = 500000.0;
-    else
-      *pattern_offset = 0.0;
-  }
-  else
-  {
-    if ((set_number % 2) == 0)
-      *pattern_offset =  1500000.0;
-    else
-      *pattern_offset = 1000000.00;
-  }
-} /* END OF Get_Grid_Values */
-
-
-long UTM_To_MGRS (long Zone,
+long UTM_To_MGRS (const MGRS_Context *ctx,
+                  long Zone,
                   char Hemisphere,
                   double Longitude,
                   double Latitude,
@@ -581,6 +661,7 @@ long UTM_To_MGRS (long Zone,
  * The function UTM_To_MGRS calculates an MGRS coordinate string
  * based on the zone, latitude, easting and northing.
  *
+ *    ctx       : MGRS context            (input)
  *    Zone      : Zone number             (input)
  *    Hemisphere: Hemisphere              (input)
  *    Longitude : Longitude in radians    (input)
@@ -594,8 +675,7 @@ long UTM_To_MGRS (long Zone,
   double pattern_offset;      /* Northing offset for 3rd letter               */
   double grid_easting;        /* Easting used to derive 2nd letter of MGRS   */
   double grid_northing;       /* Northing used to derive 3rd letter of MGRS  */
-  long ltr2_low_value;        /* 2nd letter range - low number               */
-  long ltr2_high_value;       /* 2nd letter range - high number              */
+  long column;                /* 100,000m column of the easting, 0 - 7       */
   int letters[MGRS_LETTERS];  /* Number location of 3 letters in alphabet    */
   long temp_error_code = MGRS_NO_ERROR;
   long error_code = MGRS_NO_ERROR;
@@ -604,8 +684,7 @@ long UTM_To_MGRS (long Zone,
 	/* Special check for rounding to (truncated) eastern edge of zone 31V */
 	if ((Zone == 31) && (((Latitude >= 56.0 * DEG_TO_RAD) && (Latitude < 64.0 * DEG_TO_RAD)) && ((Longitude >= 3.0 * DEG_TO_RAD) || (Easting >= 500000.0))))
 	{ /* Reconvert to UTM zone 32 */
-    Set_UTM_Parameters (MGRS_a, MGRS_f, 32);
-    temp_error_code = Convert_Geodetic_To_UTM (Latitude, Longitude, &Zone, &Hemisphere, &Easting, &Northing);
+    temp_error_code = Convert_Geodetic_To_UTM_Override_Ctx (&ctx->utm, 32, Latitude, Longitude, &Zone, &Hemisphere, &Easting, &Northing);
     if(temp_error_code)
     {
       if(temp_error_code & UTM_LAT_ERROR)
@@ -629,7 +708,7 @@ long UTM_To_MGRS (long Zone,
     Northing = 0.0;
   }
 
-  Get_Grid_Values(Zone, &ltr2_low_value, &ltr2_high_value, &pattern_offset);
+  pattern_offset = Pattern_Offset_Table[!ctx->AA_Pattern][!(Zone % 2)];
 
   error_code = Get_Latitude_Letter(Latitude, &letters[0]);
 
@@ -645,27 +724,191 @@ long UTM_To_MGRS (long Zone,
     if(grid_northing >= TWOMIL)
       grid_northing = grid_northing - TWOMIL;
 
-    letters[2] = (long)(grid_northing / ONEHT);
-    if (letters[2] > LETTER_H)
-      letters[2] = letters[2] + 1;
-
-    if (letters[2] > LETTER_N)
-      letters[2] = letters[2] + 1;
+    letters[2] = Row_Letter_Table[(long)(grid_northing / ONEHT)];
 
     grid_easting = Easting;
     if (((letters[0] == LETTER_V) && (Zone == 31)) && (grid_easting == 500000.0))
       grid_easting = grid_easting - 1.0; /* SUBTRACT 1 METER */
 
-    letters[1] = ltr2_low_value + ((long)(grid_easting / ONEHT) -1);
-    if ((ltr2_low_value == LETTER_J) && (letters[1] > LETTER_N))
-      letters[1] = letters[1] + 1;
-
-    Make_MGRS_String (MGRS, Zone, letters, grid_easting, Northing, Precision);
+    /* An easting of exactly 900,000m has no column letter */
+    column = (long)(grid_easting / ONEHT) - 1;
+    if ((column < 0) || (column > 7))
+      error_code |= MGRS_EASTING_ERROR;
+    else
+    {
+      letters[1] = Column_Letter_Table[(Zone - 1) % 3][column];
+      Make_MGRS_String (MGRS, Zone, letters, grid_easting, Northing, Precision);
+    }
   }
   return error_code;
 } /* END UTM_To_MGRS */
 
 
+static long MGRS_String_To_UTM (const MGRS_Context *ctx,
+                                const char *MGRS,
+                                long   *Zone,
+                                char   *Hemisphere,
+                                double *Easting,
+                                double *Northing,
+                                long   *Band_Letter,
+                                long   *In_Precision)
+/*
+ * The function MGRS_String_To_UTM converts an MGRS coordinate string with a
+ * zone to UTM projection coordinates, without checking that the point lies
+ * within its latitude band (see Check_Latitude_Band).
+ *
+ *    ctx          : MGRS context                      (input)
+ *    MGRS         : MGRS coordinate string            (input)
+ *    Zone         : UTM zone                          (output)
+ *    Hemisphere   : North or South hemisphere         (output)
+ *    Easting      : Easting (X) in meters             (output)
+ *    Northing     : Northing (Y) in meters            (output)
+ *    Band_Letter  : Latitude band letter              (output)
+ *    In_Precision : Precision of the string           (output)
+ */
+{ /* BEGIN MGRS_String_To_UTM */
+  double min_northing;
+  double northing_offset;
+  long column_square;         /* Easting of 2nd letter in 100,000 meters    */
+  long row_square;            /* Northing of 3rd letter in 100,000 meters   */
+  double grid_easting;        /* Easting for 100,000 meter grid square      */
+  double grid_northing;       /* Northing for 100,000 meter grid square     */
+  long letters[MGRS_LETTERS];
+  long error_code = MGRS_NO_ERROR;
+
+  error_code = Break_MGRS_String (MGRS, Zone, letters, Easting, Northing, In_Precision);
+  if (!*Zone)
+    error_code |= MGRS_STRING_ERROR;
+  else
+  {
+    if (!error_code)
+    {
+      if ((letters[0] == LETTER_X) && ((*Zone == 32) || (*Zone == 34) || (*Zone == 36)))
+        error_code |= MGRS_STRING_ERROR;
+      else
+      {
+        if (letters[0] < LETTER_N)
+          *Hemisphere = 'S';
+        else
+          *Hemisphere = 'N';
+
+        /* Check that the second letter of the MGRS string is one of
+         * the zone's column letters and the third letter a row letter */
+        column_square = Column_Square_Table[(*Zone - 1) % 3][letters[1]];
+        row_square = Row_Square_Table[!ctx->AA_Pattern][!(*Zone % 2)][letters[2]];
+        if ((column_square < 0) || (row_square < 0))
+          error_code |= MGRS_STRING_ERROR;
+
+        if (!error_code)
+        {
+          grid_easting = (double)column_square * ONEHT;
+
+          error_code = Get_Latitude_Band_Min_Northing(letters[0], &min_northing, &northing_offset);
+          if (!error_code)
+          {
+            grid_northing = (double)row_square * ONEHT;
+
+            grid_northing += northing_offset;
+
+            if(grid_northing < min_northing)
+              grid_northing += TWOMIL;
+
+            *Easting = grid_easting + *Easting;
+            *Northing = grid_northing + *Northing;
+            *Band_Letter = letters[0];
+          }
+        }
+      }
+    }
+  }
+  return (error_code);
+} /* END MGRS_String_To_UTM */
+
+
+static long Check_Latitude_Band (long UTM_Error,
+                                 long Band_Letter,
+                                 long In_Precision,
+                                 double Latitude)
+/*
+ * The function Check_Latitude_Band returns the MGRS error code(s) of the
+ * inverse projection of an MGRS string: those matching UTM_Error, or
+ * MGRS_LAT_WARNING if Latitude is outside the latitude band of Band_Letter
+ * by more than the precision of the string.
+ *
+ *    UTM_Error    : UTM inverse projection error code(s)   (input)
+ *    Band_Letter  : Latitude band letter                    (input)
+ *    In_Precision : Precision of the string                 (input)
+ *    Latitude     : Latitude in radians                     (input)
+ */
+{ /* BEGIN Check_Latitude_Band */
+  double upper_lat_limit;     /* North latitude limits based on 1st letter  */
+  double lower_lat_limit;     /* South latitude limits based on 1st letter  */
+  double divisor = 1.0;
+  long error_code = MGRS_NO_ERROR;
+
+  if (!UTM_Error)
+  {
+    divisor = pow (10.0, In_Precision);
+    error_code = Get_Latitude_Range(Band_Letter, &upper_lat_limit, &lower_lat_limit);
+    if (!error_code)
+    {
+      if (!(((lower_lat_limit - DEG_TO_RAD/divisor) <= Latitude) && (Latitude <= (upper_lat_limit + DEG_TO_RAD/divisor))))
+        error_code |= MGRS_LAT_WARNING;
+    }
+  }
+  else
+  {
+    if((UTM_Error & UTM_ZONE_ERROR) || (UTM_Error & UTM_HEMISPHERE_ERROR))
+      error_code |= MGRS_STRING_ERROR;
+    if(UTM_Error & UTM_EASTING_ERROR)
+      error_code |= MGRS_EASTING_ERROR;
+    if(UTM_Error & UTM_NORTHING_ERROR)
+      error_code |= MGRS_NORTHING_ERROR;
+  }
+  return (error_code);
+} /* END Check_Latitude_Band */
+
+
+static long MGRS_To_UTM (const MGRS_Context *ctx,
+                         const char *MGRS,
+                         long   *Zone,
+                         char   *Hemisphere,
+                         double *Easting,
+                         double *Northing,
+                         double *Latitude,
+                         double *Longitude)
+/*
+ * The function MGRS_To_UTM converts an MGRS coordinate string to UTM
+ * projection coordinates.  The geodetic coordinates of the point, computed
+ * to check that it lies within its latitude band, are returned as well; they
+ * are valid whenever the error code is MGRS_NO_ERROR or MGRS_LAT_WARNING.
+ *
+ *    ctx        : MGRS context                     (input)
+ *    MGRS       : MGRS coordinate string           (input)
+ *    Zone       : UTM zone                         (output)
+ *    Hemisphere : North or South hemisphere        (output)
+ *    Easting    : Easting (X) in meters            (output)
+ *    Northing   : Northing (Y) in meters           (output)
+ *    Latitude   : Latitude in radians              (output)
+ *    Longitude  : Longitude in radians             (output)
+ */
+{ /* BEGIN MGRS_To_UTM */
+  long band_letter;
+  long in_precision;
+  long utm_error_code = MGRS_NO_ERROR;
+  long error_code = MGRS_NO_ERROR;
+
+  error_code = MGRS_String_To_UTM (ctx, MGRS, Zone, Hemisphere, Easting, Northing,
+                                   &band_letter, &in_precision);
+  if (!error_code)
+  { /* check that point is within Zone Letter bounds */
+    utm_error_code = Convert_UTM_To_Geodetic_Ctx(&ctx->utm,*Zone,*Hemisphere,*Easting,*Northing,Latitude,Longitude);
+    error_code = Check_Latitude_Band (utm_error_code, band_letter, in_precision, *Latitude);
+  }
+  return (error_code);
+} /* END MGRS_To_UTM */
+
+
 long Set_MGRS_Parameters (double a,
                           double f,
                           char   *Ellipsoid_Code)
@@ -680,6 +923,32 @@ long Set_MGRS_Parameters (double a,
  */
 { /* Set_MGRS_Parameters  */
 
+  long Error_Code = MGRS_NO_ERROR;
+
+  Error_Code = Set_MGRS_Parameters_Ctx (&MGRS_Default_Context, a, f, Ellipsoid_Code);
+  if (!Error_Code)
+    MGRS_Default_Context_Set = 1;
+  return (Error_Code);
+}  /* Set_MGRS_Parameters  */
+
+
+long Set_MGRS_Parameters_Ctx (MGRS_Context *ctx,
+                              double a,
+                              double f,
+                              const char *Ellipsoid_Code)
+/*
+ * The function Set_MGRS_Parameters_Ctx receives the ellipsoid parameters and
+ * sets the corresponding state variables in ctx, including the UTM and UPS
+ * state used by the conversions. If any errors occur, the error code(s)
+ * are returned by the function, otherwise MGRS_NO_ERROR is returned.
+ *
+ *   ctx              : MGRS context                            (output)
+ *   a                : Semi-major axis of ellipsoid in meters  (input)
+ *   f                : Flattening of ellipsoid                 (input)
+ *   Ellipsoid_Code   : 2-letter code for ellipsoid             (input)
+ */
+{ /* Set_MGRS_Parameters_Ctx  */
+
   double inv_f = 1 / f;
   long Error_Code = MGRS_NO_ERROR;
 
@@ -693,12 +962,22 @@ long Set_MGRS_Parameters (double a,
   }
   if (!Error_Code)
   { /* no errors */
-    MGRS_a = a;
-    MGRS_f = f;
-    strcpy (MGRS_Ellipsoid_Code, Ellipsoid_Code);
+    ctx->a = a;
+    ctx->f = f;
+    if (ctx->Ellipsoid_Code != Ellipsoid_Code)
+      strncpy (ctx->Ellipsoid_Code, Ellipsoid_Code, 2);
+    ctx->Ellipsoid_Code[2] = 0;
+    /* The Clarke and Bessel ellipsoids use the AL letter pattern */
+    if (!strcmp(ctx->Ellipsoid_Code,CLARKE_1866) || !strcmp(ctx->Ellipsoid_Code, CLARKE_1880) ||
+        !strcmp(ctx->Ellipsoid_Code,BESSEL_1841) || !strcmp(ctx->Ellipsoid_Code,BESSEL_1841_NAMIBIA))
+      ctx->AA_Pattern = FALSE;
+    else
+      ctx->AA_Pattern = TRUE;
+    Set_UTM_Parameters_Ctx (&ctx->utm, a, f, 0);
+    Set_UPS_Parameters_Ctx (&ctx->ups, a, f);
   }
   return (Error_Code);
-}  /* Set_MGRS_Parameters  */
+}  /* Set_MGRS_Parameters_Ctx  */
 
 
 void Get_MGRS_Parameters (double *a,
@@ -713,13 +992,32 @@ void Get_MGRS_Parameters (double *a,
  *  Ellipsoid_Code   : 2-letter code for ellipsoid             (output)
  */
 { /* Get_MGRS_Parameters */
-  *a = MGRS_a;
-  *f = MGRS_f;
-  strcpy (Ellipsoid_Code, MGRS_Ellipsoid_Code);
+  Get_MGRS_Parameters_Ctx (&MGRS_Default_Context, a, f, Ellipsoid_Code);
   return;
 } /* Get_MGRS_Parameters */
 
 
+void Get_MGRS_Parameters_Ctx (const MGRS_Context *ctx,
+                              double *a,
+                              double *f,
+                              char* Ellipsoid_Code)
+/*
+ * The function Get_MGRS_Parameters_Ctx returns the ellipsoid parameters
+ * held in ctx.
+ *
+ *  ctx              : MGRS context                            (input)
+ *  a                : Semi-major axis of ellipsoid, in meters (output)
+ *  f                : Flattening of ellipsoid                 (output)
+ *  Ellipsoid_Code   : 2-letter code for ellipsoid             (output)
+ */
+{ /* Get_MGRS_Parameters_Ctx */
+  *a = ctx->a;
+  *f = ctx->f;
+  strcpy (Ellipsoid_Code, ctx->Ellipsoid_Code);
+  return;
+} /* Get_MGRS_Parameters_Ctx */
+
+
 long Convert_Geodetic_To_MGRS (double Latitude,
                                double Longitude,
                                long Precision,
@@ -737,86 +1035,654 @@ long Convert_Geodetic_To_MGRS (double Latitude,
  *
  */
 { /* Convert_Geodetic_To_MGRS */
-  long zone;
-  char hemisphere;
-  double easting;
-  double northing;
-  long temp_error_code = MGRS_NO_ERROR;
+  return Convert_Geodetic_To_MGRS_Ctx (Default_MGRS_Context (), Latitude, Longitude, Precision, MGRS);
+} /* Convert_Geodetic_To_MGRS */
+
+
+static long Check_Geodetic (double Latitude,
+                            double Longitude,
+                            long Precision)
+/*
+ * The function Check_Geodetic checks the range of a geodetic coordinate and
+ * an MGRS precision.  If any errors occur, the error code(s) are returned
+ * by the function, otherwise MGRS_NO_ERROR is returned.
+ *
+ *    Latitude   : Latitude in radians              (input)
+ *    Longitude  : Longitude in radians             (input)
+ *    Precision  : Precision level of MGRS string   (input)
+ */
+{ /* Check_Geodetic */
   long error_code = MGRS_NO_ERROR;
 
-  if ((Latitude < -PI_OVER_2) || (Latitude > PI_OVER_2))
+  if ((Latitude < -PI_OVER_2) || (Latitude > PI_OVER_2) || (Latitude != Latitude))
   { /* Latitude out of range */
     error_code |= MGRS_LAT_ERROR;
   }
-  if ((Longitude < -PI) || (Longitude > (2*PI)))
+  if ((Longitude < -PI) || (Longitude > (2*PI)) || (Longitude != Longitude))
   { /* Longitude out of range */
     error_code |= MGRS_LON_ERROR;
   }
   if ((Precision < 0) || (Precision > MAX_PRECISION))
     error_code |= MGRS_PRECISION_ERROR;
-  if (!error_code)
+  return (error_code);
+} /* Check_Geodetic */
+
+
+static long Geodetic_UTM_To_MGRS (const MGRS_Context *ctx,
+                                  long UTM_Error,
+                                  long Zone,
+                                  char Hemisphere,
+                                  double Latitude,
+                                  double Longitude,
+                                  double Easting,
+                                  double Northing,
+                                  long Precision,
+                                  char *MGRS)
+/*
+ * The function Geodetic_UTM_To_MGRS finishes the conversion of a geodetic
+ * coordinate in the UTM latitude range, given the result of its conversion
+ * to UTM.  The MGRS error code(s) matching UTM_Error, or those of the MGRS
+ * string conversion, are returned by the function.
+ *
+ *    ctx        : MGRS context                     (input)
+ *    UTM_Error  : UTM conversion error code(s)     (input)
+ *    Zone       : UTM zone                         (input)
+ *    Hemisphere : North or South hemisphere        (input)
+ *    Latitude   : Latitude in radians              (input)
+ *    Longitude  : Longitude in radians             (input)
+ *    Easting    : Easting (X) in meters            (input)
+ *    Northing   : Northing (Y) in meters           (input)
+ *    Precision  : Precision level of MGRS string   (input)
+ *    MGRS       : MGRS coordinate string           (output)
+ */
+{ /* Geodetic_UTM_To_MGRS */
+  long error_code = MGRS_NO_ERROR;
+
+  if(!UTM_Error)
+    error_code |= UTM_To_MGRS (ctx, Zone, Hemisphere, Longitude, Latitude, Easting, Northing, Precision, MGRS);
+  else
+  {
+    if(UTM_Error & UTM_LAT_ERROR)
+      error_code |= MGRS_LAT_ERROR;
+    if(UTM_Error & UTM_LON_ERROR)
+      error_code |= MGRS_LON_ERROR;
+    if(UTM_Error & UTM_ZONE_OVERRIDE_ERROR)
+      error_code |= MGRS_ZONE_ERROR;
+    if(UTM_Error & UTM_EASTING_ERROR)
+      error_code |= MGRS_EASTING_ERROR;
+    if(UTM_Error & UTM_NORTHING_ERROR)
+      error_code |= MGRS_NORTHING_ERROR;
+  }
+  return (error_code);
+} /* Geodetic_UTM_To_MGRS */
+
+
+long Convert_Geodetic_To_MGRS_Ctx (const MGRS_Context *ctx,
+                                   double Latitude,
+                                   double Longitude,
+                                   long Precision,
+                                   char* MGRS)
+/*
+ * The function Convert_Geodetic_To_MGRS_Ctx converts Geodetic (latitude and
+ * longitude) coordinates to an MGRS coordinate string, according to the
+ * ellipsoid parameters held in ctx.  If any errors occur, the error code(s)
+ * are returned by the function, otherwise MGRS_NO_ERROR is returned.
+ *
+ *    ctx        : MGRS context                     (input)
+ *    Latitude   : Latitude in radians              (input)
+ *    Longitude  : Longitude in radians             (input)
+ *    Precision  : Precision level of MGRS string   (input)
+ *    MGRS       : MGRS coordinate string           (output)
+ *
+ */
+{ /* Convert_Geodetic_To_MGRS_Ctx */
+  long zone;
+  char hemisphere;
+  double easting;
+  double northing;
+  long temp_error_code = MGRS_NO_ERROR;
+  long error_code = MGRS_NO_ERROR;
+
+  error_code = Check_Geodetic (Latitude, Longitude, Precision);
+  if (!error_code)
   {
     if ((Latitude < MIN_UTM_LAT) || (Latitude > MAX_UTM_LAT))
     {
-      temp_error_code = Set_UPS_Parameters (MGRS_a, MGRS_f);
+      temp_error_code = Convert_Geodetic_To_UPS_Ctx (&ctx->ups, Latitude, Longitude, &hemisphere, &easting, &northing);
       if(!temp_error_code)
       {
-        temp_error_code = Convert_Geodetic_To_UPS (Latitude, Longitude, &hemisphere, &easting, &northing);
-        if(!temp_error_code)
-        {
-          error_code |= Convert_UPS_To_MGRS (hemisphere, easting, northing, Precision, MGRS);
-        }
-        else
-        {
-          if(temp_error_code & UPS_LAT_ERROR)
-            error_code |= MGRS_LAT_ERROR;
-          if(temp_error_code & UPS_LON_ERROR)
-            error_code |= MGRS_LON_ERROR;
-        }
+        error_code |= Convert_UPS_To_MGRS_Ctx (ctx, hemisphere, easting, northing, Precision, MGRS);
       }
       else
       {
-        if(temp_error_code & UPS_A_ERROR)
-          error_code |= MGRS_A_ERROR;
-        if(temp_error_code & UPS_INV_F_ERROR)
-          error_code |= MGRS_INV_F_ERROR;
+        if(temp_error_code & UPS_LAT_ERROR)
+          error_code |= MGRS_LAT_ERROR;
+        if(temp_error_code & UPS_LON_ERROR)
+          error_code |= MGRS_LON_ERROR;
       }
     }
     else
     {
-      temp_error_code = Set_UTM_Parameters (MGRS_a, MGRS_f, 0);
-      if(!temp_error_code)
+      temp_error_code = Convert_Geodetic_To_UTM_Ctx (&ctx->utm, Latitude, Longitude, &zone, &hemisphere, &easting, &northing);
+      error_code |= Geodetic_UTM_To_MGRS (ctx, temp_error_code, zone, hemisphere, Latitude, Longitude,
+                                          easting, northing, Precision, MGRS);
+    }
+  }
+  return (error_code);
+} /* Convert_Geodetic_To_MGRS_Ctx */
+
+
+static unsigned char Geodetic_Batch_Key (double Latitude,
+                                         double Longitude)
+/*
+ * The function Geodetic_Batch_Key returns the batch key (UTM zone and
+ * hemisphere, polar cap, or invalid) of a geodetic coordinate.  It only
+ * groups rows that will use the same projection parameters; the UTM zone
+ * exceptions around Norway and Svalbard are left to the conversion.
+ *
+ *    Latitude   : Latitude in radians              (input)
+ *    Longitude  : Longitude in radians             (input)
+ */
+{ /* Geodetic_Batch_Key */
+  long zone;
+
+  if (!((Latitude >= -PI_OVER_2) && (Latitude <= PI_OVER_2)) ||
+      !((Longitude >= -PI) && (Longitude <= (2*PI))))
+    return (BATCH_KEY_INVALID);
+  if (Latitude < MIN_UTM_LAT)
+    return (BATCH_KEY_SOUTH_POLE);
+  if (Latitude > MAX_UTM_LAT)
+    return (BATCH_KEY_NORTH_POLE);
+  if (Longitude >= PI)
+    Longitude -= 2*PI;
+  zone = (long)((Longitude + PI) * 30.0 / PI);
+  if (zone > 59)
+    zone = 59;
+  return ((unsigned char)(zone * 2 + (Latitude < 0)));
+} /* Geodetic_Batch_Key */
+
+
+static unsigned char MGRS_Batch_Key (const char *MGRS)
+/*
+ * The function MGRS_Batch_Key returns the batch key of an MGRS string from
+ * its grid zone designation (zone digits and first letter).  Strings it
+ * cannot classify get the invalid key; they are still fully parsed (and
+ * rejected or accepted) by the conversion.
+ *
+ *    MGRS       : MGRS coordinate string           (input)
+ */
+{ /* MGRS_Batch_Key */
+  long zone = 0;
+  long digits = 0;
+  char letter;
+
+  while (*MGRS == ' ')
+    MGRS++;
+  while ((digits < 2) && (*MGRS >= '0') && (*MGRS <= '9'))
+  {
+    zone = zone * 10 + (*MGRS++ - '0');
+    digits++;
+  }
+  letter = *MGRS;
+  if ((letter >= 'a') && (letter <= 'z'))
+    letter = letter - 'a' + 'A';
+  if ((letter < 'A') || (letter > 'Z'))
+    return (BATCH_KEY_INVALID);
+  if (!digits)
+  {
+    if ((letter == 'A') || (letter == 'B'))
+      return (BATCH_KEY_SOUTH_POLE);
+    if ((letter == 'Y') || (letter == 'Z'))
+      return (BATCH_KEY_NORTH_POLE);
+    return (BATCH_KEY_INVALID);
+  }
+  if ((zone < 1) || (zone > 60))
+    return (BATCH_KEY_INVALID);
+  return ((unsigned char)((zone - 1) * 2 + (letter < 'N')));
+} /* MGRS_Batch_Key */
+
+
+static size_t *Batch_Order (const unsigned char *Keys,
+                            size_t Count)
+/*
+ * The function Batch_Order returns the row indices 0 to Count - 1 stably
+ * sorted by batch key (a counting sort), so that rows sharing projection
+ * parameters are converted together.  The array is allocated with malloc
+ * and must be freed by the caller; NULL is returned if it cannot be.
+ *
+ *    Keys       : Batch key of each row            (input)
+ *    Count      : Number of rows                   (input)
+ */
+{ /* Batch_Order */
+  size_t start[BATCH_KEYS + 1];
+  size_t *order;
+  size_t i;
+  long k;
+
+  order = (size_t *)malloc (Count * sizeof (size_t));
+  if (!order)
+    return (NULL);
+  for (k = 0; k <= BATCH_KEYS; k++)
+    start[k] = 0;
+  for (i = 0; i < Count; i++)
+    start[Keys[i] + 1]++;
+  for (k = 1; k <= BATCH_KEYS; k++)
+    start[k] += start[k - 1];
+  for (i = 0; i < Count; i++)
+    order[start[Keys[i]]++] = i;
+  return (order);
+} /* Batch_Order */
+
+
+long Convert_Geodetic_To_MGRS_Batch (const double *Latitude,
+                                     const double *Longitude,
+                                     size_t Count,
+                                     const long *Precision,
+                                     size_t Precision_Count,
+                                     char *MGRS,
+                                     long *Error_Codes)
+/*
+ * The function Convert_Geodetic_To_MGRS_Batch converts Count Geodetic
+ * (latitude and longitude) coordinates to MGRS coordinate strings,
+ * according to the current ellipsoid parameters.  The number of
+ * coordinates that could not be converted is returned by the function.
+ *
+ *    Latitude        : Latitudes in radians                      (input)
+ *    Longitude       : Longitudes in radians                     (input)
+ *    Count           : Number of coordinates                     (input)
+ *    Precision       : Precision levels, recycled over the rows  (input)
+ *    Precision_Count : Number of precision levels                (input)
+ *    MGRS            : Count * MGRS_STRING_LENGTH characters     (output)
+ *    Error_Codes     : Error code of each row, or NULL           (output)
+ */
+{ /* Convert_Geodetic_To_MGRS_Batch */
+  return Convert_Geodetic_To_MGRS_Batch_Ctx (Default_MGRS_Context (), Latitude, Longitude, Count,
+                                             Precision, Precision_Count, MGRS, Error_Codes);
+} /* Convert_Geodetic_To_MGRS_Batch */
+
+
+static int Near_Grid_Line (double Easting,
+                           double Northing,
+                           long Precision)
+/*
+ * The function Near_Grid_Line returns nonzero if an easting or northing
+ * from the fast Transverse Mercator kernel is within
+ * TRANMERC_FAST_TOLERANCE meters of a line of the grid at Precision.  The
+ * digits of an MGRS string, its 100,000m letters and every test
+ * UTM_To_MGRS makes on the easting and northing change only across such
+ * lines, so a row that is not near one gets the same string from the fast
+ * and the exact coordinates.
+ *
+ *    Easting    : Easting (X) in meters            (input)
+ *    Northing   : Northing (Y) in meters           (input)
+ *    Precision  : Precision level of MGRS string   (input)
+ */
+{ /* Near_Grid_Line */
+  double cell = Precision_Divisor[Precision];
+  double east = Easting - cell * floor (Easting / cell);
+  double north = Northing - cell * floor (Northing / cell);
+
+  return ((east < TRANMERC_FAST_TOLERANCE) || (east > cell - TRANMERC_FAST_TOLERANCE) ||
+          (north < TRANMERC_FAST_TOLERANCE) || (north > cell - TRANMERC_FAST_TOLERANCE));
+} /* Near_Grid_Line */
+
+
+static long Geodetic_To_MGRS_Rows (const MGRS_Context *ctx,
+                                   const double *Latitude,
+                                   const double *Longitude,
+                                   size_t Count,
+                                   const long *Precision,
+                                   size_t Precision_Count,
+                                   char *MGRS,
+                                   long *Error_Codes,
+                                   int Fast)
+/*
+ * The function Geodetic_To_MGRS_Rows converts Count Geodetic coordinates to
+ * MGRS coordinate strings, BATCH_BLOCK rows at a time.  If Fast is set, rows
+ * at precisions up to FAST_MAX_PRECISION are projected to UTM with the fast
+ * kernel, and those that land near a grid line are projected again
+ * exactly.  The number of coordinates that could not be converted is
+ * returned by the function.
+ *
+ *    ctx             : MGRS context                              (input)
+ *    Latitude        : Latitudes in radians                      (input)
+ *    Longitude       : Longitudes in radians                     (input)
+ *    Count           : Number of coordinates                     (input)
+ *    Precision       : Precision levels, recycled over the rows  (input)
+ *    Precision_Count : Number of precision levels                (input)
+ *    MGRS            : Count * MGRS_STRING_LENGTH characters     (output)
+ *    Error_Codes     : Error code of each row, or NULL           (output)
+ *    Fast            : Nonzero for the fast UTM kernel           (input)
+ */
+{ /* Geodetic_To_MGRS_Rows */
+  unsigned char *keys = NULL;
+  size_t *order = NULL;
+  size_t rows[BATCH_BLOCK];
+  size_t slots[BATCH_BLOCK];
+  long codes[BATCH_BLOCK];
+  double utm_lat[BATCH_BLOCK];
+  double utm_lon[BATCH_BLOCK];
+  long utm_zone[BATCH_BLOCK];
+  char utm_hemisphere[BATCH_BLOCK];
+  double utm_east[BATCH_BLOCK];
+  double utm_north[BATCH_BLOCK];
+  long utm_codes[BATCH_BLOCK];
+  size_t fast_count;
+  size_t exact_count;
+  size_t start;
+  size_t n;
+  size_t i;
+  size_t k;
+  size_t u;
+  char *row;
+  long precision;
+  long error_code;
+  long error_count = 0;
+
+  if (Count >= BATCH_SORT_MIN_COUNT)
+  { /* convert zone by zone, then each result lands in its own row */
+    keys = (unsigned char *)malloc (Count);
+    if (keys)
+    {
+      for (i = 0; i < Count; i++)
+        keys[i] = Geodetic_Batch_Key (Latitude[i], Longitude[i]);
+      order = Batch_Order (keys, Count);
+      free (keys);
+    }
+  }
+
+  for (start = 0; start < Count; start += n)
+  {
+    n = Count - start;
+    if (n > BATCH_BLOCK)
+      n = BATCH_BLOCK;
+    /* rows in the UTM latitude range are projected together first, those
+       for the fast kernel from the front of the arrays, the rest from the
+       back */
+    fast_count = 0;
+    exact_count = 0;
+    for (k = 0; k < n; k++)
+    {
+      i = order ? order[start + k] : start + k;
+      rows[k] = i;
+      error_code = MGRS_NO_ERROR;
+      /* missing values (NaN) fail every range check, so catch them here */
+      if (Latitude[i] != Latitude[i])
+        error_code |= MGRS_LAT_ERROR;
+      if (Longitude[i] != Longitude[i])
+        error_code |= MGRS_LON_ERROR;
+      if (!Precision_Count)
+        error_code |= MGRS_PRECISION_ERROR;
+      if (!error_code)
+        error_code = Check_Geodetic (Latitude[i], Longitude[i], Precision[i % Precision_Count]);
+      if (!error_code && (Latitude[i] >= MIN_UTM_LAT) && (Latitude[i] <= MAX_UTM_LAT))
       {
-        temp_error_code = Convert_Geodetic_To_UTM (Latitude, Longitude, &zone, &hemisphere, &easting, &northing);
-        if(!temp_error_code)
-          error_code |= UTM_To_MGRS (zone, hemisphere, Longitude, Latitude, easting, northing, Precision, MGRS);
+        if (Fast && (Precision[i % Precision_Count] <= FAST_MAX_PRECISION))
+          u = fast_count++;
         else
+          u = BATCH_BLOCK - ++exact_count;
+        utm_lat[u] = Latitude[i];
+        utm_lon[u] = Longitude[i];
+        slots[k] = u;
+      }
+      codes[k] = error_code;
+    }
+    Convert_Geodetic_To_UTM_Fast_Batch_Ctx (&ctx->utm, utm_lat, utm_lon, fast_count, utm_zone,
+                                            utm_hemisphere, utm_east, utm_north, utm_codes);
+    u = BATCH_BLOCK - exact_count;
+    Convert_Geodetic_To_UTM_Batch_Ctx (&ctx->utm, utm_lat + u, utm_lon + u, exact_count,
+                                       utm_zone + u, utm_hemisphere + u, utm_east + u,
+                                       utm_north + u, utm_codes + u);
+    for (k = 0; k < n; k++)
+    {
+      i = rows[k];
+      row = MGRS + i * MGRS_STRING_LENGTH;
+      error_code = codes[k];
+      if (!error_code)
+      {
+        if ((Latitude[i] >= MIN_UTM_LAT) && (Latitude[i] <= MAX_UTM_LAT))
         {
-          if(temp_error_code & UTM_LAT_ERROR)
-            error_code |= MGRS_LAT_ERROR;
-          if(temp_error_code & UTM_LON_ERROR)
-            error_code |= MGRS_LON_ERROR;
-          if(temp_error_code & UTM_ZONE_OVERRIDE_ERROR)
-            error_code |= MGRS_ZONE_ERROR;
-          if(temp_error_code & UTM_EASTING_ERROR)
-            error_code |= MGRS_EASTING_ERROR;
-          if(temp_error_code & UTM_NORTHING_ERROR)
-            error_code |= MGRS_NORTHING_ERROR;
+          u = slots[k];
+          precision = Precision[i % Precision_Count];
+          if ((u < fast_count)
+              && !(utm_codes[u] & ~(UTM_EASTING_ERROR | UTM_NORTHING_ERROR))
+              && Near_Grid_Line (utm_east[u], utm_north[u], precision))
+            utm_codes[u] = Convert_Geodetic_To_UTM_Ctx (&ctx->utm, Latitude[i], Longitude[i],
+                                                        &utm_zone[u], &utm_hemisphere[u],
+                                                        &utm_east[u], &utm_north[u]);
+          error_code = Geodetic_UTM_To_MGRS (ctx, utm_codes[u], utm_zone[u], utm_hemisphere[u],
+                                             Latitude[i], Longitude[i], utm_east[u], utm_north[u],
+                                             precision, row);
         }
+        else
+          error_code = Convert_Geodetic_To_MGRS_Ctx (ctx, Latitude[i], Longitude[i],
+                                                     Precision[i % Precision_Count], row);
       }
-      else
+      if (error_code)
       {
-        if(temp_error_code & UTM_A_ERROR)
-          error_code |= MGRS_A_ERROR;
-        if(temp_error_code & UTM_INV_F_ERROR)
-          error_code |= MGRS_INV_F_ERROR;
-        if(temp_error_code & UTM_ZONE_OVERRIDE_ERROR)
-          error_code |= MGRS_ZONE_ERROR;
+        row[0] = '\0';
+        error_count++;
       }
+      if (Error_Codes)
+        Error_Codes[i] = error_code;
     }
   }
-  return (error_code);
-} /* Convert_Geodetic_To_MGRS */
+  free (order);
+  return (error_count);
+} /* Geodetic_To_MGRS_Rows */
+
+
+long Convert_Geodetic_To_MGRS_Batch_Ctx (const MGRS_Context *ctx,
+                                         const double *Latitude,
+                                         const double *Longitude,
+                                         size_t Count,
+                                         const long *Precision,
+                                         size_t Precision_Count,
+                                         char *MGRS,
+                                         long *Error_Codes)
+/*
+ * The function Convert_Geodetic_To_MGRS_Batch_Ctx converts Count Geodetic
+ * (latitude and longitude) coordinates to MGRS coordinate strings,
+ * according to the ellipsoid parameters held in ctx.  The number of
+ * coordinates that could not be converted is returned by the function.
+ *
+ *    ctx             : MGRS context                              (input)
+ *    Latitude        : Latitudes in radians                      (input)
+ *    Longitude       : Longitudes in radians                     (input)
+ *    Count           : Number of coordinates                     (input)
+ *    Precision       : Precision levels, recycled over the rows  (input)
+ *    Precision_Count : Number of precision levels                (input)
+ *    MGRS            : Count * MGRS_STRING_LENGTH characters     (output)
+ *    Error_Codes     : Error code of each row, or NULL           (output)
+ */
+{ /* Convert_Geodetic_To_MGRS_Batch_Ctx */
+  return Geodetic_To_MGRS_Rows (ctx, Latitude, Longitude, Count, Precision, Precision_Count,
+                                MGRS, Error_Codes, 0);
+} /* Convert_Geodetic_To_MGRS_Batch_Ctx */
+
+
+long Convert_Geodetic_To_MGRS_Fast_Batch (const double *Latitude,
+                                          const double *Longitude,
+                                          size_t Count,
+                                          const long *Precision,
+                                          size_t Precision_Count,
+                                          char *MGRS,
+                                          long *Error_Codes)
+/*
+ * The function Convert_Geodetic_To_MGRS_Fast_Batch converts Count Geodetic
+ * coordinates to MGRS coordinate strings according to the current
+ * ellipsoid parameters.  See Convert_Geodetic_To_MGRS_Fast_Batch_Ctx.
+ */
+{ /* Convert_Geodetic_To_MGRS_Fast_Batch */
+  return Convert_Geodetic_To_MGRS_Fast_Batch_Ctx (Default_MGRS_Context (), Latitude, Longitude,
+                                                  Count, Precision, Precision_Count, MGRS,
+                                                  Error_Codes);
+} /* Convert_Geodetic_To_MGRS_Fast_Batch */
+
+
+long Convert_Geodetic_To_MGRS_Fast_Batch_Ctx (const MGRS_Context *ctx,
+                                              const double *Latitude,
+                                              const double *Longitude,
+                                              size_t Count,
+                                              const long *Precision,
+                                              size_t Precision_Count,
+                                              char *MGRS,
+                                              long *Error_Codes)
+/*
+ * The function Convert_Geodetic_To_MGRS_Fast_Batch_Ctx is
+ * Convert_Geodetic_To_MGRS_Batch_Ctx with rows at precisions up to 3
+ * (100m) projected by the single precision Transverse Mercator kernel.
+ * Rows within TRANMERC_FAST_TOLERANCE meters of a grid line are projected
+ * again in double precision, so every string and error code is the one
+ * Convert_Geodetic_To_MGRS_Batch_Ctx returns.
+ *
+ *    ctx             : MGRS context                              (input)
+ *    Latitude        : Latitudes in radians                      (input)
+ *    Longitude       : Longitudes in radians                     (input)
+ *    Count           : Number of coordinates                     (input)
+ *    Precision       : Precision levels, recycled over the rows  (input)
+ *    Precision_Count : Number of precision levels                (input)
+ *    MGRS            : Count * MGRS_STRING_LENGTH characters     (output)
+ *    Error_Codes     : Error code of each row, or NULL           (output)
+ */
+{ /* Convert_Geodetic_To_MGRS_Fast_Batch_Ctx */
+  return Geodetic_To_MGRS_Rows (ctx, Latitude, Longitude, Count, Precision, Precision_Count,
+                                MGRS, Error_Codes, 1);
+} /* Convert_Geodetic_To_MGRS_Fast_Batch_Ctx */
+
+
+long Convert_MGRS_To_Geodetic_Batch (const char *const *MGRS,
+                                     size_t Count,
+                                     double *Latitude,
+                                     double *Longitude,
+                                     long *Error_Codes)
+/*
+ * The function Convert_MGRS_To_Geodetic_Batch converts Count MGRS
+ * coordinate strings to Geodetic (latitude and longitude) coordinates,
+ * according to the current ellipsoid parameters.  The number of strings
+ * that could not be converted is returned by the function.
+ *
+ *    MGRS            : MGRS coordinate strings                   (input)
+ *    Count           : Number of strings                         (input)
+ *    Latitude        : Latitudes in radians                      (output)
+ *    Longitude       : Longitudes in radians                     (output)
+ *    Error_Codes     : Error code of each row, or NULL           (output)
+ */
+{ /* Convert_MGRS_To_Geodetic_Batch */
+  return Convert_MGRS_To_Geodetic_Batch_Ctx (Default_MGRS_Context (), MGRS, Count, Latitude,
+                                             Longitude, Error_Codes);
+} /* Convert_MGRS_To_Geodetic_Batch */
+
+
+long Convert_MGRS_To_Geodetic_Batch_Ctx (const MGRS_Context *ctx,
+                                         const char *const *MGRS,
+                                         size_t Count,
+                                         double *Latitude,
+                                         double *Longitude,
+                                         long *Error_Codes)
+/*
+ * The function Convert_MGRS_To_Geodetic_Batch_Ctx converts Count MGRS
+ * coordinate strings to Geodetic (latitude and longitude) coordinates,
+ * according to the ellipsoid parameters held in ctx.  Latitude and
+ * Longitude are not set for rows that fail.  The number of strings that
+ * could not be converted (including MGRS_LAT_WARNING rows) is returned by
+ * the function.
+ *
+ *    ctx             : MGRS context                              (input)
+ *    MGRS            : MGRS coordinate strings                   (input)
+ *    Count           : Number of strings                         (input)
+ *    Latitude        : Latitudes in radians                      (output)
+ *    Longitude       : Longitudes in radians                     (output)
+ *    Error_Codes     : Error code of each row, or NULL           (output)
+ */
+{ /* Convert_MGRS_To_Geodetic_Batch_Ctx */
+  unsigned char *keys = NULL;
+  size_t *order = NULL;
+  size_t rows[BATCH_BLOCK];
+  long codes[BATCH_BLOCK];
+  long utm_zone[BATCH_BLOCK];
+  char utm_hemisphere[BATCH_BLOCK];
+  double utm_east[BATCH_BLOCK];
+  double utm_north[BATCH_BLOCK];
+  long band_letter[BATCH_BLOCK];
+  long in_precision[BATCH_BLOCK];
+  double utm_lat[BATCH_BLOCK];
+  double utm_lon[BATCH_BLOCK];
+  long utm_codes[BATCH_BLOCK];
+  size_t utm_count;
+  size_t start;
+  size_t n;
+  size_t i;
+  size_t k;
+  size_t u;
+  long zone_exists;
+  long error_code;
+  long error_count = 0;
+
+  if (Count >= BATCH_SORT_MIN_COUNT)
+  { /* convert zone by zone, then each result lands in its own row */
+    keys = (unsigned char *)malloc (Count);
+    if (keys)
+    {
+      for (i = 0; i < Count; i++)
+        keys[i] = MGRS_Batch_Key (MGRS[i]);
+      order = Batch_Order (keys, Count);
+      free (keys);
+    }
+  }
+
+  for (start = 0; start < Count; start += n)
+  {
+    n = Count - start;
+    if (n > BATCH_BLOCK)
+      n = BATCH_BLOCK;
+    /* strings with a UTM zone are parsed first and unprojected together */
+    utm_count = 0;
+    for (k = 0; k < n; k++)
+    {
+      i = order ? order[start + k] : start + k;
+      rows[k] = i;
+      error_code = Check_Zone (MGRS[i], &zone_exists);
+      if (!error_code && zone_exists)
+      {
+        error_code = MGRS_String_To_UTM (ctx, MGRS[i], &utm_zone[utm_count],
+                                         &utm_hemisphere[utm_count], &utm_east[utm_count],
+                                         &utm_north[utm_count], &band_letter[utm_count],
+                                         &in_precision[utm_count]);
+        if (!error_code)
+          utm_count++;
+      }
+      else if (!error_code)
+        error_code = MGRS_STRING_ERROR; /* UPS strings are converted one by one */
+      codes[k] = error_code;
+    }
+    Convert_UTM_To_Geodetic_Batch_Ctx (&ctx->utm, utm_zone, utm_hemisphere, utm_east, utm_north,
+                                       utm_count, utm_lat, utm_lon, utm_codes);
+    u = 0;
+    for (k = 0; k < n; k++)
+    {
+      i = rows[k];
+      if (!codes[k])
+      {
+        error_code = Check_Latitude_Band (utm_codes[u], band_letter[u], in_precision[u], utm_lat[u]);
+        if (!error_code || (error_code & MGRS_LAT_WARNING))
+        {
+          Latitude[i] = utm_lat[u];
+          Longitude[i] = utm_lon[u];
+        }
+        u++;
+      }
+      else
+        error_code = Convert_MGRS_To_Geodetic_Ctx (ctx, MGRS[i], &Latitude[i], &Longitude[i]);
+      if (error_code)
+        error_count++;
+      if (Error_Codes)
+        Error_Codes[i] = error_code;
+    }
+  }
+  free (order);
+  return (error_count);
+} /* Convert_MGRS_To_Geodetic_Batch_Ctx */
 
 
 long Convert_MGRS_To_Geodetic (char* MGRS,
@@ -835,10 +1701,34 @@ long Convert_MGRS_To_Geodetic (char* MGRS,
  *
  */
 { /* Convert_MGRS_To_Geodetic */
+  return Convert_MGRS_To_Geodetic_Ctx (Default_MGRS_Context (), MGRS, Latitude, Longitude);
+} /* END OF Convert_MGRS_To_Geodetic */
+
+
+long Convert_MGRS_To_Geodetic_Ctx (const MGRS_Context *ctx,
+                                   const char* MGRS,
+                                   double *Latitude,
+                                   double *Longitude)
+/*
+ * The function Convert_MGRS_To_Geodetic_Ctx converts an MGRS coordinate
+ * string to Geodetic (latitude and longitude) coordinates
+ * according to the ellipsoid parameters held in ctx.  If any errors occur,
+ * the error code(s) are returned by the function, otherwise UTM_NO_ERROR
+ * is returned.
+ *
+ *    ctx        : MGRS context                     (input)
+ *    MGRS       : MGRS coordinate string           (input)
+ *    Latitude   : Latitude in radians              (output)
+ *    Longitude  : Longitude in radians             (output)
+ *
+ */
+{ /* Convert_MGRS_To_Geodetic_Ctx */
   long zone;
   char hemisphere;
   double easting;
   double northing;
+  double latitude;
+  double longitude;
   long zone_exists;
   long temp_error_code = MGRS_NO_ERROR;
   long error_code = MGRS_NO_ERROR;
@@ -848,65 +1738,34 @@ long Convert_MGRS_To_Geodetic (char* MGRS,
   {
     if (zone_exists)
     {
-      error_code |= Convert_MGRS_To_UTM (MGRS, &zone, &hemisphere, &easting, &northing);
+      /* The inverse projection done for the latitude band check is the answer */
+      error_code |= MGRS_To_UTM (ctx, MGRS, &zone, &hemisphere, &easting, &northing, &latitude, &longitude);
       if(!error_code || (error_code & MGRS_LAT_WARNING))
       {
-        temp_error_code = Set_UTM_Parameters (MGRS_a, MGRS_f, 0);
-        if(!temp_error_code)
-        {
-          temp_error_code = Convert_UTM_To_Geodetic (zone, hemisphere, easting, northing, Latitude, Longitude);
-          if(temp_error_code)
-          {
-            if((temp_error_code & UTM_ZONE_ERROR) || (temp_error_code & UTM_HEMISPHERE_ERROR))
-              error_code |= MGRS_STRING_ERROR;
-            if(temp_error_code & UTM_EASTING_ERROR)
-              error_code |= MGRS_EASTING_ERROR;
-            if(temp_error_code & UTM_NORTHING_ERROR)
-              error_code |= MGRS_NORTHING_ERROR;
-          }
-        }
-        else
-        {
-          if(temp_error_code & UTM_A_ERROR)
-            error_code |= MGRS_A_ERROR;
-          if(temp_error_code & UTM_INV_F_ERROR)
-            error_code |= MGRS_INV_F_ERROR;
-          if(temp_error_code & UTM_ZONE_OVERRIDE_ERROR)
-            error_code |= MGRS_ZONE_ERROR;
-        }
+        *Latitude = latitude;
+        *Longitude = longitude;
       }
     }
     else
     {
-      error_code |= Convert_MGRS_To_UPS (MGRS, &hemisphere, &easting, &northing);
+      error_code |= Convert_MGRS_To_UPS_Ctx (ctx, MGRS, &hemisphere, &easting, &northing);
       if(!error_code)
       {
-        temp_error_code = Set_UPS_Parameters (MGRS_a, MGRS_f);
-        if(!temp_error_code)
-        {
-          temp_error_code = Convert_UPS_To_Geodetic (hemisphere, easting, northing, Latitude, Longitude);
-          if(temp_error_code)
-          {
-            if(temp_error_code & UPS_HEMISPHERE_ERROR)
-              error_code |= MGRS_STRING_ERROR;
-            if(temp_error_code & UPS_EASTING_ERROR)
-              error_code |= MGRS_EASTING_ERROR;
-            if(temp_error_code & UPS_LAT_ERROR)
-              error_code |= MGRS_NORTHING_ERROR;
-          }
-        }
-        else
+        temp_error_code = Convert_UPS_To_Geodetic_Ctx (&ctx->ups, hemisphere, easting, northing, Latitude, Longitude);
+        if(temp_error_code)
         {
-          if(temp_error_code & UPS_A_ERROR)
-            error_code |= MGRS_A_ERROR;
-          if(temp_error_code & UPS_INV_F_ERROR)
-            error_code |= MGRS_INV_F_ERROR;
+          if(temp_error_code & UPS_HEMISPHERE_ERROR)
+            error_code |= MGRS_STRING_ERROR;
+          if(temp_error_code & UPS_EASTING_ERROR)
+            error_code |= MGRS_EASTING_ERROR;
+          if(temp_error_code & UPS_LAT_ERROR)
+            error_code |= MGRS_NORTHING_ERROR;
         }
       }
     }
   }
   return (error_code);
-} /* END OF Convert_MGRS_To_Geodetic */
+} /* END OF Convert_MGRS_To_Geodetic_Ctx */
 
 
 long Convert_UTM_To_MGRS (long Zone,
@@ -929,6 +1788,32 @@ long Convert_UTM_To_MGRS (long Zone,
  *    MGRS       : MGRS coordinate string           (output)
  */
 { /* Convert_UTM_To_MGRS */
+  return Convert_UTM_To_MGRS_Ctx (Default_MGRS_Context (), Zone, Hemisphere, Easting, Northing, Precision, MGRS);
+} /* Convert_UTM_To_MGRS */
+
+
+long Convert_UTM_To_MGRS_Ctx (const MGRS_Context *ctx,
+                              long Zone,
+                              char Hemisphere,
+                              double Easting,
+                              double Northing,
+                              long Precision,
+                              char* MGRS)
+/*
+ * The function Convert_UTM_To_MGRS_Ctx converts UTM (zone, easting, and
+ * northing) coordinates to an MGRS coordinate string, according to the
+ * ellipsoid parameters held in ctx.  If any errors occur, the error code(s)
+ * are returned by the function, otherwise MGRS_NO_ERROR is returned.
+ *
+ *    ctx        : MGRS context                     (input)
+ *    Zone       : UTM zone                         (input)
+ *    Hemisphere : North or South hemisphere        (input)
+ *    Easting    : Easting (X) in meters            (input)
+ *    Northing   : Northing (Y) in meters           (input)
+ *    Precision  : Precision level of MGRS string   (input)
+ *    MGRS       : MGRS coordinate string           (output)
+ */
+{ /* Convert_UTM_To_MGRS_Ctx */
   double latitude;           /* Latitude of UTM point */
   double longitude;          /* Longitude of UTM point */
   long utm_error_code = MGRS_NO_ERROR;
@@ -938,16 +1823,16 @@ long Convert_UTM_To_MGRS (long Zone,
     error_code |= MGRS_ZONE_ERROR;
   if ((Hemisphere != 'S') && (Hemisphere != 'N'))
     error_code |= MGRS_HEMISPHERE_ERROR;
-  if ((Easting < MIN_EASTING) || (Easting > MAX_EASTING))
+  /* missing values (NaN) fail no comparison, so check them as well */
+  if ((Easting < MIN_EASTING) || (Easting > MAX_EASTING) || (Easting != Easting))
     error_code |= MGRS_EASTING_ERROR;
-  if ((Northing < MIN_NORTHING) || (Northing > MAX_NORTHING))
+  if ((Northing < MIN_NORTHING) || (Northing > MAX_NORTHING) || (Northing != Northing))
     error_code |= MGRS_NORTHING_ERROR;
   if ((Precision < 0) || (Precision > MAX_PRECISION))
     error_code |= MGRS_PRECISION_ERROR;
   if (!error_code)
   {
-    Set_UTM_Parameters (MGRS_a, MGRS_f, 0);
-    utm_error_code = Convert_UTM_To_Geodetic (Zone, Hemisphere, Easting, Northing, &latitude, &longitude);
+    utm_error_code = Convert_UTM_To_Geodetic_Ctx (&ctx->utm, Zone, Hemisphere, Easting, Northing, &latitude, &longitude);
     if(utm_error_code)
     {
       if((utm_error_code & UTM_ZONE_ERROR) || (utm_error_code & UTM_HEMISPHERE_ERROR))
@@ -958,10 +1843,10 @@ long Convert_UTM_To_MGRS (long Zone,
         error_code |= MGRS_NORTHING_ERROR;
     }
 
-	  error_code = UTM_To_MGRS (Zone, Hemisphere, longitude, latitude, Easting, Northing, Precision, MGRS);
+	  error_code = UTM_To_MGRS (ctx, Zone, Hemisphere, longitude, latitude, Easting, Northing, Precision, MGRS);
   }
   return (error_code);
-} /* Convert_UTM_To_MGRS */
+} /* Convert_UTM_To_MGRS_Ctx */
 
 
 long Convert_MGRS_To_UTM (char   *MGRS,
@@ -983,119 +1868,36 @@ long Convert_MGRS_To_UTM (char   *MGRS,
  *    Northing   : Northing (Y) in meters           (output)
  */
 { /* Convert_MGRS_To_UTM */
-  double min_northing;
-  double northing_offset;
-  long ltr2_low_value;
-  long ltr2_high_value;
-  double pattern_offset;
-  double upper_lat_limit;     /* North latitude limits based on 1st letter  */
-  double lower_lat_limit;     /* South latitude limits based on 1st letter  */
-  double grid_easting;        /* Easting for 100,000 meter grid square      */
-  double grid_northing;       /* Northing for 100,000 meter grid square     */
-  long letters[MGRS_LETTERS];
-  long in_precision;
-  double latitude = 0.0;
-  double longitude = 0.0;
-  double divisor = 1.0;
-  long utm_error_code = MGRS_NO_ERROR;
-  long error_code = MGRS_NO_ERROR;
-
-  error_code = Break_MGRS_String (MGRS, Zone, letters, Easting, Northing, &in_precision);
-  if (!*Zone)
-    error_code |= MGRS_STRING_ERROR;
-  else
-  {
-    if (!error_code)
-    {
-      if ((letters[0] == LETTER_X) && ((*Zone == 32) || (*Zone == 34) || (*Zone == 36)))
-        error_code |= MGRS_STRING_ERROR;
-      else
-      {
-        if (letters[0] < LETTER_N)
-          *Hemisphere = 'S';
-        else
-          *Hemisphere = 'N';
-
-        Get_Grid_Values(*Zone, &ltr2_low_value, &ltr2_high_value, &pattern_offset);
-
-        /* Check that the second letter of the MGRS string is within
-         * the range of valid second letter values
-         * Also check that the third letter is valid */
-        if ((letters[1] < ltr2_low_value) || (letters[1] > ltr2_high_value) || (letters[2] > LETTER_V))
-          error_code |= MGRS_STRING_ERROR;
-
-        if (!error_code)
-        {
-          double row_letter_northing = (double)(letters[2]) * ONEHT;
-          grid_easting = (double)((letters[1]) - ltr2_low_value + 1) * ONEHT;
-          if ((ltr2_low_value == LETTER_J) && (letters[1] > LETTER_O))
-            grid_easting = grid_easting - ONEHT;
-
-          if (letters[2] > LETTER_O)
-            row_letter_northing = row_letter_northing - ONEHT;
-
-          if (letters[2] > LETTER_I)
-            row_letter_northing = row_letter_northing - ONEHT;
-
-          if (row_letter_northing >= TWOMIL)
-            row_letter_northing = row_letter_northing - TWOMIL;
-
-          error_code = Get_Latitude_Band_Min_Northing(letters[0], &min_northing, &northing_offset);
-          if (!error_code)
-          {
-            grid_northing = row_letter_northing - pattern_offset;
-            if(grid_northing < 0)
-              grid_northing += TWOMIL;
-
-            grid_northing += northing_offset;
+  return Convert_MGRS_To_UTM_Ctx (Default_MGRS_Context (), MGRS, Zone, Hemisphere, Easting, Northing);
+} /* Convert_MGRS_To_UTM */
 
-            if(grid_northing < min_northing)
-              grid_northing += TWOMIL;
 
-            *Easting = grid_easting + *Easting;
-            *Northing = grid_northing + *Northing;
+long Convert_MGRS_To_UTM_Ctx (const MGRS_Context *ctx,
+                              const char *MGRS,
+                              long   *Zone,
+                              char   *Hemisphere,
+                              double *Easting,
+                              double *Northing)
+/*
+ * The function Convert_MGRS_To_UTM_Ctx converts an MGRS coordinate string
+ * to UTM projection (zone, hemisphere, easting and northing) coordinates
+ * according to the ellipsoid parameters held in ctx.  If any errors occur,
+ * the error code(s) are returned by the function, otherwise UTM_NO_ERROR
+ * is returned.
+ *
+ *    ctx        : MGRS context                     (input)
+ *    MGRS       : MGRS coordinate string           (input)
+ *    Zone       : UTM zone                         (output)
+ *    Hemisphere : North or South hemisphere        (output)
+ *    Easting    : Easting (X) in meters            (output)
+ *    Northing   : Northing (Y) in meters           (output)
+ */
+{ /* Convert_MGRS_To_UTM_Ctx */
+  double latitude;
+  double longitude;
 
-            /* check that point is within Zone Letter bounds */
-            utm_error_code = Set_UTM_Parameters(MGRS_a,MGRS_f,0);
-            if (!utm_error_code)
-            {
-              utm_error_code = Convert_UTM_To_Geodetic(*Zone,*Hemisphere,*Easting,*Northing,&latitude,&longitude);
-              if (!utm_error_code)
-              {
-                divisor = pow (10.0, in_precision);
-                error_code = Get_Latitude_Range(letters[0], &upper_lat_limit, &lower_lat_limit);
-                if (!error_code)
-                {
-                  if (!(((lower_lat_limit - DEG_TO_RAD/divisor) <= latitude) && (latitude <= (upper_lat_limit + DEG_TO_RAD/divisor))))
-                    error_code |= MGRS_LAT_WARNING;
-                }
-              }
-              else
-              {
-                if((utm_error_code & UTM_ZONE_ERROR) || (utm_error_code & UTM_HEMISPHERE_ERROR))
-                  error_code |= MGRS_STRING_ERROR;
-                if(utm_error_code & UTM_EASTING_ERROR)
-                  error_code |= MGRS_EASTING_ERROR;
-                if(utm_error_code & UTM_NORTHING_ERROR)
-                  error_code |= MGRS_NORTHING_ERROR;
-              }
-            }
-            else
-            {
-              if(utm_error_code & UTM_A_ERROR)
-                error_code |= MGRS_A_ERROR;
-              if(utm_error_code & UTM_INV_F_ERROR)
-                error_code |= MGRS_INV_F_ERROR;
-              if(utm_error_code & UTM_ZONE_OVERRIDE_ERROR)
-                error_code |= MGRS_ZONE_ERROR;
-            }
-          }
-        }
-      }
-    }
-  }
-  return (error_code);
-} /* Convert_MGRS_To_UTM */
+  return MGRS_To_UTM (ctx, MGRS, Zone, Hemisphere, Easting, Northing, &latitude, &longitude);
+} /* Convert_MGRS_To_UTM_Ctx */
 
 
 long Convert_UPS_To_MGRS (char   Hemisphere,
@@ -1117,6 +1919,31 @@ long Convert_UPS_To_MGRS (char   Hemisphere,
  *    MGRS          : MGRS coordinate string           (output)
  */
 { /* Convert_UPS_To_MGRS */
+  return Convert_UPS_To_MGRS_Ctx (Default_MGRS_Context (), Hemisphere, Easting, Northing, Precision, MGRS);
+} /* Convert_UPS_To_MGRS */
+
+
+long Convert_UPS_To_MGRS_Ctx (const MGRS_Context *ctx,
+                              char   Hemisphere,
+                              double Easting,
+                              double Northing,
+                              long   Precision,
+                              char*  MGRS)
+/*
+ *  The function Convert_UPS_To_MGRS_Ctx converts UPS (hemisphere, easting,
+ *  and northing) coordinates to an MGRS coordinate string according to
+ *  the ellipsoid parameters held in ctx.  If any errors occur, the error
+ *  code(s) are returned by the function, otherwise UPS_NO_ERROR is
+ *  returned.
+ *
+ *    ctx           : MGRS context                     (input)
+ *    Hemisphere    : Hemisphere either 'N' or 'S'     (input)
+ *    Easting       : Easting/X in meters              (input)
+ *    Northing      : Northing/Y in meters             (input)
+ *    Precision     : Precision level of MGRS string   (input)
+ *    MGRS          : MGRS coordinate string           (output)
+ */
+{ /* Convert_UPS_To_MGRS_Ctx */
   double false_easting;       /* False easting for 2nd letter                 */
   double false_northing;      /* False northing for 3rd letter                */
   double grid_easting;        /* Easting used to derive 2nd letter of MGRS    */
@@ -1126,11 +1953,13 @@ long Convert_UPS_To_MGRS (char   Hemisphere,
   int index = 0;
   long error_code = MGRS_NO_ERROR;
 
+  (void)ctx;  /* the UPS grid letters do not depend on the ellipsoid */
+
   if ((Hemisphere != 'N') && (Hemisphere != 'S'))
     error_code |= MGRS_HEMISPHERE_ERROR;
-  if ((Easting < MIN_EAST_NORTH) || (Easting > MAX_EAST_NORTH))
+  if ((Easting < MIN_EAST_NORTH) || (Easting > MAX_EAST_NORTH) || (Easting != Easting))
     error_code |= MGRS_EASTING_ERROR;
-  if ((Northing < MIN_EAST_NORTH) || (Northing > MAX_EAST_NORTH))
+  if ((Northing < MIN_EAST_NORTH) || (Northing > MAX_EAST_NORTH) || (Northing != Northing))
     error_code |= MGRS_NORTHING_ERROR;
   if ((Precision < 0) || (Precision > MAX_PRECISION))
     error_code |= MGRS_PRECISION_ERROR;
@@ -1198,7 +2027,7 @@ long Convert_UPS_To_MGRS (char   Hemisphere,
     Make_MGRS_String (MGRS, 0, letters, Easting, Northing, Precision);
   }
   return (error_code);
-} /* Convert_UPS_To_MGRS */
+} /* Convert_UPS_To_MGRS_Ctx */
 
 
 long Convert_MGRS_To_UPS ( char   *MGRS,
@@ -1217,6 +2046,28 @@ long Convert_MGRS_To_UPS ( char   *MGRS,
  *    Northing      : Northing/Y in meters             (output)
  */
 { /* Convert_MGRS_To_UPS */
+  return Convert_MGRS_To_UPS_Ctx (Default_MGRS_Context (), MGRS, Hemisphere, Easting, Northing);
+} /* Convert_MGRS_To_UPS */
+
+
+long Convert_MGRS_To_UPS_Ctx ( const MGRS_Context *ctx,
+                               const char *MGRS,
+                               char   *Hemisphere,
+                               double *Easting,
+                               double *Northing)
+/*
+ *  The function Convert_MGRS_To_UPS_Ctx converts an MGRS coordinate string
+ *  to UPS (hemisphere, easting, and northing) coordinates, according
+ *  to the ellipsoid parameters held in ctx. If any errors occur, the error
+ *  code(s) are returned by the function, otherwide UPS_NO_ERROR is returned.
+ *
+ *    ctx           : MGRS context                     (input)
+ *    MGRS          : MGRS coordinate string           (input)
+ *    Hemisphere    : Hemisphere either 'N' or 'S'     (output)
+ *    Easting       : Easting/X in meters              (output)
+ *    Northing      : Northing/Y in meters             (output)
+ */
+{ /* Convert_MGRS_To_UPS_Ctx */
   long ltr2_high_value;       /* 2nd letter range - high number             */
   long ltr3_high_value;       /* 3rd letter range - high number (UPS)       */
   long ltr2_low_value;        /* 2nd letter range - low number              */
@@ -1230,6 +2081,8 @@ long Convert_MGRS_To_UPS ( char   *MGRS,
   int index = 0;
   long error_code = MGRS_NO_ERROR;
 
+  (void)ctx;  /* the UPS grid letters do not depend on the ellipsoid */
+
   error_code = Break_MGRS_String (MGRS, &zone, letters, Easting, Northing, &in_precision);
   if (zone)
     error_code |= MGRS_STRING_ERROR;
@@ -1305,5 +2158,5 @@ long Convert_MGRS_To_UPS ( char   *MGRS,
     }
   }
   return (error_code);
-} /* Convert_MGRS_To_UPS */
+} /* Convert_MGRS_To_UPS_Ctx */
 
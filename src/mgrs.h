@@ -14,6 +14,30 @@
 #define MGRS_HEMISPHERE_ERROR        0x0200
 #define MGRS_LAT_WARNING             0x0400
 
+#define MGRS_STRING_LENGTH           16  /* Longest MGRS string, with NUL */
+
+#include <stddef.h>
+#include "ups.h"
+#include "utm.h"
+
+/*
+ * An MGRS_Context holds the ellipsoid state (and the UTM and UPS state
+ * derived from it) that the non-reentrant functions keep in file-scope
+ * variables.  A context must be set with Set_MGRS_Parameters_Ctx before
+ * use; after that it is only read, so one context may be shared by any
+ * number of concurrent conversions.
+ */
+typedef struct MGRS_Context_Value
+{
+  double a;                  /* Semi-major axis of ellipsoid in meters */
+  double f;                  /* Flattening of ellipsoid                */
+  char   Ellipsoid_Code[3];  /* 2-letter code for ellipsoid            */
+  long   AA_Pattern;         /* 100,000m letters follow the AA pattern  */
+                             /* (FALSE for the AL pattern ellipsoids)   */
+  UTM_Context utm;           /* UTM state for the ellipsoid            */
+  UPS_Context ups;           /* UPS state for the ellipsoid            */
+} MGRS_Context;
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -30,6 +54,58 @@ long Convert_UPS_To_MGRS (char Hemisphere, double Easting, double Northing, long
                           char *MGRS);
 long Convert_MGRS_To_UPS (char *MGRS, char *Hemisphere, double *Easting, double *Northing);
 
+/* Reentrant forms of the functions above */
+long Set_MGRS_Parameters_Ctx(MGRS_Context *ctx, double a, double f, const char *Ellipsoid_Code);
+void Get_MGRS_Parameters_Ctx(const MGRS_Context *ctx, double *a, double *f, char *Ellipsoid_Code);
+long Convert_Geodetic_To_MGRS_Ctx (const MGRS_Context *ctx, double Latitude, double Longitude,
+                                   long Precision, char *MGRS);
+long Convert_MGRS_To_Geodetic_Ctx (const MGRS_Context *ctx, const char *MGRS, double *Latitude,
+                                   double *Longitude);
+long Convert_UTM_To_MGRS_Ctx (const MGRS_Context *ctx, long Zone, char Hemisphere, double Easting,
+                              double Northing, long Precision, char *MGRS);
+long Convert_MGRS_To_UTM_Ctx (const MGRS_Context *ctx, const char *MGRS, long *Zone,
+                              char *Hemisphere, double *Easting, double *Northing);
+long Convert_UPS_To_MGRS_Ctx (const MGRS_Context *ctx, char Hemisphere, double Easting,
+                              double Northing, long Precision, char *MGRS);
+long Convert_MGRS_To_UPS_Ctx (const MGRS_Context *ctx, const char *MGRS, char *Hemisphere,
+                              double *Easting, double *Northing);
+
+/*
+ * Batch forms.  Row i of an MGRS output is written to
+ * MGRS + i * MGRS_STRING_LENGTH (an empty string for rows that fail) and
+ * Precision is recycled over the rows.  The error code of row i is stored in
+ * Error_Codes[i] when Error_Codes is not NULL, and the number of rows that
+ * failed is returned.  Long batches are converted grouped by UTM zone and
+ * hemisphere; results are the same as converting the rows one by one.
+ */
+long Convert_Geodetic_To_MGRS_Batch (const double *Latitude, const double *Longitude, size_t Count,
+                                     const long *Precision, size_t Precision_Count, char *MGRS,
+                                     long *Error_Codes);
+long Convert_Geodetic_To_MGRS_Batch_Ctx (const MGRS_Context *ctx, const double *Latitude,
+                                         const double *Longitude, size_t Count,
+                                         const long *Precision, size_t Precision_Count,
+                                         char *MGRS, long *Error_Codes);
+
+/*
+ * Fast forms of the geodetic batch conversion.  Rows at precisions up to 3
+ * (100m) are projected to UTM mostly in single precision, and those that
+ * land within TRANMERC_FAST_TOLERANCE meters of a grid line are projected
+ * again exactly, so the strings and error codes are the same as above.
+ */
+long Convert_Geodetic_To_MGRS_Fast_Batch (const double *Latitude, const double *Longitude,
+                                          size_t Count, const long *Precision,
+                                          size_t Precision_Count, char *MGRS, long *Error_Codes);
+long Convert_Geodetic_To_MGRS_Fast_Batch_Ctx (const MGRS_Context *ctx, const double *Latitude,
+                                              const double *Longitude, size_t Count,
+                                              const long *Precision, size_t Precision_Count,
+                                              char *MGRS, long *Error_Codes);
+
+long Convert_MGRS_To_Geodetic_Batch (const char *const *MGRS, size_t Count, double *Latitude,
+                                     double *Longitude, long *Error_Codes);
+long Convert_MGRS_To_Geodetic_Batch_Ctx (const MGRS_Context *ctx, const char *const *MGRS,
+                                         size_t Count, double *Latitude, double *Longitude,
+                                         long *Error_Codes);
+
 #ifdef __cplusplus
 }
 #endif
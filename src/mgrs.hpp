@@ -0,0 +1,1219 @@
+#ifndef MGRS_HPP
+#define MGRS_HPP
+
+// Header-only C++17 interface to the converters, for applications whose
+// inner loops should inline the projection instead of calling into the
+// library for every point. Every function is noexcept and returns a result
+// struct whose `error` member is the bitmask the matching C function
+// returns (TRANMERC_*, UTM_*, UPS_* or MGRS_*_ERROR), and each has a batch
+// overload over spans that fills one result per row and returns the number
+// of rows with errors.
+//
+// The C sources remain the reference. The Transverse Mercator series (both
+// engines), UTM zone selection and the MGRS letters and strings of the UTM
+// zones are repeated here operation for operation, so each result is
+// exactly that of the C function; polar (UPS) rows call the C functions.
+// Exact agreement assumes, as the C library does, that multiplies and adds
+// are not fused (-ffp-contract=off when compiling for FMA targets).
+//
+// Contexts are the C structs, set up by the C functions
+// (Set_MGRS_Parameters_Ctx(), Set_UTM_Engine_Ctx() or the mgrs_batch.h
+// converter handle) and only read here, so they may be shared by threads.
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+#include "tranmerc.h"
+#include "ups.h"
+#include "utm.h"
+#include "mgrs.h"
+
+#if defined(__GNUC__)
+  #define MGRS_HPP_INLINE inline __attribute__((always_inline))
+#else
+  #define MGRS_HPP_INLINE inline
+#endif
+
+namespace mgrs {
+
+struct tm_result {
+  double easting;
+  double northing;
+  long error;
+};
+
+struct utm_result {
+  long zone;
+  char hemisphere;
+  double easting;
+  double northing;
+  long error;
+};
+
+struct ups_result {
+  char hemisphere;
+  double easting;
+  double northing;
+  long error;
+};
+
+struct geodetic_result {
+  double latitude;
+  double longitude;
+  long error;
+};
+
+// An MGRS string, empty when error has an error bit
+struct mgrs_result {
+  char mgrs[MGRS_STRING_LENGTH];
+  long error;
+};
+
+// A view of count contiguous values, like C++20's std::span, which (as
+// well as std::vector, std::array and plain arrays) converts to one
+template < typename T >
+class span {
+public:
+  constexpr span() noexcept : data_(nullptr), size_(0) {}
+  constexpr span(T *data, std::size_t size) noexcept : data_(data), size_(size) {}
+
+  template < std::size_t N >
+  constexpr span(T (&array)[N]) noexcept : data_(array), size_(N) {}
+
+  template < typename Container, typename = typename std::enable_if <
+    std::is_convertible < decltype(std::declval < Container & >().data()), T * >::value >::type >
+  constexpr span(Container &container) noexcept :
+    data_(container.data()), size_(container.size()) {}
+
+  template < typename U, typename = typename std::enable_if <
+    std::is_convertible < U *, T * >::value >::type >
+  constexpr span(const span < U > &other) noexcept : data_(other.data()), size_(other.size()) {}
+
+  constexpr T *data() const noexcept { return(data_); }
+  constexpr std::size_t size() const noexcept { return(size_); }
+  constexpr bool empty() const noexcept { return(size_ == 0); }
+  constexpr T &operator[](std::size_t i) const noexcept { return(data_[i]); }
+  constexpr T *begin() const noexcept { return(data_); }
+  constexpr T *end() const noexcept { return(data_ + size_); }
+
+private:
+  T *data_;
+  std::size_t size_;
+};
+
+namespace detail {
+
+// Constants of tranmerc.c, utm.c and mgrs.c, spelled the same way so that
+// they round the same way
+constexpr double pi = 3.14159265358979323e0;
+constexpr double pi_over_2 = (pi / 2.0e0);
+constexpr double tm_max_lat = ((pi * 89.99) / 180.0);
+constexpr double tm_max_delta_long = ((pi * 90) / 180.0);
+constexpr double two_over_pi = 6.36619772367581382433e-01;
+constexpr double pio2_1 = 1.57079632673412561417e+00;
+constexpr double pio2_1t = 6.07710050650619224932e-11;
+constexpr double round_magic = 6755399441055744.0;
+constexpr std::uint64_t round_bits = UINT64_C(0x4338000000000000);
+constexpr double pi_hi = 3.14159265358979311600e+00;
+constexpr double pi_lo = 1.22464679914735317720e-16;
+constexpr double pio2_hi = 1.57079632679489655800e+00;
+constexpr double pio2_lo = 6.12323399573676603587e-17;
+constexpr double pio4_hi = 7.85398163397448278999e-01;
+constexpr double pio4_lo = 3.06161699786838301793e-17;
+constexpr double tan_pi_8 = 4.14213562373095048802e-01;
+constexpr double tan_3pi_8 = 2.41421356237309504880e+00;
+constexpr double inv_ln2 = 1.44269504088896338700e+00;
+constexpr double ln2_hi = 6.93147180369123816490e-01;
+constexpr double ln2_lo = 1.90821492927058770002e-10;
+
+constexpr double utm_min_lat = ((-80.5 * pi) / 180.0);
+constexpr double utm_max_lat = ((84.5 * pi) / 180.0);
+constexpr double utm_min_easting = 100000;
+constexpr double utm_max_easting = 900000;
+constexpr double utm_min_northing = 0;
+constexpr double utm_max_northing = 10000000;
+
+constexpr double deg_to_rad = 0.017453292519943295;
+constexpr double rad_to_deg = 57.29577951308232087;
+constexpr double oneht = 100000.e0;
+constexpr double twomil = 2000000.e0;
+constexpr long max_precision = 5;
+constexpr double mgrs_min_utm_lat = ((-80 * pi) / 180.0);
+constexpr double mgrs_max_utm_lat = ((84 * pi) / 180.0);
+
+// Letters as alphabet indexes, as in mgrs.c
+enum { A, B, C, D, E, F, G, H, I, J, K, L, M, N, O, P, Q, R, S, T, U, V, W, X, Y, Z };
+
+struct latitude_band {
+  signed char letter;     // latitude band letter
+  double min_northing;    // minimum northing of the band
+  double north;           // upper latitude of the band, in degrees
+  double south;           // lower latitude of the band, in degrees
+  double northing_offset; // northing offset of the band
+};
+
+inline constexpr latitude_band latitude_bands[20] = {
+  { C, 1100000.0, -72.0, -80.5, 0.0 },
+  { D, 2000000.0, -64.0, -72.0, 2000000.0 },
+  { E, 2800000.0, -56.0, -64.0, 2000000.0 },
+  { F, 3700000.0, -48.0, -56.0, 2000000.0 },
+  { G, 4600000.0, -40.0, -48.0, 4000000.0 },
+  { H, 5500000.0, -32.0, -40.0, 4000000.0 },
+  { J, 6400000.0, -24.0, -32.0, 6000000.0 },
+  { K, 7300000.0, -16.0, -24.0, 6000000.0 },
+  { L, 8200000.0, -8.0, -16.0, 8000000.0 },
+  { M, 9100000.0, 0.0, -8.0, 8000000.0 },
+  { N, 0.0, 8.0, 0.0, 0.0 },
+  { P, 800000.0, 16.0, 8.0, 0.0 },
+  { Q, 1700000.0, 24.0, 16.0, 0.0 },
+  { R, 2600000.0, 32.0, 24.0, 2000000.0 },
+  { S, 3500000.0, 40.0, 32.0, 2000000.0 },
+  { T, 4400000.0, 48.0, 40.0, 4000000.0 },
+  { U, 5300000.0, 56.0, 48.0, 4000000.0 },
+  { V, 6200000.0, 64.0, 56.0, 6000000.0 },
+  { W, 7000000.0, 72.0, 64.0, 6000000.0 },
+  { X, 7900000.0, 84.5, 72.0, 6000000.0 }
+};
+
+// Column letter of the squares easting 100,000m - 900,000m, by zone set
+inline constexpr signed char column_letters[3][8] = {
+  { A, B, C, D, E, F, G, H },
+  { J, K, L, M, N, P, Q, R },
+  { S, T, U, V, W, X, Y, Z }
+};
+
+// Row letter of the squares 0m - 2,000,000m north of row letter A
+inline constexpr signed char row_letters[20] = {
+  A, B, C, D, E, F, G, H, J, K, L, M, N, P, Q, R, S, T, U, V
+};
+
+// False northing of row letter A, by pattern (AA, AL) and set parity (odd, even)
+inline constexpr double pattern_offsets[2][2] = {
+  { 0.0, 500000.0 },
+  { 1000000.0, 1500000.0 }
+};
+
+// The inverses of the letter tables, -1 for letters that are not used:
+// latitude band of each letter, easting in 100,000m of each column letter
+// by set, and northing in 100,000m (modulo 2,000,000m) of each row letter
+// by pattern and set parity
+struct letter_tables {
+  signed char band[26];
+  signed char column[3][26];
+  signed char row[2][2][26];
+};
+
+constexpr letter_tables make_letter_tables() {
+  letter_tables t{};
+  for (int l=0; l<26; l++) {
+    t.band[l] = -1;
+    for (int s=0; s<3; s++) t.column[s][l] = -1;
+    for (int p=0; p<2; p++) t.row[p][0][l] = t.row[p][1][l] = -1;
+  }
+  for (int b=0; b<20; b++) t.band[latitude_bands[b].letter] = (signed char)b;
+  for (int s=0; s<3; s++) {
+    for (int c=0; c<8; c++) t.column[s][column_letters[s][c]] = (signed char)(c + 1);
+  }
+  for (int p=0; p<2; p++) {
+    for (int q=0; q<2; q++) {
+      const int offset = (int)(pattern_offsets[p][q] / oneht);
+      for (int r=0; r<20; r++) t.row[p][q][row_letters[r]] = (signed char)((r + 20 - offset) % 20);
+    }
+  }
+  return(t);
+}
+
+inline constexpr letter_tables letter_index = make_letter_tables();
+
+static_assert(letter_index.row[1][1][A] == 5, "AL pattern, even set: row A is 500,000m north");
+static_assert(letter_index.column[1][P] == 6, "set 2: column P is the sixth");
+
+// Math kernels of tranmerc.c (see there)
+
+MGRS_HPP_INLINE std::uint64_t double_bits(double x) noexcept {
+  std::uint64_t bits;
+  std::memcpy(&bits, &x, sizeof(bits));
+  return(bits);
+}
+
+MGRS_HPP_INLINE double bits_double(std::uint64_t bits) noexcept {
+  double x;
+  std::memcpy(&x, &bits, sizeof(x));
+  return(x);
+}
+
+MGRS_HPP_INLINE double sphtmd(const Transverse_Mercator_Context &ctx, double lat,
+                              double sin_lat, double cos_lat) noexcept {
+  double y = 2.e0 * (cos_lat * cos_lat - sin_lat * sin_lat);
+  double b4 = ctx.ep;
+  double b3 = y * b4 - ctx.dp;
+  double b2 = y * b3 - b4 + ctx.cp;
+  double b1 = y * b2 - b3 - ctx.bp;
+  return(ctx.ap * lat + b1 * 2.e0 * sin_lat * cos_lat);
+}
+
+MGRS_HPP_INLINE void sin_cos(double angle, double &sin_angle, double &cos_angle) noexcept {
+  double q = (angle * two_over_pi + round_magic) - round_magic;
+  double m = q - 4.e0 * ((q * 0.25e0 + round_magic) - round_magic);
+  double x = (angle - q * pio2_1) - q * pio2_1t;
+  double z = x * x;
+  bool odd = (std::fabs(m) == 1.e0);
+  double s = x + z * x * (-1.66666666666666324348e-01 + z * (8.33333333332248946124e-03
+             + z * (-1.98412698298579493134e-04 + z * (2.75573137070700676789e-06
+             + z * (-2.50507602534068634195e-08 + z * 1.58969099521155010221e-10)))));
+  double hz = 0.5e0 * z;
+  double w = 1.e0 - hz;
+  double c = w + (((1.e0 - w) - hz) + z * z * (4.16666666666666019037e-02
+             + z * (-1.38888888888741095749e-03 + z * (2.48015872894767294178e-05
+             + z * (-2.75573143513906633035e-07 + z * (2.08757232129817482790e-09
+             + z * -1.13596475577881948265e-11))))));
+  w = odd ? c : s;
+  c = odd ? s : c;
+  sin_angle = ((m < 0.e0) || (m > 1.5e0)) ? -w : w;
+  cos_angle = ((m > 0.5e0) || (m < -1.5e0)) ? -c : c;
+}
+
+MGRS_HPP_INLINE double atan(double x) noexcept {
+  bool big = (x > tan_3pi_8);
+  bool mid = (x > tan_pi_8);
+  double y = big ? -1.e0 / x : (mid ? (x - 1.e0) / (x + 1.e0) : x);
+  double hi = big ? pio2_hi : (mid ? pio4_hi : 0.e0);
+  double lo = big ? pio2_lo : (mid ? pio4_lo : 0.e0);
+  double z = y * y;
+  double w = z * z;
+  double s1 = z * (3.33333333333329318027e-01 + w * (1.42857142725034663711e-01
+              + w * (9.09088713343650656196e-02 + w * (6.66107313738753120669e-02
+              + w * (4.97687799461593236017e-02 + w * 1.62858201153657823623e-02)))));
+  double s2 = w * (-1.99999999998764832476e-01 + w * (-1.11111104054623557880e-01
+              + w * (-7.69187620504482999495e-02 + w * (-5.83357013379057348645e-02
+              + w * -3.65315727442169155270e-02))));
+  return(hi - ((y * (s1 + s2) - lo) - y));
+}
+
+MGRS_HPP_INLINE double atan2(double y, double x) noexcept {
+  double ay = std::fabs(y);
+  double ax = std::fabs(x);
+  double angle = detail::atan((ay > ax) ? ax / ay : ay / ax);
+  angle = (ay > ax) ? (pio2_hi - angle) + pio2_lo : angle;
+  angle = (x < 0.e0) ? (pi_hi - angle) + pi_lo : angle;
+  return(std::copysign(angle, y));
+}
+
+MGRS_HPP_INLINE double exp(double x) noexcept {
+  double q = x * inv_ln2 + round_magic;
+  double k = q - round_magic;
+  double r = (x - k * ln2_hi) - k * ln2_lo;
+  double p = 1.e0 + r * (1.e0 + r * (0.5e0 + r * (1.66666666666666667e-01
+             + r * (4.16666666666666667e-02 + r * (8.33333333333333333e-03
+             + r * (1.38888888888888889e-03 + r * (1.98412698412698413e-04
+             + r * (2.48015873015873016e-05 + r * (2.75573192239858907e-06
+             + r * (2.75573192239858907e-07 + r * (2.50521083854417188e-08
+             + r * (2.08767569878680990e-09 + r * 1.60590438368216146e-10))))))))))));
+  return(bits_double(double_bits(p) + ((double_bits(q) - round_bits) << 52)));
+}
+
+MGRS_HPP_INLINE double log(double x) noexcept {
+  std::uint64_t b = double_bits(x) + (UINT64_C(0x3ff0000000000000) - UINT64_C(0x3fe6a09e667f3bcd));
+  double k = bits_double(round_bits + ((b >> 52) - 1023)) - round_magic;
+  double f = bits_double((b & UINT64_C(0x000fffffffffffff)) + UINT64_C(0x3fe6a09e667f3bcd)) - 1.e0;
+  double hfsq = 0.5e0 * f * f;
+  double s = f / (2.e0 + f);
+  double z = s * s;
+  double w = z * z;
+  double r = z * (6.666666666666735130e-01 + w * (2.857142874366239149e-01
+             + w * (1.818357216161805012e-01 + w * 1.479819860511658591e-01)))
+             + w * (3.999999999940941908e-01 + w * (2.222219843214978396e-01
+             + w * 1.531383769920937332e-01));
+  return(k * ln2_hi - ((hfsq - (s * (hfsq + r) + k * ln2_lo)) - f));
+}
+
+MGRS_HPP_INLINE double sqrt(double x) noexcept {
+  double r = bits_double(UINT64_C(0x5fe6eb50c7b537a9) - (double_bits(x) >> 1));
+  double h = 0.5e0 * x;
+  r = r * (1.5e0 - h * r * r);
+  r = r * (1.5e0 - h * r * r);
+  r = r * (1.5e0 - h * r * r);
+  r = r * (1.5e0 - h * r * r);
+  double y = x * r;
+  return(y + 0.5e0 * r * (x - y * y));
+}
+
+MGRS_HPP_INLINE double pow_e(const Transverse_Mercator_Context &ctx, double sin_lat) noexcept {
+  double x = ctx.e * sin_lat;
+  double x2 = x * x;
+  double y = -ctx.e * x * (1.e0 + x2 * (3.33333333333333333e-01 + x2 * (2.0e-01
+             + x2 * (1.42857142857142857e-01 + x2 * (1.11111111111111111e-01
+             + x2 * (9.09090909090909091e-02 + x2 * (7.69230769230769231e-02
+             + x2 * 6.66666666666666667e-02)))))));
+  return(1.e0 + y * (1.e0 + y * (0.5e0 + y * (1.66666666666666667e-01
+         + y * (4.16666666666666667e-02 + y * (8.33333333333333333e-03
+         + y * 1.38888888888888889e-03))))));
+}
+
+MGRS_HPP_INLINE void clenshaw_step(double coeff, double ar, double ai,
+                                   double &yr, double &yi, double &zr, double &zi) noexcept {
+  double r = ar * yr - ai * yi - zr + coeff;
+  double i = ar * yi + ai * yr - zi;
+  zr = yr;
+  zi = yi;
+  yr = r;
+  yi = i;
+}
+
+MGRS_HPP_INLINE void kruger_sum(const double *coeff, double sin_2x, double cos_2x,
+                                double sinh_2y, double cosh_2y, double &re, double &im) noexcept {
+  double ar = 2.e0 * cos_2x * cosh_2y;
+  double ai = -2.e0 * sin_2x * sinh_2y;
+  double sr = sin_2x * cosh_2y;
+  double si = cos_2x * sinh_2y;
+  double yr = 0.e0, yi = 0.e0, zr = 0.e0, zi = 0.e0;
+  for (int j=5; j>=0; j--) clenshaw_step(coeff[j], ar, ai, yr, yi, zr, zi);
+  re = yr * sr - yi * si;
+  im = yr * si + yi * sr;
+}
+
+MGRS_HPP_INLINE double inv_radical(double x) noexcept {
+  return(1.e0 + x * (0.5e0 + x * (0.375e0 + x * (0.3125e0
+         + x * (0.2734375e0 + x * (0.24609375e0 + x * (0.2255859375e0
+         + x * (0.20947265625e0 + x * 0.196380615234375e0))))))));
+}
+
+// Check_Geodetic of tranmerc.c: the error code(s), and the longitude less
+// the central meridian in dlam when the point can be projected
+MGRS_HPP_INLINE long tm_check_geodetic(const Transverse_Mercator_Context &ctx,
+                                       double lat, double lon, double &dlam) noexcept {
+  long error = TRANMERC_NO_ERROR;
+
+  if ((lat < -tm_max_lat) || (lat > tm_max_lat)) error |= TRANMERC_LAT_ERROR;
+  if (lon > pi) lon -= (2 * pi);
+  if ((lon < (ctx.Origin_Long - tm_max_delta_long)) || (lon > (ctx.Origin_Long + tm_max_delta_long))) {
+    double temp_long = (lon < 0) ? lon + 2 * pi : lon;
+    double temp_origin = (ctx.Origin_Long < 0) ? ctx.Origin_Long + 2 * pi : ctx.Origin_Long;
+    if ((temp_long < (temp_origin - tm_max_delta_long)) || (temp_long > (temp_origin + tm_max_delta_long))) {
+      error |= TRANMERC_LON_ERROR;
+    }
+  }
+  if (!error) {
+    dlam = lon - ctx.Origin_Long;
+    if (std::fabs(dlam) > (9.0 * pi / 180)) error |= TRANMERC_LON_WARNING;
+    if (dlam > pi) dlam -= (2 * pi);
+    if (dlam < -pi) dlam += (2 * pi);
+    if (std::fabs(dlam) < 2.e-10) dlam = 0.0;
+  }
+  return(error);
+}
+
+MGRS_HPP_INLINE void project_point(const Transverse_Mercator_Context &ctx, double lat,
+                                   double dlam, double &easting, double &northing) noexcept {
+  double s, c;
+  sin_cos(lat, s, c);
+  double c2 = c * c;
+  double c3 = c2 * c;
+  double c5 = c3 * c2;
+  double c7 = c5 * c2;
+  double t = s / c;
+  double tan2 = t * t;
+  double tan3 = tan2 * t;
+  double tan4 = tan3 * t;
+  double tan5 = tan4 * t;
+  double tan6 = tan5 * t;
+  double eta = ctx.ebs * c2;
+  double eta2 = eta * eta;
+  double eta3 = eta2 * eta;
+  double eta4 = eta3 * eta;
+  double sn = ctx.a * inv_radical(ctx.es * s * s);
+  double tmd = sphtmd(ctx, lat, s, c);
+  double tmdo = ctx.Origin_Tmd;
+
+  double t1 = (tmd - tmdo) * ctx.Scale_Factor;
+  double t2 = sn * s * c * ctx.Scale_Factor / 2.e0;
+  double t3 = sn * s * c3 * ctx.Scale_Factor * (5.e0 - tan2 + 9.e0 * eta
+                                                + 4.e0 * eta2) / 24.e0;
+  double t4 = sn * s * c5 * ctx.Scale_Factor * (61.e0 - 58.e0 * tan2
+                                                + tan4 + 270.e0 * eta - 330.e0 * tan2 * eta + 445.e0 * eta2
+                                                + 324.e0 * eta3 - 680.e0 * tan2 * eta2 + 88.e0 * eta4
+                                                - 600.e0 * tan2 * eta3 - 192.e0 * tan2 * eta4) / 720.e0;
+  double t5 = sn * s * c7 * ctx.Scale_Factor * (1385.e0 - 3111.e0 *
+                                                tan2 + 543.e0 * tan4 - tan6) / 40320.e0;
+  double dlam2 = dlam * dlam;
+  northing = ctx.False_Northing + t1
+             + dlam2 * (t2 + dlam2 * (t3 + dlam2 * (t4 + dlam2 * t5)));
+
+  double t6 = sn * c * ctx.Scale_Factor;
+  double t7 = sn * c3 * ctx.Scale_Factor * (1.e0 - tan2 + eta) / 6.e0;
+  double t8 = sn * c5 * ctx.Scale_Factor * (5.e0 - 18.e0 * tan2 + tan4
+                                            + 14.e0 * eta - 58.e0 * tan2 * eta + 13.e0 * eta2 + 4.e0 * eta3
+                                            - 64.e0 * tan2 * eta2 - 24.e0 * tan2 * eta3) / 120.e0;
+  double t9 = sn * c7 * ctx.Scale_Factor * (61.e0 - 479.e0 * tan2
+                                            + 179.e0 * tan4 - tan6) / 5040.e0;
+  easting = ctx.False_Easting
+            + dlam * (t6 + dlam2 * (t7 + dlam2 * (t8 + dlam2 * t9)));
+}
+
+MGRS_HPP_INLINE long tm_check_projected(const Transverse_Mercator_Context &ctx,
+                                        double easting, double northing) noexcept {
+  long error = TRANMERC_NO_ERROR;
+  if ((easting < (ctx.False_Easting - ctx.Delta_Easting)) ||
+      (easting > (ctx.False_Easting + ctx.Delta_Easting))) {
+    error |= TRANMERC_EASTING_ERROR;
+  }
+  if ((northing < (ctx.False_Northing - ctx.Delta_Northing)) ||
+      (northing > (ctx.False_Northing + ctx.Delta_Northing))) {
+    error |= TRANMERC_NORTHING_ERROR;
+  }
+  return(error);
+}
+
+MGRS_HPP_INLINE double footpoint_step(const Transverse_Mercator_Context &ctx,
+                                      double tmd, double ftphi) noexcept {
+  double s, c;
+  sin_cos(ftphi, s, c);
+  double x = ctx.es * s * s;
+  double isr = (1.e0 - x) * (1.e0 - x) * inv_radical(x) * ctx.Inv_Equator_Sr;
+  return(ftphi + (tmd - sphtmd(ctx, ftphi, s, c)) * isr);
+}
+
+MGRS_HPP_INLINE void unproject_point(const Transverse_Mercator_Context &ctx, double easting,
+                                     double northing, double &lat, double &dlam,
+                                     double &cos_lat) noexcept {
+  const double *d = ctx.Inv_Denom;
+  double tmd = ctx.Origin_Tmd + (northing - ctx.False_Northing) * d[4];
+  double ftphi = tmd * ctx.Inv_Equator_Sr;
+  for (int i=0; i<5; i++) ftphi = footpoint_step(ctx, tmd, ftphi);
+
+  double s, c;
+  sin_cos(ftphi, s, c);
+  double x = ctx.es * s * s;
+  double r = inv_radical(x);
+  double isr = (1.e0 - x) * (1.e0 - x) * r * ctx.Inv_Equator_Sr;
+  double isn = (1.e0 - x) * r * ctx.Inv_a;
+  double isn3 = isn * isn * isn;
+  double isn5 = isn3 * isn * isn;
+  double isn7 = isn5 * isn * isn;
+
+  double sec = 1.e0 / c;
+  double t = s * sec;
+  double tan2 = t * t;
+  double tan4 = tan2 * tan2;
+  double tan6 = tan4 * tan2;
+  double eta = ctx.ebs * c * c;
+  double eta2 = eta * eta;
+  double eta3 = eta2 * eta;
+  double eta4 = eta3 * eta;
+  double de = easting - ctx.False_Easting;
+  de = (std::fabs(de) < 0.0001) ? 0.0 : de;
+  double de2 = de * de;
+
+  double t10 = t * isr * isn * d[0];
+  double t11 = t * (5.e0 + 3.e0 * tan2 + eta - 4.e0 * eta2
+                    - 9.e0 * tan2 * eta) * isr * isn3 * d[1];
+  double t12 = t * (61.e0 + 90.e0 * tan2 + 46.e0 * eta + 45.E0 * tan4
+                    - 252.e0 * tan2 * eta - 3.e0 * eta2 + 100.e0
+                    * eta3 - 66.e0 * tan2 * eta2 - 90.e0 * tan4
+                    * eta + 88.e0 * eta4 + 225.e0 * tan4 * eta2
+                    + 84.e0 * tan2 * eta3 - 192.e0 * tan2 * eta4)
+               * isr * isn5 * d[2];
+  double t13 = t * (1385.e0 + 3633.e0 * tan2 + 4095.e0 * tan4 + 1575.e0
+                    * tan6) * isr * isn7 * d[3];
+  lat = ftphi - de2 * (t10 - de2 * (t11 - de2 * (t12 - de2 * t13)));
+
+  double t14 = isn * sec * d[4];
+  double t15 = (1.e0 + 2.e0 * tan2 + eta) * isn3 * sec * d[5];
+  double t16 = (5.e0 + 6.e0 * eta + 28.e0 * tan2 - 3.e0 * eta2
+                + 8.e0 * tan2 * eta + 24.e0 * tan4 - 4.e0
+                * eta3 + 4.e0 * tan2 * eta2 + 24.e0
+                * tan2 * eta3) * isn5 * sec * d[6];
+  double t17 = (61.e0 + 662.e0 * tan2 + 1320.e0 * tan4 + 720.e0
+                * tan6) * isn7 * sec * d[7];
+  dlam = de * (t14 - de2 * (t15 - de2 * (t16 - de2 * t17)));
+
+  sin_cos(lat, s, cos_lat);
+}
+
+MGRS_HPP_INLINE long finish_geodetic(const Transverse_Mercator_Context &ctx, double lat,
+                                     double dlam, double cos_lat, geodetic_result &out) noexcept {
+  long error = TRANMERC_NO_ERROR;
+
+  out.latitude = lat;
+  out.longitude = ctx.Origin_Long + dlam;
+  if (std::fabs(out.latitude) > (90.0 * pi / 180.0)) error |= TRANMERC_NORTHING_ERROR;
+  if (out.longitude > pi) {
+    out.longitude -= (2 * pi);
+    if (std::fabs(out.longitude) > pi) error |= TRANMERC_EASTING_ERROR;
+  } else if (out.longitude < -pi) {
+    out.longitude += (2 * pi);
+    if (std::fabs(out.longitude) > pi) error |= TRANMERC_EASTING_ERROR;
+  }
+  if (std::fabs(dlam) > (9.0 * pi / 180) * cos_lat) error |= TRANMERC_LON_WARNING;
+  return(error);
+}
+
+MGRS_HPP_INLINE void kruger_project_point(const Transverse_Mercator_Context &ctx, double lat,
+                                          double dlam, double &easting, double &northing) noexcept {
+  double s, c, sl, cl, re, im;
+  sin_cos(lat, s, c);
+  sin_cos(dlam, sl, cl);
+  double w = (1.e0 + s) * pow_e(ctx, s);
+  double h = w * w + c * c;
+  double p = w * w - c * c;
+  double u = 2.e0 * c * w * cl;
+  double v = 2.e0 * c * w * sl;
+  double iq = 1.e0 / (p * p + u * u);
+  kruger_sum(ctx.Alpha, 2.e0 * p * u * iq, (u * u - p * p) * iq,
+             2.e0 * v * h * iq, (h * h + v * v) * iq, re, im);
+  double xi = detail::atan2(p, u) + re;
+  double eta = 0.5e0 * detail::log((h + v) * (h + v) * iq) + im;
+  easting = ctx.False_Easting + ctx.Kr_Radius * eta;
+  northing = ctx.False_Northing + ctx.Kr_Radius * (xi - ctx.Kr_Origin);
+}
+
+MGRS_HPP_INLINE void kruger_unproject_point(const Transverse_Mercator_Context &ctx,
+                                            double easting, double northing, double &lat,
+                                            double &dlam, double &cos_lat) noexcept {
+  double s, c, re, im;
+  double xi = (northing - ctx.False_Northing) * ctx.Kr_Inv_Radius + ctx.Kr_Origin;
+  double eta = (easting - ctx.False_Easting) * ctx.Kr_Inv_Radius;
+
+  sin_cos(2.e0 * xi, s, c);
+  double ex = detail::exp(2.e0 * eta);
+  kruger_sum(ctx.Beta, s, c, 0.5e0 * (ex - 1.e0 / ex), 0.5e0 * (ex + 1.e0 / ex), re, im);
+  xi -= re;
+  eta -= im;
+
+  sin_cos(xi, s, c);
+  ex = detail::exp(eta);
+  double sh = 0.5e0 * (ex - 1.e0 / ex);
+  double ch = 0.5e0 * (ex + 1.e0 / ex);
+  double hyp = detail::sqrt(sh * sh + c * c);
+  double sc = s / ch;
+  double cc = hyp / ch;
+  kruger_sum(ctx.Delta, 2.e0 * sc * cc, (cc - sc) * (cc + sc), 0.e0, 1.e0, re, im);
+  lat = detail::atan2(s, hyp) + re;
+  dlam = detail::atan2(sh, c);
+
+  sin_cos(lat, s, cos_lat);
+}
+
+// UTM_Zone of utm.c: checks a geodetic coordinate and selects its zone,
+// adjusting lat and lon to the values the projection is evaluated at
+MGRS_HPP_INLINE long utm_zone(long zone_override, double &lat, double &lon, long &zone) noexcept {
+  long error = UTM_NO_ERROR;
+
+  if ((lat < utm_min_lat) || (lat > utm_max_lat) || (lat != lat)) error |= UTM_LAT_ERROR;
+  if ((lon < -pi) || (lon > (2 * pi)) || (lon != lon)) error |= UTM_LON_ERROR;
+  if ((zone_override < 0) || (zone_override > UTM_ZONES)) error |= UTM_ZONE_OVERRIDE_ERROR;
+  if (error) return(error);
+
+  if ((lat > -1.0e-9) && (lat < 0)) lat = 0.0;
+  if (lon < 0) lon += (2 * pi) + 1.0e-10;
+
+  long lat_degrees = (long)(lat * 180.0 / pi);
+  long long_degrees = (long)(lon * 180.0 / pi);
+  long temp_zone;
+
+  if (lon < pi) {
+    temp_zone = (long)(31 + ((lon * 180.0 / pi) / 6.0));
+  } else {
+    temp_zone = (long)(((lon * 180.0 / pi) / 6.0) - 29);
+  }
+  if (temp_zone > 60) temp_zone = 1;
+
+  // UTM special cases
+  if ((lat_degrees > 55) && (lat_degrees < 64) && (long_degrees > -1) && (long_degrees < 3)) temp_zone = 31;
+  if ((lat_degrees > 55) && (lat_degrees < 64) && (long_degrees > 2) && (long_degrees < 12)) temp_zone = 32;
+  if ((lat_degrees > 71) && (long_degrees > -1) && (long_degrees < 9)) temp_zone = 31;
+  if ((lat_degrees > 71) && (long_degrees > 8) && (long_degrees < 21)) temp_zone = 33;
+  if ((lat_degrees > 71) && (long_degrees > 20) && (long_degrees < 33)) temp_zone = 35;
+  if ((lat_degrees > 71) && (long_degrees > 32) && (long_degrees < 42)) temp_zone = 37;
+
+  if (zone_override) {
+    if ((temp_zone == 1) && (zone_override == 60)) {
+      temp_zone = zone_override;
+    } else if ((temp_zone == 60) && (zone_override == 1)) {
+      temp_zone = zone_override;
+    } else if ((lat_degrees > 71) && (long_degrees > -1) && (long_degrees < 42)) {
+      if (((temp_zone - 2) <= zone_override) && (zone_override <= (temp_zone + 2))) temp_zone = zone_override;
+      else error = UTM_ZONE_OVERRIDE_ERROR;
+    } else if (((temp_zone - 1) <= zone_override) && (zone_override <= (temp_zone + 1))) {
+      temp_zone = zone_override;
+    } else {
+      error = UTM_ZONE_OVERRIDE_ERROR;
+    }
+  }
+  zone = temp_zone;
+  return(error);
+}
+
+// Geodetic_UTM_To_MGRS of mgrs.c: the MGRS error code(s) of UTM ones
+MGRS_HPP_INLINE long mgrs_error_of_utm(long utm_error) noexcept {
+  long error = MGRS_NO_ERROR;
+  if (utm_error & UTM_LAT_ERROR) error |= MGRS_LAT_ERROR;
+  if (utm_error & UTM_LON_ERROR) error |= MGRS_LON_ERROR;
+  if (utm_error & UTM_ZONE_OVERRIDE_ERROR) error |= MGRS_ZONE_ERROR;
+  if (utm_error & UTM_EASTING_ERROR) error |= MGRS_EASTING_ERROR;
+  if (utm_error & UTM_NORTHING_ERROR) error |= MGRS_NORTHING_ERROR;
+  return(error);
+}
+
+// The MGRS error code(s) of an inverse UTM projection
+MGRS_HPP_INLINE long mgrs_error_of_utm_inverse(long utm_error) noexcept {
+  long error = MGRS_NO_ERROR;
+  if ((utm_error & UTM_ZONE_ERROR) || (utm_error & UTM_HEMISPHERE_ERROR)) error |= MGRS_STRING_ERROR;
+  if (utm_error & UTM_EASTING_ERROR) error |= MGRS_EASTING_ERROR;
+  if (utm_error & UTM_NORTHING_ERROR) error |= MGRS_NORTHING_ERROR;
+  return(error);
+}
+
+// Grid_Square_Offset of mgrs.c, fmod(value, 100000.0)
+MGRS_HPP_INLINE double grid_square_offset(double value) noexcept {
+  if ((value >= 0.0) && (value < 2147483648.0)) {
+    long squares = (long)(value / oneht);
+    value -= squares * oneht;
+    if (value < 0.0) value += oneht;
+    else if (value >= oneht) value -= oneht;
+    return(value);
+  }
+  return(std::fmod(value, oneht));
+}
+
+// Make_MGRS_String of mgrs.c, for a zone
+MGRS_HPP_INLINE void make_mgrs_string(char *mgrs, long zone, const int letters[3],
+                                      double easting, double northing, long precision) noexcept {
+  constexpr double divisors[max_precision + 1] = { 100000.0, 10000.0, 1000.0, 100.0, 10.0, 1.0 };
+  const double divisor = divisors[precision];
+  long i = 0;
+
+  mgrs[i++] = (char)('0' + zone / 10);
+  mgrs[i++] = (char)('0' + zone % 10);
+  for (int j=0; j<3; j++) mgrs[i++] = (char)('A' + letters[j]);
+
+  easting = grid_square_offset(easting);
+  if (easting >= 99999.5) easting = 99999.0;
+  northing = grid_square_offset(northing);
+  if (northing >= 99999.5) northing = 99999.0;
+  long values[2] = { (long)(easting / divisor), (long)(northing / divisor) };
+  for (long v : values) {
+    for (long k=precision-1; k>=0; k--) {
+      mgrs[i + k] = (char)('0' + v % 10);
+      v /= 10;
+    }
+    i += precision;
+  }
+  mgrs[i] = '\0';
+}
+
+// Get_Latitude_Letter of mgrs.c
+MGRS_HPP_INLINE long latitude_letter(double latitude, int &letter) noexcept {
+  double lat_deg = latitude * rad_to_deg;
+
+  if (lat_deg >= 72 && lat_deg < 84.5) {
+    letter = X;
+  } else if (lat_deg > -80.5 && lat_deg < 72) {
+    double temp = ((latitude + (80.0 * deg_to_rad)) / (8.0 * deg_to_rad)) + 1.0e-12;
+    letter = latitude_bands[(int)temp].letter;
+  } else {
+    return(MGRS_LAT_ERROR);
+  }
+  return(MGRS_NO_ERROR);
+}
+
+} // namespace detail
+
+// Transverse Mercator ----------------------------------------------------
+
+MGRS_HPP_INLINE tm_result geodetic_to_tm(const Transverse_Mercator_Context &ctx,
+                                         double latitude, double longitude) noexcept {
+  tm_result out = { 0.0, 0.0, TRANMERC_NO_ERROR };
+  double dlam;
+
+  out.error = detail::tm_check_geodetic(ctx, latitude, longitude, dlam);
+  if (!(out.error & ~TRANMERC_LON_WARNING)) {
+    if (ctx.Engine == TRANMERC_KRUGER) {
+      detail::kruger_project_point(ctx, latitude, dlam, out.easting, out.northing);
+    } else {
+      detail::project_point(ctx, latitude, dlam, out.easting, out.northing);
+    }
+  }
+  return(out);
+}
+
+MGRS_HPP_INLINE geodetic_result tm_to_geodetic(const Transverse_Mercator_Context &ctx,
+                                               double easting, double northing) noexcept {
+  geodetic_result out = { 0.0, 0.0, TRANMERC_NO_ERROR };
+  double lat, dlam, cos_lat;
+
+  out.error = detail::tm_check_projected(ctx, easting, northing);
+  if (!out.error) {
+    if (ctx.Engine == TRANMERC_KRUGER) {
+      detail::kruger_unproject_point(ctx, easting, northing, lat, dlam, cos_lat);
+    } else {
+      detail::unproject_point(ctx, easting, northing, lat, dlam, cos_lat);
+    }
+    out.error = detail::finish_geodetic(ctx, lat, dlam, cos_lat, out);
+  }
+  return(out);
+}
+
+// UTM --------------------------------------------------------------------
+
+MGRS_HPP_INLINE utm_result geodetic_to_utm_override(const UTM_Context &ctx, long zone_override,
+                                                    double latitude, double longitude) noexcept {
+  utm_result out = { 0, '\0', 0.0, 0.0, UTM_NO_ERROR };
+  long zone;
+
+  out.error = detail::utm_zone(zone_override, latitude, longitude, zone);
+  if (!out.error) {
+    out.zone = zone;
+    out.hemisphere = (latitude < 0) ? 'S' : 'N';
+    tm_result tm = geodetic_to_tm(ctx.Zone_Parameters[zone - 1][latitude < 0], latitude, longitude);
+    out.easting = tm.easting;
+    out.northing = tm.northing;
+    if ((out.easting < detail::utm_min_easting) || (out.easting > detail::utm_max_easting)) {
+      out.error = UTM_EASTING_ERROR;
+    }
+    if ((out.northing < detail::utm_min_northing) || (out.northing > detail::utm_max_northing)) {
+      out.error |= UTM_NORTHING_ERROR;
+    }
+  }
+  return(out);
+}
+
+MGRS_HPP_INLINE utm_result geodetic_to_utm(const UTM_Context &ctx, double latitude,
+                                           double longitude) noexcept {
+  return(geodetic_to_utm_override(ctx, ctx.Override, latitude, longitude));
+}
+
+MGRS_HPP_INLINE geodetic_result utm_to_geodetic(const UTM_Context &ctx, long zone, char hemisphere,
+                                                double easting, double northing) noexcept {
+  geodetic_result out = { 0.0, 0.0, UTM_NO_ERROR };
+
+  if ((zone < 1) || (zone > 60)) out.error |= UTM_ZONE_ERROR;
+  if ((hemisphere != 'S') && (hemisphere != 'N')) out.error |= UTM_HEMISPHERE_ERROR;
+  if ((easting < detail::utm_min_easting) || (easting > detail::utm_max_easting) || (easting != easting)) {
+    out.error |= UTM_EASTING_ERROR;
+  }
+  if ((northing < detail::utm_min_northing) || (northing > detail::utm_max_northing) || (northing != northing)) {
+    out.error |= UTM_NORTHING_ERROR;
+  }
+  if (!out.error) {
+    out = tm_to_geodetic(ctx.Zone_Parameters[zone - 1][hemisphere == 'S'], easting, northing);
+    long tm_error = out.error;
+    out.error = UTM_NO_ERROR;
+    if (tm_error & TRANMERC_EASTING_ERROR) out.error |= UTM_EASTING_ERROR;
+    if (tm_error & TRANMERC_NORTHING_ERROR) out.error |= UTM_NORTHING_ERROR;
+    if ((out.latitude < detail::utm_min_lat) || (out.latitude > detail::utm_max_lat)) {
+      out.error |= UTM_NORTHING_ERROR;
+    }
+  }
+  return(out);
+}
+
+// UPS (the C functions) --------------------------------------------------
+
+inline ups_result geodetic_to_ups(const UPS_Context &ctx, double latitude,
+                                  double longitude) noexcept {
+  ups_result out = { '\0', 0.0, 0.0, UPS_NO_ERROR };
+  out.error = Convert_Geodetic_To_UPS_Ctx(&ctx, latitude, longitude, &out.hemisphere,
+                                          &out.easting, &out.northing);
+  return(out);
+}
+
+inline geodetic_result ups_to_geodetic(const UPS_Context &ctx, char hemisphere, double easting,
+                                       double northing) noexcept {
+  geodetic_result out = { 0.0, 0.0, UPS_NO_ERROR };
+  out.error = Convert_UPS_To_Geodetic_Ctx(&ctx, hemisphere, easting, northing, &out.latitude,
+                                          &out.longitude);
+  return(out);
+}
+
+// MGRS -------------------------------------------------------------------
+
+namespace detail {
+
+// UTM_To_MGRS of mgrs.c
+MGRS_HPP_INLINE long utm_to_mgrs_string(const MGRS_Context &ctx, long zone, double longitude,
+                                        double latitude, double easting, double northing,
+                                        long precision, char *mgrs) noexcept {
+  int letters[3];
+
+  // Special check for rounding to (truncated) eastern edge of zone 31V
+  if ((zone == 31) && (((latitude >= 56.0 * deg_to_rad) && (latitude < 64.0 * deg_to_rad)) &&
+                       ((longitude >= 3.0 * deg_to_rad) || (easting >= 500000.0)))) {
+    utm_result utm = geodetic_to_utm_override(ctx.utm, 32, latitude, longitude);
+    if (utm.error) return(mgrs_error_of_utm(utm.error));
+    zone = utm.zone;
+    easting = utm.easting;
+    northing = utm.northing;
+  }
+
+  if (latitude <= 0.0 && northing == 1.0e7) {
+    latitude = 0.0;
+    northing = 0.0;
+  }
+
+  const double pattern_offset = pattern_offsets[!ctx.AA_Pattern][!(zone % 2)];
+  long error = latitude_letter(latitude, letters[0]);
+  if (error) return(error);
+
+  double grid_northing = northing;
+  while (grid_northing >= twomil) grid_northing = grid_northing - twomil;
+  grid_northing = grid_northing + pattern_offset;
+  if (grid_northing >= twomil) grid_northing = grid_northing - twomil;
+  letters[2] = row_letters[(long)(grid_northing / oneht)];
+
+  double grid_easting = easting;
+  if (((letters[0] == V) && (zone == 31)) && (grid_easting == 500000.0)) {
+    grid_easting = grid_easting - 1.0; // subtract 1 meter
+  }
+
+  // An easting of exactly 900,000m has no column letter
+  long column = (long)(grid_easting / oneht) - 1;
+  if ((column < 0) || (column > 7)) return(MGRS_EASTING_ERROR);
+  letters[1] = column_letters[(zone - 1) % 3][column];
+  make_mgrs_string(mgrs, zone, letters, grid_easting, northing, precision);
+  return(MGRS_NO_ERROR);
+}
+
+// Break_MGRS_String of mgrs.c
+MGRS_HPP_INLINE long break_mgrs_string(const char *c, long &zone, long letters[3], double &easting,
+                                       double &northing, long &precision) noexcept {
+  constexpr long powers_of_ten[max_precision + 1] = { 1, 10, 100, 1000, 10000, 100000 };
+  auto is_digit = [](char ch) { return((unsigned char)(ch - '0') < 10); };
+  auto is_alpha = [](char ch) { return((unsigned char)((ch | 0x20) - 'a') < 26); };
+  char digit[2 * max_precision];
+  long num_digits = 0;
+  long z = 0;
+  long error = MGRS_NO_ERROR;
+
+  while (*c == ' ') c++;
+
+  while (is_digit(*c)) {
+    z = z * 10 + (*c++ - '0');
+    if (++num_digits > 2) break;
+  }
+  if (num_digits > 2) {
+    error |= MGRS_STRING_ERROR;
+    while (is_digit(*c)) c++;
+  } else {
+    zone = z;
+    if ((num_digits > 0) && ((z < 1) || (z > 60))) error |= MGRS_STRING_ERROR;
+  }
+
+  if (is_alpha(c[0]) && is_alpha(c[1]) && is_alpha(c[2]) && !is_alpha(c[3])) {
+    for (int n=0; n<3; n++) {
+      letters[n] = (c[n] & ~0x20) - 'A';
+      if ((letters[n] == I) || (letters[n] == O)) error |= MGRS_STRING_ERROR;
+    }
+    c += 3;
+  } else {
+    error |= MGRS_STRING_ERROR;
+    while (is_alpha(*c)) c++;
+  }
+
+  num_digits = 0;
+  while (is_digit(*c)) {
+    if (num_digits < 2 * max_precision) digit[num_digits] = (char)(*c - '0');
+    num_digits++;
+    c++;
+  }
+  if ((num_digits <= 2 * max_precision) && (num_digits % 2 == 0)) {
+    long n = num_digits / 2;
+    long east = 0;
+    long north = 0;
+    precision = n;
+    for (long k=0; k<n; k++) {
+      east = east * 10 + digit[k];
+      north = north * 10 + digit[n + k];
+    }
+    easting = (double)(east * powers_of_ten[max_precision - n]);
+    northing = (double)(north * powers_of_ten[max_precision - n]);
+  } else {
+    error |= MGRS_STRING_ERROR;
+  }
+  return(error);
+}
+
+// MGRS_To_UTM of mgrs.c: the UTM coordinates of a string with a zone, and
+// the geodetic ones found checking its latitude band (valid with no error
+// or only MGRS_LAT_WARNING)
+MGRS_HPP_INLINE long mgrs_string_to_utm(const MGRS_Context &ctx, const char *mgrs,
+                                        utm_result &utm, geodetic_result &geo) noexcept {
+  constexpr double divisors[max_precision + 1] = { 1.0, 10.0, 100.0, 1000.0, 10000.0, 100000.0 };
+  long letters[3];
+  long precision = 0;
+  long zone = 0;
+
+  long error = break_mgrs_string(mgrs, zone, letters, utm.easting, utm.northing, precision);
+  if (!zone) return(error | MGRS_STRING_ERROR);
+  utm.zone = zone;
+  if (error) return(error);
+  if ((letters[0] == X) && ((zone == 32) || (zone == 34) || (zone == 36))) return(MGRS_STRING_ERROR);
+  utm.hemisphere = (letters[0] < N) ? 'S' : 'N';
+
+  const long column_square = letter_index.column[(zone - 1) % 3][letters[1]];
+  const long row_square = letter_index.row[!ctx.AA_Pattern][!(zone % 2)][letters[2]];
+  if ((column_square < 0) || (row_square < 0)) return(MGRS_STRING_ERROR);
+  const long band = letter_index.band[letters[0]];
+  if (band < 0) return(MGRS_STRING_ERROR);
+
+  double grid_northing = (double)row_square * oneht;
+  grid_northing += latitude_bands[band].northing_offset;
+  if (grid_northing < latitude_bands[band].min_northing) grid_northing += twomil;
+  utm.easting = (double)column_square * oneht + utm.easting;
+  utm.northing = grid_northing + utm.northing;
+
+  // check that the point is within its latitude band
+  geo = utm_to_geodetic(ctx.utm, utm.zone, utm.hemisphere, utm.easting, utm.northing);
+  if (geo.error) return(mgrs_error_of_utm_inverse(geo.error));
+  const double divisor = divisors[precision];
+  const double north = latitude_bands[band].north * deg_to_rad;
+  const double south = latitude_bands[band].south * deg_to_rad;
+  if (!(((south - deg_to_rad / divisor) <= geo.latitude) &&
+        (geo.latitude <= (north + deg_to_rad / divisor)))) {
+    return(MGRS_LAT_WARNING);
+  }
+  return(MGRS_NO_ERROR);
+}
+
+// Check_Zone of mgrs.c: whether a string starts with a zone, or
+// MGRS_STRING_ERROR if it starts with three digits or more
+MGRS_HPP_INLINE long check_zone(const char *mgrs, bool &zone_exists) noexcept {
+  while (*mgrs == ' ') mgrs++;
+  int num_digits = 0;
+  while ((unsigned char)(mgrs[num_digits] - '0') < 10) num_digits++;
+  if (num_digits > 2) return(MGRS_STRING_ERROR);
+  zone_exists = (num_digits > 0);
+  return(MGRS_NO_ERROR);
+}
+
+} // namespace detail
+
+MGRS_HPP_INLINE mgrs_result utm_to_mgrs(const MGRS_Context &ctx, long zone, char hemisphere,
+                                        double easting, double northing, long precision) noexcept {
+  mgrs_result out;
+  out.mgrs[0] = '\0';
+  out.error = MGRS_NO_ERROR;
+
+  if ((zone < 1) || (zone > 60)) out.error |= MGRS_ZONE_ERROR;
+  if ((hemisphere != 'S') && (hemisphere != 'N')) out.error |= MGRS_HEMISPHERE_ERROR;
+  if ((easting < detail::utm_min_easting) || (easting > detail::utm_max_easting) || (easting != easting)) {
+    out.error |= MGRS_EASTING_ERROR;
+  }
+  if ((northing < detail::utm_min_northing) || (northing > detail::utm_max_northing) || (northing != northing)) {
+    out.error |= MGRS_NORTHING_ERROR;
+  }
+  if ((precision < 0) || (precision > detail::max_precision)) out.error |= MGRS_PRECISION_ERROR;
+  if (!out.error) {
+    // as in C, the string does not depend on the inverse projection succeeding
+    geodetic_result geo = utm_to_geodetic(ctx.utm, zone, hemisphere, easting, northing);
+    out.error = detail::utm_to_mgrs_string(ctx, zone, geo.longitude, geo.latitude, easting,
+                                           northing, precision, out.mgrs);
+    if (out.error) out.mgrs[0] = '\0';
+  }
+  return(out);
+}
+
+MGRS_HPP_INLINE mgrs_result geodetic_to_mgrs(const MGRS_Context &ctx, double latitude,
+                                             double longitude, long precision) noexcept {
+  mgrs_result out;
+  out.mgrs[0] = '\0';
+  out.error = MGRS_NO_ERROR;
+
+  if ((latitude < -detail::pi_over_2) || (latitude > detail::pi_over_2) || (latitude != latitude)) {
+    out.error |= MGRS_LAT_ERROR;
+  }
+  if ((longitude < -detail::pi) || (longitude > (2 * detail::pi)) || (longitude != longitude)) {
+    out.error |= MGRS_LON_ERROR;
+  }
+  if ((precision < 0) || (precision > detail::max_precision)) out.error |= MGRS_PRECISION_ERROR;
+  if (out.error) return(out);
+
+  if ((latitude < detail::mgrs_min_utm_lat) || (latitude > detail::mgrs_max_utm_lat)) {
+    out.error = Convert_Geodetic_To_MGRS_Ctx(&ctx, latitude, longitude, precision, out.mgrs);
+  } else {
+    utm_result utm = geodetic_to_utm(ctx.utm, latitude, longitude);
+    if (utm.error) {
+      out.error = detail::mgrs_error_of_utm(utm.error);
+    } else {
+      out.error = detail::utm_to_mgrs_string(ctx, utm.zone, longitude, latitude, utm.easting,
+                                             utm.northing, precision, out.mgrs);
+    }
+  }
+  if (out.error) out.mgrs[0] = '\0';
+  return(out);
+}
+
+inline mgrs_result ups_to_mgrs(const MGRS_Context &ctx, char hemisphere, double easting,
+                               double northing, long precision) noexcept {
+  mgrs_result out;
+  out.error = Convert_UPS_To_MGRS_Ctx(&ctx, hemisphere, easting, northing, precision, out.mgrs);
+  if (out.error) out.mgrs[0] = '\0';
+  return(out);
+}
+
+// The UTM coordinates are kept with only MGRS_LAT_WARNING
+MGRS_HPP_INLINE utm_result mgrs_to_utm(const MGRS_Context &ctx, const char *mgrs) noexcept {
+  utm_result out = { 0, '\0', 0.0, 0.0, MGRS_NO_ERROR };
+  geodetic_result geo;
+  out.error = detail::mgrs_string_to_utm(ctx, mgrs, out, geo);
+  return(out);
+}
+
+MGRS_HPP_INLINE geodetic_result mgrs_to_geodetic(const MGRS_Context &ctx, const char *mgrs) noexcept {
+  geodetic_result out = { 0.0, 0.0, MGRS_NO_ERROR };
+  bool zone_exists = false;
+
+  out.error = detail::check_zone(mgrs, zone_exists);
+  if (out.error) return(out);
+  if (!zone_exists) {
+    out.error = Convert_MGRS_To_Geodetic_Ctx(&ctx, mgrs, &out.latitude, &out.longitude);
+    return(out);
+  }
+  utm_result utm = { 0, '\0', 0.0, 0.0, MGRS_NO_ERROR };
+  geodetic_result geo = { 0.0, 0.0, MGRS_NO_ERROR };
+  out.error = detail::mgrs_string_to_utm(ctx, mgrs, utm, geo);
+  if (!out.error || (out.error & MGRS_LAT_WARNING)) {
+    out.latitude = geo.latitude;
+    out.longitude = geo.longitude;
+  }
+  return(out);
+}
+
+inline ups_result mgrs_to_ups(const MGRS_Context &ctx, const char *mgrs) noexcept {
+  ups_result out = { '\0', 0.0, 0.0, MGRS_NO_ERROR };
+  out.error = Convert_MGRS_To_UPS_Ctx(&ctx, mgrs, &out.hemisphere, &out.easting, &out.northing);
+  return(out);
+}
+
+// Batch overloads --------------------------------------------------------
+//
+// Each converts out.size() rows (every input span must hold at least as
+// many), storing row i's result in out[i], and returns the number of rows
+// with an error bit set. Precision spans are recycled over the rows; an
+// empty one fails every row with MGRS_PRECISION_ERROR.
+
+namespace detail {
+
+template < typename Result, typename Convert >
+MGRS_HPP_INLINE long convert_rows(span < Result > out, Convert convert) noexcept {
+  long failed = 0;
+  for (std::size_t i=0; i<out.size(); i++) {
+    out[i] = convert(i);
+    failed += (out[i].error != 0);
+  }
+  return(failed);
+}
+
+inline mgrs_result precision_error() noexcept {
+  mgrs_result out;
+  out.mgrs[0] = '\0';
+  out.error = MGRS_PRECISION_ERROR;
+  return(out);
+}
+
+} // namespace detail
+
+inline long geodetic_to_tm(const Transverse_Mercator_Context &ctx, span < const double > latitude,
+                           span < const double > longitude, span < tm_result > out) noexcept {
+  return(detail::convert_rows(out, [&](std::size_t i) {
+    return(geodetic_to_tm(ctx, latitude[i], longitude[i]));
+  }));
+}
+
+inline long tm_to_geodetic(const Transverse_Mercator_Context &ctx, span < const double > easting,
+                           span < const double > northing, span < geodetic_result > out) noexcept {
+  return(detail::convert_rows(out, [&](std::size_t i) {
+    return(tm_to_geodetic(ctx, easting[i], northing[i]));
+  }));
+}
+
+inline long geodetic_to_utm(const UTM_Context &ctx, span < const double > latitude,
+                            span < const double > longitude, span < utm_result > out) noexcept {
+  return(detail::convert_rows(out, [&](std::size_t i) {
+    return(geodetic_to_utm(ctx, latitude[i], longitude[i]));
+  }));
+}
+
+inline long utm_to_geodetic(const UTM_Context &ctx, span < const long > zone,
+                            span < const char > hemisphere, span < const double > easting,
+                            span < const double > northing, span < geodetic_result > out) noexcept {
+  return(detail::convert_rows(out, [&](std::size_t i) {
+    return(utm_to_geodetic(ctx, zone[i], hemisphere[i], easting[i], northing[i]));
+  }));
+}
+
+inline long geodetic_to_ups(const UPS_Context &ctx, span < const double > latitude,
+                            span < const double > longitude, span < ups_result > out) noexcept {
+  return(detail::convert_rows(out, [&](std::size_t i) {
+    return(geodetic_to_ups(ctx, latitude[i], longitude[i]));
+  }));
+}
+
+inline long ups_to_geodetic(const UPS_Context &ctx, span < const char > hemisphere,
+                            span < const double > easting, span < const double > northing,
+                            span < geodetic_result > out) noexcept {
+  return(detail::convert_rows(out, [&](std::size_t i) {
+    return(ups_to_geodetic(ctx, hemisphere[i], easting[i], northing[i]));
+  }));
+}
+
+inline long geodetic_to_mgrs(const MGRS_Context &ctx, span < const double > latitude,
+                             span < const double > longitude, span < const long > precision,
+                             span < mgrs_result > out) noexcept {
+  return(detail::convert_rows(out, [&](std::size_t i) {
+    if (precision.empty()) return(detail::precision_error());
+    return(geodetic_to_mgrs(ctx, latitude[i], longitude[i], precision[i % precision.size()]));
+  }));
+}
+
+inline long utm_to_mgrs(const MGRS_Context &ctx, span < const long > zone,
+                        span < const char > hemisphere, span < const double > easting,
+                        span < const double > northing, span < const long > precision,
+                        span < mgrs_result > out) noexcept {
+  return(detail::convert_rows(out, [&](std::size_t i) {
+    if (precision.empty()) return(detail::precision_error());
+    return(utm_to_mgrs(ctx, zone[i], hemisphere[i], easting[i], northing[i],
+                       precision[i % precision.size()]));
+  }));
+}
+
+inline long ups_to_mgrs(const MGRS_Context &ctx, span < const char > hemisphere,
+                        span < const double > easting, span < const double > northing,
+                        span < const long > precision, span < mgrs_result > out) noexcept {
+  return(detail::convert_rows(out, [&](std::size_t i) {
+    if (precision.empty()) return(detail::precision_error());
+    return(ups_to_mgrs(ctx, hemisphere[i], easting[i], northing[i],
+                       precision[i % precision.size()]));
+  }));
+}
+
+inline long mgrs_to_geodetic(const MGRS_Context &ctx, span < const char *const > mgrs,
+                             span < geodetic_result > out) noexcept {
+  return(detail::convert_rows(out, [&](std::size_t i) {
+    return(mgrs_to_geodetic(ctx, mgrs[i]));
+  }));
+}
+
+inline long mgrs_to_utm(const MGRS_Context &ctx, span < const char *const > mgrs,
+                        span < utm_result > out) noexcept {
+  return(detail::convert_rows(out, [&](std::size_t i) {
+    return(mgrs_to_utm(ctx, mgrs[i]));
+  }));
+}
+
+inline long mgrs_to_ups(const MGRS_Context &ctx, span < const char *const > mgrs,
+                        span < ups_result > out) noexcept {
+  return(detail::convert_rows(out, [&](std::size_t i) {
+    return(mgrs_to_ups(ctx, mgrs[i]));
+  }));
+}
+
+} // namespace mgrs
+
+#undef MGRS_HPP_INLINE
+
+#endif // MGRS_HPP
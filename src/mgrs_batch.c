@@ -0,0 +1,299 @@
+/***************************************************************************/
+/*
+ * ABSTRACT
+ *
+ *    This component implements the batch C interface declared in
+ *    mgrs_batch.h over the reentrant MGRS, UTM and UPS functions.
+ */
+
+
+/***************************************************************************/
+/*
+ *                               INCLUDES
+ */
+
+#include <stdlib.h>
+#include "ups.h"
+#include "utm.h"
+#include "mgrs.h"
+#include "mgrs_batch.h"
+
+
+/***************************************************************************/
+/*
+ *                              DEFINES
+ */
+
+struct mgrs_context
+{
+  MGRS_Context mgrs;          /* Ellipsoid, UTM and UPS state */
+};
+
+
+/***************************************************************************/
+/*
+ *                              FUNCTIONS
+ */
+
+mgrs_context *mgrs_context_create (double a,
+                                   double f,
+                                   const char *Ellipsoid_Code,
+                                   long *Error_Code)
+{ /* mgrs_context_create */
+  mgrs_context *ctx;
+  long error_code = MGRS_NO_ERROR;
+
+  ctx = (mgrs_context *)calloc (1, sizeof (mgrs_context));
+  if (ctx)
+  {
+    error_code = Set_MGRS_Parameters_Ctx (&ctx->mgrs, a, f, Ellipsoid_Code);
+    if (error_code)
+    {
+      free (ctx);
+      ctx = NULL;
+    }
+  }
+  if (Error_Code)
+    *Error_Code = error_code;
+  return (ctx);
+} /* mgrs_context_create */
+
+
+void mgrs_context_destroy (mgrs_context *ctx)
+{ /* mgrs_context_destroy */
+  free (ctx);
+} /* mgrs_context_destroy */
+
+
+long mgrs_context_set_engine (mgrs_context *ctx,
+                              long Engine)
+{ /* mgrs_context_set_engine */
+  return (Set_UTM_Engine_Ctx (&ctx->mgrs.utm, Engine));
+} /* mgrs_context_set_engine */
+
+
+const MGRS_Context *mgrs_context_get (const mgrs_context *ctx)
+{ /* mgrs_context_get */
+  return (&ctx->mgrs);
+} /* mgrs_context_get */
+
+
+long mgrs_encode_batch (const mgrs_context *ctx,
+                        const double *Latitude,
+                        const double *Longitude,
+                        size_t Count,
+                        const long *Precision,
+                        size_t Precision_Count,
+                        char *MGRS,
+                        long *Error_Codes)
+{ /* mgrs_encode_batch */
+  return (Convert_Geodetic_To_MGRS_Batch_Ctx (&ctx->mgrs, Latitude, Longitude, Count,
+                                              Precision, Precision_Count, MGRS, Error_Codes));
+} /* mgrs_encode_batch */
+
+
+long mgrs_encode_fast_batch (const mgrs_context *ctx,
+                             const double *Latitude,
+                             const double *Longitude,
+                             size_t Count,
+                             const long *Precision,
+                             size_t Precision_Count,
+                             char *MGRS,
+                             long *Error_Codes)
+{ /* mgrs_encode_fast_batch */
+  return (Convert_Geodetic_To_MGRS_Fast_Batch_Ctx (&ctx->mgrs, Latitude, Longitude, Count,
+                                                   Precision, Precision_Count, MGRS,
+                                                   Error_Codes));
+} /* mgrs_encode_fast_batch */
+
+
+long mgrs_decode_batch (const mgrs_context *ctx,
+                        const char *const *MGRS,
+                        size_t Count,
+                        double *Latitude,
+                        double *Longitude,
+                        long *Error_Codes)
+{ /* mgrs_decode_batch */
+  return (Convert_MGRS_To_Geodetic_Batch_Ctx (&ctx->mgrs, MGRS, Count, Latitude, Longitude,
+                                              Error_Codes));
+} /* mgrs_decode_batch */
+
+
+long utm_to_mgrs_batch (const mgrs_context *ctx,
+                        const long *Zone,
+                        const char *Hemisphere,
+                        const double *Easting,
+                        const double *Northing,
+                        size_t Count,
+                        const long *Precision,
+                        size_t Precision_Count,
+                        char *MGRS,
+                        long *Error_Codes)
+{ /* utm_to_mgrs_batch */
+  char *row;
+  size_t i;
+  long error_code;
+  long error_count = 0;
+
+  for (i = 0; i < Count; i++)
+  {
+    row = MGRS + i * MGRS_STRING_LENGTH;
+    if (Precision_Count)
+      error_code = Convert_UTM_To_MGRS_Ctx (&ctx->mgrs, Zone[i], Hemisphere[i], Easting[i],
+                                            Northing[i], Precision[i % Precision_Count], row);
+    else
+      error_code = MGRS_PRECISION_ERROR;
+    if (error_code)
+    {
+      row[0] = '\0';
+      error_count++;
+    }
+    if (Error_Codes)
+      Error_Codes[i] = error_code;
+  }
+  return (error_count);
+} /* utm_to_mgrs_batch */
+
+
+long mgrs_to_utm_batch (const mgrs_context *ctx,
+                        const char *const *MGRS,
+                        size_t Count,
+                        long *Zone,
+                        char *Hemisphere,
+                        double *Easting,
+                        double *Northing,
+                        long *Error_Codes)
+{ /* mgrs_to_utm_batch */
+  size_t i;
+  long error_code;
+  long error_count = 0;
+
+  for (i = 0; i < Count; i++)
+  {
+    error_code = Convert_MGRS_To_UTM_Ctx (&ctx->mgrs, MGRS[i], &Zone[i], &Hemisphere[i],
+                                          &Easting[i], &Northing[i]);
+    if (error_code)
+      error_count++;
+    if (Error_Codes)
+      Error_Codes[i] = error_code;
+  }
+  return (error_count);
+} /* mgrs_to_utm_batch */
+
+
+long ups_to_mgrs_batch (const mgrs_context *ctx,
+                        const char *Hemisphere,
+                        const double *Easting,
+                        const double *Northing,
+                        size_t Count,
+                        const long *Precision,
+                        size_t Precision_Count,
+                        char *MGRS,
+                        long *Error_Codes)
+{ /* ups_to_mgrs_batch */
+  char *row;
+  size_t i;
+  long error_code;
+  long error_count = 0;
+
+  for (i = 0; i < Count; i++)
+  {
+    row = MGRS + i * MGRS_STRING_LENGTH;
+    if (Precision_Count)
+      error_code = Convert_UPS_To_MGRS_Ctx (&ctx->mgrs, Hemisphere[i], Easting[i], Northing[i],
+                                            Precision[i % Precision_Count], row);
+    else
+      error_code = MGRS_PRECISION_ERROR;
+    if (error_code)
+    {
+      row[0] = '\0';
+      error_count++;
+    }
+    if (Error_Codes)
+      Error_Codes[i] = error_code;
+  }
+  return (error_count);
+} /* ups_to_mgrs_batch */
+
+
+long mgrs_to_ups_batch (const mgrs_context *ctx,
+                        const char *const *MGRS,
+                        size_t Count,
+                        char *Hemisphere,
+                        double *Easting,
+                        double *Northing,
+                        long *Error_Codes)
+{ /* mgrs_to_ups_batch */
+  size_t i;
+  long error_code;
+  long error_count = 0;
+
+  for (i = 0; i < Count; i++)
+  {
+    error_code = Convert_MGRS_To_UPS_Ctx (&ctx->mgrs, MGRS[i], &Hemisphere[i], &Easting[i],
+                                          &Northing[i]);
+    if (error_code)
+      error_count++;
+    if (Error_Codes)
+      Error_Codes[i] = error_code;
+  }
+  return (error_count);
+} /* mgrs_to_ups_batch */
+
+
+long geodetic_to_utm_batch (const mgrs_context *ctx,
+                            const double *Latitude,
+                            const double *Longitude,
+                            size_t Count,
+                            long *Zone,
+                            char *Hemisphere,
+                            double *Easting,
+                            double *Northing,
+                            long *Error_Codes)
+{ /* geodetic_to_utm_batch */
+  return (Convert_Geodetic_To_UTM_Batch_Ctx (&ctx->mgrs.utm, Latitude, Longitude, Count, Zone,
+                                             Hemisphere, Easting, Northing, Error_Codes));
+} /* geodetic_to_utm_batch */
+
+
+long utm_to_geodetic_batch (const mgrs_context *ctx,
+                            const long *Zone,
+                            const char *Hemisphere,
+                            const double *Easting,
+                            const double *Northing,
+                            size_t Count,
+                            double *Latitude,
+                            double *Longitude,
+                            long *Error_Codes)
+{ /* utm_to_geodetic_batch */
+  return (Convert_UTM_To_Geodetic_Batch_Ctx (&ctx->mgrs.utm, Zone, Hemisphere, Easting, Northing,
+                                             Count, Latitude, Longitude, Error_Codes));
+} /* utm_to_geodetic_batch */
+
+
+long geodetic_to_ups_batch (const mgrs_context *ctx,
+                            const double *Latitude,
+                            const double *Longitude,
+                            size_t Count,
+                            char *Hemisphere,
+                            double *Easting,
+                            double *Northing,
+                            long *Error_Codes)
+{ /* geodetic_to_ups_batch */
+  return (Convert_Geodetic_To_UPS_Batch_Ctx (&ctx->mgrs.ups, Latitude, Longitude, Count,
+                                             Hemisphere, Easting, Northing, Error_Codes));
+} /* geodetic_to_ups_batch */
+
+
+long ups_to_geodetic_batch (const mgrs_context *ctx,
+                            const char *Hemisphere,
+                            const double *Easting,
+                            const double *Northing,
+                            size_t Count,
+                            double *Latitude,
+                            double *Longitude,
+                            long *Error_Codes)
+{ /* ups_to_geodetic_batch */
+  return (Convert_UPS_To_Geodetic_Batch_Ctx (&ctx->mgrs.ups, Hemisphere, Easting, Northing,
+                                             Count, Latitude, Longitude, Error_Codes));
+} /* ups_to_geodetic_batch */
@@ -0,0 +1,305 @@
+#ifndef MGRS_BATCH_H
+#define MGRS_BATCH_H
+
+/***************************************************************************/
+/*
+ * ABSTRACT
+ *
+ *    This component is the batch C interface for applications that link
+ *    the converters directly (it does not depend on R).  A converter is an
+ *    opaque mgrs_context handle holding the ellipsoid state; it is created
+ *    with mgrs_context_create and, once set up, only read, so one handle may
+ *    be shared by any number of threads converting separate rows.
+ *
+ *    Every batch function converts Count rows held in parallel arrays
+ *    (latitudes and longitudes in radians, eastings and northings in
+ *    meters), gives each row exactly the result of the per-point _Ctx
+ *    function, stores the error code of row i in Error_Codes[i] when
+ *    Error_Codes is not NULL, and returns the number of rows with errors.
+ *    MGRS strings are written to MGRS + i * MGRS_STRING_LENGTH (an empty
+ *    string for rows with errors; other outputs of such rows are
+ *    unspecified), and Precision is recycled over the rows.  Error codes
+ *    are the MGRS_*_ERROR bits for the functions that read or write MGRS
+ *    strings, and the UTM_*_ERROR or UPS_*_ERROR bits for the others.
+ */
+
+#include <stddef.h>
+#include "mgrs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct mgrs_context mgrs_context;
+
+
+mgrs_context *mgrs_context_create (double a,
+                                   double f,
+                                   const char *Ellipsoid_Code,
+                                   long *Error_Code);
+/*
+ * The function mgrs_context_create returns a new converter for the
+ * ellipsoid given by a, f and Ellipsoid_Code (see Set_MGRS_Parameters),
+ * using the Thomas Transverse Mercator series.  If the parameters are
+ * invalid or memory runs out NULL is returned, and the MGRS error code(s)
+ * of the parameters are stored in Error_Code when it is not NULL.
+ *
+ *    a               : Semi-major axis of ellipsoid, in meters   (input)
+ *    f               : Flattening of ellipsoid                   (input)
+ *    Ellipsoid_Code  : 2-letter code for ellipsoid               (input)
+ *    Error_Code      : Error code(s), or NULL                    (output)
+ */
+
+
+void mgrs_context_destroy (mgrs_context *ctx);
+/*
+ * The function mgrs_context_destroy frees a converter made by
+ * mgrs_context_create.  ctx may be NULL.
+ */
+
+
+long mgrs_context_set_engine (mgrs_context *ctx,
+                              long Engine);
+/*
+ * The function mgrs_context_set_engine selects the Transverse Mercator
+ * series of the UTM conversions, TRANMERC_THOMAS or TRANMERC_KRUGER (see
+ * Set_UTM_Engine).  It must not be called while the converter is in use.
+ * If Engine is invalid UTM_ENGINE_ERROR is returned, otherwise
+ * UTM_NO_ERROR.
+ *
+ *    ctx             : Converter                                 (input)
+ *    Engine          : TRANMERC_THOMAS or TRANMERC_KRUGER        (input)
+ */
+
+
+const MGRS_Context *mgrs_context_get (const mgrs_context *ctx);
+/*
+ * The function mgrs_context_get returns the MGRS context of a converter, to
+ * call the per-point _Ctx functions with.
+ */
+
+
+long mgrs_encode_batch (const mgrs_context *ctx,
+                        const double *Latitude,
+                        const double *Longitude,
+                        size_t Count,
+                        const long *Precision,
+                        size_t Precision_Count,
+                        char *MGRS,
+                        long *Error_Codes);
+/*
+ * The function mgrs_encode_batch converts geodetic coordinates to MGRS
+ * coordinate strings (see Convert_Geodetic_To_MGRS_Batch_Ctx).
+ *
+ *    Latitude        : Latitudes in radians                      (input)
+ *    Longitude       : Longitudes in radians                     (input)
+ *    Precision       : Precision levels, recycled over the rows  (input)
+ *    Precision_Count : Number of precision levels                (input)
+ *    MGRS            : Count * MGRS_STRING_LENGTH characters     (output)
+ */
+
+
+long mgrs_encode_fast_batch (const mgrs_context *ctx,
+                             const double *Latitude,
+                             const double *Longitude,
+                             size_t Count,
+                             const long *Precision,
+                             size_t Precision_Count,
+                             char *MGRS,
+                             long *Error_Codes);
+/*
+ * The function mgrs_encode_fast_batch is mgrs_encode_batch with the single
+ * precision projection of Convert_Geodetic_To_MGRS_Fast_Batch_Ctx; the
+ * strings and error codes are the same.
+ */
+
+
+long mgrs_decode_batch (const mgrs_context *ctx,
+                        const char *const *MGRS,
+                        size_t Count,
+                        double *Latitude,
+                        double *Longitude,
+                        long *Error_Codes);
+/*
+ * The function mgrs_decode_batch converts MGRS coordinate strings to
+ * geodetic coordinates (see Convert_MGRS_To_Geodetic_Batch_Ctx).
+ *
+ *    MGRS            : MGRS coordinate strings                   (input)
+ *    Latitude        : Latitudes in radians                      (output)
+ *    Longitude       : Longitudes in radians                     (output)
+ */
+
+
+long utm_to_mgrs_batch (const mgrs_context *ctx,
+                        const long *Zone,
+                        const char *Hemisphere,
+                        const double *Easting,
+                        const double *Northing,
+                        size_t Count,
+                        const long *Precision,
+                        size_t Precision_Count,
+                        char *MGRS,
+                        long *Error_Codes);
+/*
+ * The function utm_to_mgrs_batch converts UTM coordinates to MGRS
+ * coordinate strings (see Convert_UTM_To_MGRS_Ctx).
+ *
+ *    Zone            : UTM zones                                 (input)
+ *    Hemisphere      : North or South hemispheres                (input)
+ *    Easting         : Eastings (X) in meters                    (input)
+ *    Northing        : Northings (Y) in meters                   (input)
+ *    Precision       : Precision levels, recycled over the rows  (input)
+ *    Precision_Count : Number of precision levels                (input)
+ *    MGRS            : Count * MGRS_STRING_LENGTH characters     (output)
+ */
+
+
+long mgrs_to_utm_batch (const mgrs_context *ctx,
+                        const char *const *MGRS,
+                        size_t Count,
+                        long *Zone,
+                        char *Hemisphere,
+                        double *Easting,
+                        double *Northing,
+                        long *Error_Codes);
+/*
+ * The function mgrs_to_utm_batch converts MGRS coordinate strings to UTM
+ * coordinates (see Convert_MGRS_To_UTM_Ctx).  Rows with only
+ * MGRS_LAT_WARNING keep their UTM coordinates.
+ *
+ *    MGRS            : MGRS coordinate strings                   (input)
+ *    Zone            : UTM zones                                 (output)
+ *    Hemisphere      : North or South hemispheres                (output)
+ *    Easting         : Eastings (X) in meters                    (output)
+ *    Northing        : Northings (Y) in meters                   (output)
+ */
+
+
+long ups_to_mgrs_batch (const mgrs_context *ctx,
+                        const char *Hemisphere,
+                        const double *Easting,
+                        const double *Northing,
+                        size_t Count,
+                        const long *Precision,
+                        size_t Precision_Count,
+                        char *MGRS,
+                        long *Error_Codes);
+/*
+ * The function ups_to_mgrs_batch converts UPS coordinates to MGRS
+ * coordinate strings (see Convert_UPS_To_MGRS_Ctx).
+ *
+ *    Hemisphere      : North or South hemispheres                (input)
+ *    Easting         : Eastings (X) in meters                    (input)
+ *    Northing        : Northings (Y) in meters                   (input)
+ *    Precision       : Precision levels, recycled over the rows  (input)
+ *    Precision_Count : Number of precision levels                (input)
+ *    MGRS            : Count * MGRS_STRING_LENGTH characters     (output)
+ */
+
+
+long mgrs_to_ups_batch (const mgrs_context *ctx,
+                        const char *const *MGRS,
+                        size_t Count,
+                        char *Hemisphere,
+                        double *Easting,
+                        double *Northing,
+                        long *Error_Codes);
+/*
+ * The function mgrs_to_ups_batch converts MGRS coordinate strings to UPS
+ * coordinates (see Convert_MGRS_To_UPS_Ctx).
+ *
+ *    MGRS            : MGRS coordinate strings                   (input)
+ *    Hemisphere      : North or South hemispheres                (output)
+ *    Easting         : Eastings (X) in meters                    (output)
+ *    Northing        : Northings (Y) in meters                   (output)
+ */
+
+
+long geodetic_to_utm_batch (const mgrs_context *ctx,
+                            const double *Latitude,
+                            const double *Longitude,
+                            size_t Count,
+                            long *Zone,
+                            char *Hemisphere,
+                            double *Easting,
+                            double *Northing,
+                            long *Error_Codes);
+/*
+ * The function geodetic_to_utm_batch projects geodetic coordinates to UTM
+ * (see Convert_Geodetic_To_UTM_Batch_Ctx).
+ *
+ *    Latitude        : Latitudes in radians                      (input)
+ *    Longitude       : Longitudes in radians                     (input)
+ *    Zone            : UTM zones                                 (output)
+ *    Hemisphere      : North or South hemispheres                (output)
+ *    Easting         : Eastings (X) in meters                    (output)
+ *    Northing        : Northings (Y) in meters                   (output)
+ */
+
+
+long utm_to_geodetic_batch (const mgrs_context *ctx,
+                            const long *Zone,
+                            const char *Hemisphere,
+                            const double *Easting,
+                            const double *Northing,
+                            size_t Count,
+                            double *Latitude,
+                            double *Longitude,
+                            long *Error_Codes);
+/*
+ * The function utm_to_geodetic_batch unprojects UTM coordinates (see
+ * Convert_UTM_To_Geodetic_Batch_Ctx).
+ *
+ *    Zone            : UTM zones                                 (input)
+ *    Hemisphere      : North or South hemispheres                (input)
+ *    Easting         : Eastings (X) in meters                    (input)
+ *    Northing        : Northings (Y) in meters                   (input)
+ *    Latitude        : Latitudes in radians                      (output)
+ *    Longitude       : Longitudes in radians                     (output)
+ */
+
+
+long geodetic_to_ups_batch (const mgrs_context *ctx,
+                            const double *Latitude,
+                            const double *Longitude,
+                            size_t Count,
+                            char *Hemisphere,
+                            double *Easting,
+                            double *Northing,
+                            long *Error_Codes);
+/*
+ * The function geodetic_to_ups_batch projects geodetic coordinates to UPS
+ * (see Convert_Geodetic_To_UPS_Batch_Ctx).
+ *
+ *    Latitude        : Latitudes in radians                      (input)
+ *    Longitude       : Longitudes in radians                     (input)
+ *    Hemisphere      : North or South hemispheres                (output)
+ *    Easting         : Eastings (X) in meters                    (output)
+ *    Northing        : Northings (Y) in meters                   (output)
+ */
+
+
+long ups_to_geodetic_batch (const mgrs_context *ctx,
+                            const char *Hemisphere,
+                            const double *Easting,
+                            const double *Northing,
+                            size_t Count,
+                            double *Latitude,
+                            double *Longitude,
+                            long *Error_Codes);
+/*
+ * The function ups_to_geodetic_batch unprojects UPS coordinates (see
+ * Convert_UPS_To_Geodetic_Batch_Ctx).
+ *
+ *    Hemisphere      : North or South hemispheres                (input)
+ *    Easting         : Eastings (X) in meters                    (input)
+ *    Northing        : Northings (Y) in meters                   (input)
+ *    Latitude        : Latitudes in radians                      (output)
+ *    Longitude       : Longitudes in radians                     (output)
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MGRS_BATCH_H */
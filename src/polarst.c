@@ -93,10 +93,14 @@
  */
 
 #include <math.h>
+#include <stddef.h>
+#include "kernel.h"
 #include "polarst.h"
 
 /*
  *    math.h     - Standard C math library
+ *    stddef.h   - Standard C size_t definition
+ *    kernel.h   - Is for the batch kernel attributes and math
  *    polarst.h  - Is for prototype error checking
  */
 
@@ -110,7 +114,10 @@
 #define PI           3.14159265358979323e0       /* PI     */
 #define PI_OVER_2    (PI / 2.0)           
 #define TWO_PI       (2.0 * PI)
-#define POLAR_POW(EsSin)     pow((1.0 - EsSin) / (1.0 + EsSin), es_OVER_2)
+#define POLAR_POW(ctx, EsSin) pow((1.0 - EsSin) / (1.0 + EsSin), (ctx)->es_OVER_2)
+
+#define BATCH_BLOCK  256  /* Rows projected at a time by the batch functions */
+
 
 /************************************************************************/
 /*                           GLOBAL DECLARATIONS
@@ -119,26 +126,25 @@
 
 const double PI_Over_4 = (PI / 4.0);
 
-/* Ellipsoid Parameters, default to WGS 84  */
-static double Polar_a = 6378137.0;                    /* Semi-major axis of ellipsoid in meters  */
-static double Polar_f = 1 / 298.257223563;            /* Flattening of ellipsoid  */
-static double es = 0.08181919084262188000;            /* Eccentricity of ellipsoid    */
-static double es_OVER_2 = .040909595421311;           /* es / 2.0 */
-static double Southern_Hemisphere = 0;                /* Flag variable */
-static double tc = 1.0;
-static double e4 = 1.0033565552493;
-static double Polar_a_mc = 6378137.0;                 /* Polar_a * mc */
-static double two_Polar_a = 12756274.0;               /* 2.0 * Polar_a */
-
-/* Polar Stereographic projection Parameters */
-static double Polar_Origin_Lat = ((PI * 90) / 180);   /* Latitude of origin in radians */
-static double Polar_Origin_Long = 0.0;                /* Longitude of origin in radians */
-static double Polar_False_Easting = 0.0;              /* False easting in meters */
-static double Polar_False_Northing = 0.0;             /* False northing in meters */
-
-/* Maximum variance for easting and northing values for WGS 84. */
-static double Polar_Delta_Easting = 12713601.0;
-static double Polar_Delta_Northing = 12713601.0;
+/* State used by the non-reentrant functions, default to WGS 84  */
+static Polar_Stereographic_Context Polar_Context =
+  {
+    6378137.0,                  /* Semi-major axis of ellipsoid in meters  */
+    1 / 298.257223563,          /* Flattening of ellipsoid  */
+    0.08181919084262188000,     /* Eccentricity of ellipsoid    */
+    .040909595421311,           /* es / 2.0 */
+    0,                          /* Flag variable */
+    1.0,                        /* tc */
+    1.0033565552493,            /* e4 */
+    6378137.0,                  /* Polar_a * mc */
+    12756274.0,                 /* 2.0 * Polar_a */
+    ((PI * 90) / 180),          /* Latitude of origin in radians */
+    0.0,                        /* Longitude of origin in radians */
+    0.0,                        /* False easting in meters */
+    0.0,                        /* False northing in meters */
+    12713601.0,                 /* Maximum variance for easting and northing */
+    12713601.0                  /* values for WGS 84. */
+  };
 
 /* These state variables are for optimization purposes. The only function
  * that should modify them is Set_Polar_Stereographic_Parameters.         
@@ -151,6 +157,345 @@ static double Polar_Delta_Northing = 12713601.0;
  */
 
 
+static FORCE_INLINE double Pow_Es (const Polar_Stereographic_Context *ctx,
+                                   double Sin_Lat)
+{ /* BEGIN Pow_Es */
+/*
+ * The function Pow_Es returns POLAR_POW of es * Sin_Lat, that is
+ * exp(-es * atanh(es * Sin_Lat)), without calling pow: es * Sin_Lat is at
+ * most 0.09 for the accepted flattenings, where the atanh series through
+ * the 15th power and the exp series through the 6th are exact to double
+ * precision.
+ *
+ *    ctx        :  Polar Stereographic context               (input)
+ *    Sin_Lat    :  Sine of latitude                          (input)
+ */
+
+  double x = ctx->es * Sin_Lat;
+  double x2 = x * x;
+  double y;
+
+  y = -ctx->es * x * (1.0 + x2 * (3.33333333333333333e-01 + x2 * (2.0e-01
+      + x2 * (1.42857142857142857e-01 + x2 * (1.11111111111111111e-01
+      + x2 * (9.09090909090909091e-02 + x2 * (7.69230769230769231e-02
+      + x2 * 6.66666666666666667e-02)))))));
+  return (1.0 + y * (1.0 + y * (0.5 + y * (1.66666666666666667e-01
+          + y * (4.16666666666666667e-02 + y * (8.33333333333333333e-03
+          + y * 1.38888888888888889e-03))))));
+} /* END OF Pow_Es */
+
+
+static FORCE_INLINE double Latitude_Step (const Polar_Stereographic_Context *ctx,
+                                          double t,
+                                          double Sin_Lat)
+{ /* BEGIN Latitude_Step */
+/*
+ * The function Latitude_Step returns the next sine of latitude of Newton's
+ * method for s = F(s), the latitude equation
+ * PHI = PI/2 - 2 atan(t * POLAR_POW(es sin(PHI))) written for s = sin(PHI):
+ * F(s) = (1 - u^2) / (1 + u^2), u = t * POLAR_POW(es s).  Over the accepted
+ * flattenings F' is at most 0.0081 and F'' at most 0.00023, so each step
+ * takes an error E to less than 0.00012 E^2.  The conformal latitude
+ * (POLAR_POW taken as 1) starts within 0.0081, so two steps leave less
+ * than 1e-20.
+ *
+ *    ctx        :  Polar Stereographic context               (input)
+ *    t          :  Scaled radius of the point                (input)
+ *    Sin_Lat    :  Sine of latitude                          (input)
+ */
+
+  double u = t * Pow_Es(ctx, Sin_Lat);
+  double u2 = u * u;
+  double d = 1.0 + u2;
+  double essin = ctx->es * Sin_Lat;
+  double r = d * (1.0 - essin * essin);
+
+  /* s + (F(s) - s) / (1 - F'(s)), F'(s) = 4 u^2 es^2 / (d^2 (1 - es^2 s^2)) */
+  return (Sin_Lat + ((1.0 - u2) - Sin_Lat * d) * r
+          / (d * r - 4.0 * u2 * ctx->es * ctx->es));
+} /* END OF Latitude_Step */
+
+
+static long Check_Geodetic (const Polar_Stereographic_Context *ctx,
+                            double Latitude,
+                            double Longitude,
+                            double *Lat,
+                            double *Delta_Long)
+{ /* BEGIN Check_Geodetic */
+/*
+ * The function Check_Geodetic checks a geodetic coordinate against the
+ * projection held in ctx and, if it can be projected, returns its latitude
+ * and longitude difference from the origin, turned to the northern
+ * hemisphere.  If any errors occur, error code(s) are returned by the
+ * function, otherwise POLAR_NO_ERROR is returned.
+ *
+ *    ctx        :  Polar Stereographic context               (input)
+ *    Latitude   :  Latitude, in radians                      (input)
+ *    Longitude  :  Longitude, in radians                     (input)
+ *    Lat        :  Latitude, in radians                      (output)
+ *    Delta_Long :  Longitude less the origin, in radians     (output)
+ */
+
+  double dlam;
+  long Error_Code = POLAR_NO_ERROR;
+
+  if ((Latitude < -PI_OVER_2) || (Latitude > PI_OVER_2))
+  {   /* Latitude out of range */
+    Error_Code |= POLAR_LAT_ERROR;
+  }
+  if ((Latitude < 0) && (ctx->Southern_Hemisphere == 0))
+  {   /* Latitude and Origin Latitude in different hemispheres */
+    Error_Code |= POLAR_LAT_ERROR;
+  }
+  if ((Latitude > 0) && (ctx->Southern_Hemisphere == 1))
+  {   /* Latitude and Origin Latitude in different hemispheres */
+    Error_Code |= POLAR_LAT_ERROR;
+  }
+  if ((Longitude < -PI) || (Longitude > TWO_PI))
+  {  /* Longitude out of range */
+    Error_Code |= POLAR_LON_ERROR;
+  }
+
+  if (!Error_Code)
+  {  /* no errors */
+    if (ctx->Southern_Hemisphere != 0)
+    {
+      Longitude *= -1.0;
+      Latitude *= -1.0;
+    }
+    dlam = Longitude - ctx->Origin_Long;
+    if (dlam > PI)
+    {
+      dlam -= TWO_PI;
+    }
+    if (dlam < -PI)
+    {
+      dlam += TWO_PI;
+    }
+    *Lat = Latitude;
+    *Delta_Long = dlam;
+  }
+  return (Error_Code);
+} /* END OF Check_Geodetic */
+
+
+static FORCE_INLINE void Project_Point (const Polar_Stereographic_Context *ctx,
+                                        double Lat,
+                                        double dlam,
+                                        double *Easting,
+                                        double *Northing)
+{ /* BEGIN Project_Point */
+/*
+ * The function Project_Point projects a latitude and longitude difference
+ * found by Check_Geodetic, with tan(PI/4 - Lat/2) = cos(Lat) / (1 + sin(Lat))
+ * and Pow_Es in place of tan and pow.
+ *
+ *    ctx        :  Polar Stereographic context               (input)
+ *    Lat        :  Latitude, in radians                      (input)
+ *    dlam       :  Longitude less the origin, in radians     (input)
+ *    Easting    :  Easting (X), in meters                    (output)
+ *    Northing   :  Northing (Y), in meters                   (output)
+ */
+
+  double slat, clat;
+  double sin_dlam, cos_dlam;
+  double t;
+  double rho;
+  double east, north;
+
+  Sin_Cos(Lat, &slat, &clat);
+  Sin_Cos(dlam, &sin_dlam, &cos_dlam);
+  t = clat / ((1.0 + slat) * Pow_Es(ctx, slat));
+
+  if (fabs(fabs(ctx->Origin_Lat) - PI_OVER_2) > 1.0e-10)
+    rho = ctx->a_mc * t / ctx->tc;
+  else
+    rho = ctx->two_a * t / ctx->e4;
+
+  if (ctx->Southern_Hemisphere != 0)
+  {
+    east = -(rho * sin_dlam - ctx->False_Easting);
+    north = rho * cos_dlam + ctx->False_Northing;
+  }
+  else
+  {
+    east = rho * sin_dlam + ctx->False_Easting;
+    north = -rho * cos_dlam + ctx->False_Northing;
+  }
+
+  /* the pole projects to the origin */
+  *Easting = (fabs(fabs(Lat) - PI_OVER_2) < 1.0e-10) ? ctx->False_Easting : east;
+  *Northing = (fabs(fabs(Lat) - PI_OVER_2) < 1.0e-10) ? ctx->False_Northing : north;
+} /* END OF Project_Point */
+
+
+static long Check_Projected (const Polar_Stereographic_Context *ctx,
+                             double Easting,
+                             double Northing,
+                             double *Radius)
+{ /* BEGIN Check_Projected */
+/*
+ * The function Check_Projected checks the range of Polar Stereographic
+ * coordinates and, if they are in range, returns their distance from the
+ * origin.  If any errors occur, error code(s) are returned by the
+ * function, otherwise POLAR_NO_ERROR is returned.
+ *
+ *  ctx              : Polar Stereographic context              (input)
+ *  Easting          : Easting (X), in meters                   (input)
+ *  Northing         : Northing (Y), in meters                  (input)
+ *  Radius           : Distance from the origin, in meters      (output)
+ */
+
+  double dy, dx;
+  double rho;
+  double delta_radius;
+  long Error_Code = POLAR_NO_ERROR;
+  double min_easting = ctx->False_Easting - ctx->Delta_Easting;
+  double max_easting = ctx->False_Easting + ctx->Delta_Easting;
+  double min_northing = ctx->False_Northing - ctx->Delta_Northing;
+  double max_northing = ctx->False_Northing + ctx->Delta_Northing;
+
+  if (Easting > max_easting || Easting < min_easting)
+  { /* Easting out of range */
+    Error_Code |= POLAR_EASTING_ERROR;
+  }
+  if (Northing > max_northing || Northing < min_northing)
+  { /* Northing out of range */
+    Error_Code |= POLAR_NORTHING_ERROR;
+  }
+
+  if (!Error_Code)
+  {
+    dy = Northing - ctx->False_Northing;
+    dx = Easting - ctx->False_Easting;
+
+    /* Radius of point with origin of false easting, false northing */
+    rho = sqrt(dx * dx + dy * dy);
+
+    delta_radius = sqrt(ctx->Delta_Easting * ctx->Delta_Easting + ctx->Delta_Northing * ctx->Delta_Northing);
+
+    if(rho > delta_radius)
+    { /* Point is outside of projection area */
+      Error_Code |= POLAR_RADIUS_ERROR;
+    }
+    *Radius = rho;
+  }
+  return (Error_Code);
+} /* END OF Check_Projected */
+
+
+static FORCE_INLINE void Unproject_Point (const Polar_Stereographic_Context *ctx,
+                                          double Easting,
+                                          double Northing,
+                                          double rho,
+                                          double *Latitude,
+                                          double *Longitude)
+{ /* BEGIN Unproject_Point */
+/*
+ * The function Unproject_Point returns the latitude and longitude of Polar
+ * Stereographic coordinates that passed Check_Projected.  The latitude
+ * iteration takes a fixed two Latitude_Steps (see there) instead of
+ * running until it settles.
+ *
+ *  ctx              : Polar Stereographic context              (input)
+ *  Easting          : Easting (X), in meters                   (input)
+ *  Northing         : Northing (Y), in meters                  (input)
+ *  rho              : Radius found by Check_Projected          (input)
+ *  Latitude         : Latitude, in radians                     (output)
+ *  Longitude        : Longitude, in radians                    (output)
+ */
+
+  double dy = Northing - ctx->False_Northing;
+  double dx = Easting - ctx->False_Easting;
+  double t;
+  double sin_PHI;
+  double PHI;
+  double lon;
+  int    origin = (dy == 0.0) & (dx == 0.0);
+  int    south = (ctx->Southern_Hemisphere != 0);
+
+  dy = south ? -dy : dy;
+  dx = south ? -dx : dx;
+  t = (fabs(fabs(ctx->Origin_Lat) - PI_OVER_2) > 1.0e-10) ? rho * ctx->tc / (ctx->a_mc)
+                                                          : rho * ctx->e4 / (ctx->two_a);
+  sin_PHI = (1.0 - t * t) / (1.0 + t * t);
+  sin_PHI = Latitude_Step(ctx, t, sin_PHI);
+  sin_PHI = Latitude_Step(ctx, t, sin_PHI);
+  PHI = PI_OVER_2 - 2.0 * Atan(t * Pow_Es(ctx, sin_PHI));
+  lon = ctx->Origin_Long + Atan2(dx, -dy);
+
+  lon = (lon > PI) ? lon - TWO_PI : ((lon < -PI) ? lon + TWO_PI : lon);
+
+  /* force distorted values to 90, -90 and 180, -180 degrees */
+  PHI = (PHI > PI_OVER_2) ? PI_OVER_2 : ((PHI < -PI_OVER_2) ? -PI_OVER_2 : PHI);
+  lon = (lon > PI) ? PI : ((lon < -PI) ? -PI : lon);
+
+  /* the origin is the pole */
+  PHI = origin ? PI_OVER_2 : PHI;
+  lon = origin ? ctx->Origin_Long : lon;
+
+  *Latitude = south ? -PHI : PHI;
+  *Longitude = south ? -lon : lon;
+} /* END OF Unproject_Point */
+
+
+BATCH_KERNEL
+static void Project_Block (const Polar_Stereographic_Context *ctx,
+                           const double *restrict Lat,
+                           const double *restrict Delta_Long,
+                           size_t Count,
+                           double *restrict Easting,
+                           double *restrict Northing)
+{ /* BEGIN Project_Block */
+/*
+ * The function Project_Block runs Project_Point over arrays of latitudes
+ * and longitude differences, several rows per vector instruction.
+ *
+ *    ctx        :  Polar Stereographic context               (input)
+ *    Lat        :  Latitudes, in radians                     (input)
+ *    Delta_Long :  Longitudes less the origin, in radians    (input)
+ *    Count      :  Number of rows                            (input)
+ *    Easting    :  Eastings (X), in meters                   (output)
+ *    Northing   :  Northings (Y), in meters                  (output)
+ */
+
+  size_t i;
+
+  for (i = 0; i < Count; i++)
+    Project_Point(ctx, Lat[i], Delta_Long[i], &Easting[i], &Northing[i]);
+} /* END OF Project_Block */
+
+
+BATCH_KERNEL
+static void Unproject_Block (const Polar_Stereographic_Context *ctx,
+                             const double *restrict Easting,
+                             const double *restrict Northing,
+                             const double *restrict Radius,
+                             size_t Count,
+                             double *restrict Latitude,
+                             double *restrict Longitude)
+{ /* BEGIN Unproject_Block */
+/*
+ * The function Unproject_Block runs Unproject_Point over arrays of
+ * eastings and northings, several rows per vector instruction.
+ *
+ *  ctx              : Polar Stereographic context              (input)
+ *  Easting          : Eastings (X), in meters                  (input)
+ *  Northing         : Northings (Y), in meters                 (input)
+ *  Radius           : Radii found by Check_Projected           (input)
+ *  Count            : Number of rows                           (input)
+ *  Latitude         : Latitudes, in radians                    (output)
+ *  Longitude        : Longitudes, in radians                   (output)
+ */
+
+  size_t i;
+
+  for (i = 0; i < Count; i++)
+    Unproject_Point(ctx, Easting[i], Northing[i], Radius[i], &Latitude[i], &Longitude[i]);
+} /* END OF Unproject_Block */
+
+
+
 long Set_Polar_Stereographic_Parameters (double a,
                                          double f,
                                          double Latitude_of_True_Scale,
@@ -160,11 +505,34 @@ long Set_Polar_Stereographic_Parameters (double a,
 
 {  /* BEGIN Set_Polar_Stereographic_Parameters   */
 /*  
- *  The function Set_Polar_Stereographic_Parameters receives the ellipsoid
+ *  The function Set_Polar_Stereographic_Parameters sets the file-scope
+ *  state used by the non-reentrant conversion functions.  See
+ *  Set_Polar_Stereographic_Parameters_Ctx.
+ */
+
+  return Set_Polar_Stereographic_Parameters_Ctx(&Polar_Context, a, f,
+                                                Latitude_of_True_Scale,
+                                                Longitude_Down_from_Pole,
+                                                False_Easting, False_Northing);
+} /* END OF Set_Polar_Stereographic_Parameters */
+
+
+long Set_Polar_Stereographic_Parameters_Ctx (Polar_Stereographic_Context *ctx,
+                                             double a,
+                                             double f,
+                                             double Latitude_of_True_Scale,
+                                             double Longitude_Down_from_Pole,
+                                             double False_Easting,
+                                             double False_Northing)
+
+{  /* BEGIN Set_Polar_Stereographic_Parameters_Ctx   */
+/*  
+ *  The function Set_Polar_Stereographic_Parameters_Ctx receives the ellipsoid
  *  parameters and Polar Stereograpic projection parameters as inputs, and
- *  sets the corresponding state variables.  If any errors occur, error
+ *  sets the corresponding state variables in ctx.  If any errors occur, error
  *  code(s) are returned by the function, otherwise POLAR_NO_ERROR is returned.
  *
+ *  ctx              : Polar Stereographic context                     (output)
  *  a                : Semi-major axis of ellipsoid, in meters         (input)
  *  f                : Flattening of ellipsoid					               (input)
  *  Latitude_of_True_Scale  : Latitude of true scale, in radians       (input)
@@ -204,71 +572,71 @@ long Set_Polar_Stereographic_Parameters (double a,
   if (!Error_Code)
   { /* no errors */
 
-    Polar_a = a;
-    two_Polar_a = 2.0 * Polar_a;
-    Polar_f = f;
+    ctx->a = a;
+    ctx->two_a = 2.0 * ctx->a;
+    ctx->f = f;
 
     if (Longitude_Down_from_Pole > PI)
       Longitude_Down_from_Pole -= TWO_PI;
     if (Latitude_of_True_Scale < 0)
     {
-      Southern_Hemisphere = 1;
-      Polar_Origin_Lat = -Latitude_of_True_Scale;
-      Polar_Origin_Long = -Longitude_Down_from_Pole;
+      ctx->Southern_Hemisphere = 1;
+      ctx->Origin_Lat = -Latitude_of_True_Scale;
+      ctx->Origin_Long = -Longitude_Down_from_Pole;
     }
     else
     {
-      Southern_Hemisphere = 0;
-      Polar_Origin_Lat = Latitude_of_True_Scale;
-      Polar_Origin_Long = Longitude_Down_from_Pole;
+      ctx->Southern_Hemisphere = 0;
+      ctx->Origin_Lat = Latitude_of_True_Scale;
+      ctx->Origin_Long = Longitude_Down_from_Pole;
     }
-    Polar_False_Easting = False_Easting;
-    Polar_False_Northing = False_Northing;
+    ctx->False_Easting = False_Easting;
+    ctx->False_Northing = False_Northing;
 
-    es2 = 2 * Polar_f - Polar_f * Polar_f;
-    es = sqrt(es2);
-    es_OVER_2 = es / 2.0;
+    es2 = 2 * ctx->f - ctx->f * ctx->f;
+    ctx->es = sqrt(es2);
+    ctx->es_OVER_2 = ctx->es / 2.0;
 
-    if (fabs(fabs(Polar_Origin_Lat) - PI_OVER_2) > 1.0e-10)
+    if (fabs(fabs(ctx->Origin_Lat) - PI_OVER_2) > 1.0e-10)
     {
-      slat = sin(Polar_Origin_Lat);
-      essin = es * slat;
-      pow_es = POLAR_POW(essin);
-      clat = cos(Polar_Origin_Lat);
+      slat = sin(ctx->Origin_Lat);
+      essin = ctx->es * slat;
+      pow_es = POLAR_POW(ctx, essin);
+      clat = cos(ctx->Origin_Lat);
       mc = clat / sqrt(1.0 - essin * essin);
-      Polar_a_mc = Polar_a * mc;
-      tc = tan(PI_Over_4 - Polar_Origin_Lat / 2.0) / pow_es;
+      ctx->a_mc = ctx->a * mc;
+      ctx->tc = tan(PI_Over_4 - ctx->Origin_Lat / 2.0) / pow_es;
     }
     else
     {
-      one_PLUS_es = 1.0 + es;
-      one_MINUS_es = 1.0 - es;
-      e4 = sqrt(pow(one_PLUS_es, one_PLUS_es) * pow(one_MINUS_es, one_MINUS_es));
+      one_PLUS_es = 1.0 + ctx->es;
+      one_MINUS_es = 1.0 - ctx->es;
+      ctx->e4 = sqrt(pow(one_PLUS_es, one_PLUS_es) * pow(one_MINUS_es, one_MINUS_es));
     }
 
     /* Calculate Radius */
-    Convert_Geodetic_To_Polar_Stereographic(0, Longitude_Down_from_Pole, 
-                                            &temp, &temp_northing);
-
-    Polar_Delta_Northing = temp_northing;
-    if(Polar_False_Northing)
-      Polar_Delta_Northing -= Polar_False_Northing;
-    if (Polar_Delta_Northing < 0)
-      Polar_Delta_Northing = -Polar_Delta_Northing;
-    Polar_Delta_Northing *= 1.01;
-
-    Polar_Delta_Easting = Polar_Delta_Northing;
-
-  /*  Polar_Delta_Easting = temp_northing;
-    if(Polar_False_Easting)
-      Polar_Delta_Easting -= Polar_False_Easting;
-    if (Polar_Delta_Easting < 0)
-      Polar_Delta_Easting = -Polar_Delta_Easting;
-    Polar_Delta_Easting *= 1.01;*/
+    Convert_Geodetic_To_Polar_Stereographic_Ctx(ctx, 0, Longitude_Down_from_Pole,
+                                                &temp, &temp_northing);
+
+    ctx->Delta_Northing = temp_northing;
+    if(ctx->False_Northing)
+      ctx->Delta_Northing -= ctx->False_Northing;
+    if (ctx->Delta_Northing < 0)
+      ctx->Delta_Northing = -ctx->Delta_Northing;
+    ctx->Delta_Northing *= 1.01;
+
+    ctx->Delta_Easting = ctx->Delta_Northing;
+
+  /*  ctx->Delta_Easting = temp_northing;
+    if(ctx->False_Easting)
+      ctx->Delta_Easting -= ctx->False_Easting;
+    if (ctx->Delta_Easting < 0)
+      ctx->Delta_Easting = -ctx->Delta_Easting;
+    ctx->Delta_Easting *= 1.01;*/
   }
 
   return (Error_Code);
-} /* END OF Set_Polar_Stereographic_Parameters */
+} /* END OF Set_Polar_Stereographic_Parameters_Ctx */
 
 
 
@@ -283,7 +651,30 @@ void Get_Polar_Stereographic_Parameters (double *a,
 /*
  * The function Get_Polar_Stereographic_Parameters returns the current
  * ellipsoid parameters and Polar projection parameters.
+ */
+
+  Get_Polar_Stereographic_Parameters_Ctx(&Polar_Context, a, f,
+                                         Latitude_of_True_Scale,
+                                         Longitude_Down_from_Pole,
+                                         False_Easting, False_Northing);
+  return;
+} /* END OF Get_Polar_Stereographic_Parameters */
+
+
+void Get_Polar_Stereographic_Parameters_Ctx (const Polar_Stereographic_Context *ctx,
+                                             double *a,
+                                             double *f,
+                                             double *Latitude_of_True_Scale,
+                                             double *Longitude_Down_from_Pole,
+                                             double *False_Easting,
+                                             double *False_Northing)
+
+{ /* BEGIN Get_Polar_Stereographic_Parameters_Ctx  */
+/*
+ * The function Get_Polar_Stereographic_Parameters_Ctx returns the ellipsoid
+ * parameters and Polar projection parameters held in ctx.
  *
+ *  ctx              : Polar Stereographic context                     (input)
  *  a                : Semi-major axis of ellipsoid, in meters         (output)
  *  f                : Flattening of ellipsoid					               (output)
  *  Latitude_of_True_Scale  : Latitude of true scale, in radians       (output)
@@ -292,14 +683,14 @@ void Get_Polar_Stereographic_Parameters (double *a,
  *  False_Northing   : Northing (Y) at center of projection, in meters (output)
  */
 
-  *a = Polar_a;
-  *f = Polar_f;
-  *Latitude_of_True_Scale = Polar_Origin_Lat;
-  *Longitude_Down_from_Pole = Polar_Origin_Long;
-  *False_Easting = Polar_False_Easting;
-  *False_Northing = Polar_False_Northing;
+  *a = ctx->a;
+  *f = ctx->f;
+  *Latitude_of_True_Scale = ctx->Origin_Lat;
+  *Longitude_Down_from_Pole = ctx->Origin_Long;
+  *False_Easting = ctx->False_Easting;
+  *False_Northing = ctx->False_Northing;
   return;
-} /* END OF Get_Polar_Stereographic_Parameters */
+} /* END OF Get_Polar_Stereographic_Parameters_Ctx */
 
 
 long Convert_Geodetic_To_Polar_Stereographic (double Latitude,
@@ -311,94 +702,48 @@ long Convert_Geodetic_To_Polar_Stereographic (double Latitude,
 
 /*
  * The function Convert_Geodetic_To_Polar_Stereographic converts geodetic
+ * coordinates using the file-scope state.  See
+ * Convert_Geodetic_To_Polar_Stereographic_Ctx.
+ */
+
+  return Convert_Geodetic_To_Polar_Stereographic_Ctx(&Polar_Context, Latitude,
+                                                     Longitude, Easting, Northing);
+} /* END OF Convert_Geodetic_To_Polar_Stereographic */
+
+
+long Convert_Geodetic_To_Polar_Stereographic_Ctx (const Polar_Stereographic_Context *ctx,
+                                                  double Latitude,
+                                                  double Longitude,
+                                                  double *Easting,
+                                                  double *Northing)
+
+{  /* BEGIN Convert_Geodetic_To_Polar_Stereographic_Ctx */
+
+/*
+ * The function Convert_Geodetic_To_Polar_Stereographic_Ctx converts geodetic
  * coordinates (latitude and longitude) to Polar Stereographic coordinates
- * (easting and northing), according to the current ellipsoid
- * and Polar Stereographic projection parameters. If any errors occur, error
+ * (easting and northing), according to the ellipsoid and Polar
+ * Stereographic projection parameters held in ctx. If any errors occur, error
  * code(s) are returned by the function, otherwise POLAR_NO_ERROR is returned.
  *
+ *    ctx        :  Polar Stereographic context               (input)
  *    Latitude   :  Latitude, in radians                      (input)
  *    Longitude  :  Longitude, in radians                     (input)
  *    Easting    :  Easting (X), in meters                    (output)
  *    Northing   :  Northing (Y), in meters                   (output)
  */
 
+  double Lat;
   double dlam;
-  double slat;
-  double essin;
-  double t;
-  double rho;
-  double pow_es;
-  long Error_Code = POLAR_NO_ERROR;
-
-  if ((Latitude < -PI_OVER_2) || (Latitude > PI_OVER_2))
-  {   /* Latitude out of range */
-    Error_Code |= POLAR_LAT_ERROR;
-  }
-  if ((Latitude < 0) && (Southern_Hemisphere == 0))
-  {   /* Latitude and Origin Latitude in different hemispheres */
-    Error_Code |= POLAR_LAT_ERROR;
-  }
-  if ((Latitude > 0) && (Southern_Hemisphere == 1))
-  {   /* Latitude and Origin Latitude in different hemispheres */
-    Error_Code |= POLAR_LAT_ERROR;
-  }
-  if ((Longitude < -PI) || (Longitude > TWO_PI))
-  {  /* Longitude out of range */
-    Error_Code |= POLAR_LON_ERROR;
-  }
-
+  long Error_Code;
 
+  Error_Code = Check_Geodetic(ctx, Latitude, Longitude, &Lat, &dlam);
   if (!Error_Code)
   {  /* no errors */
-
-    if (fabs(fabs(Latitude) - PI_OVER_2) < 1.0e-10)
-    {
-      *Easting = Polar_False_Easting;
-      *Northing = Polar_False_Northing;
-    }
-    else
-    {
-      if (Southern_Hemisphere != 0)
-      {
-        Longitude *= -1.0;
-        Latitude *= -1.0;
-      }
-      dlam = Longitude - Polar_Origin_Long;
-      if (dlam > PI)
-      {
-        dlam -= TWO_PI;
-      }
-      if (dlam < -PI)
-      {
-        dlam += TWO_PI;
-      }
-      slat = sin(Latitude);
-      essin = es * slat;
-      pow_es = POLAR_POW(essin);
-      t = tan(PI_Over_4 - Latitude / 2.0) / pow_es;
-
-      if (fabs(fabs(Polar_Origin_Lat) - PI_OVER_2) > 1.0e-10)
-        rho = Polar_a_mc * t / tc;
-      else
-        rho = two_Polar_a * t / e4;
-
-
-      if (Southern_Hemisphere != 0)
-      {
-        *Easting = -(rho * sin(dlam) - Polar_False_Easting);
-     //   *Easting *= -1.0;
-        *Northing = rho * cos(dlam) + Polar_False_Northing;
-      }
-      else
-      {
-        *Easting = rho * sin(dlam) + Polar_False_Easting;
-        *Northing = -rho * cos(dlam) + Polar_False_Northing;
-      }
-
-    }
+    Project_Point(ctx, Lat, dlam, Easting, Northing);
   }
   return (Error_Code);
-} /* END OF Convert_Geodetic_To_Polar_Stereographic */
+} /* END OF Convert_Geodetic_To_Polar_Stereographic_Ctx */
 
 
 long Convert_Polar_Stereographic_To_Geodetic (double Easting,
@@ -409,12 +754,31 @@ long Convert_Polar_Stereographic_To_Geodetic (double Easting,
 { /*  BEGIN Convert_Polar_Stereographic_To_Geodetic  */
 /*
  *  The function Convert_Polar_Stereographic_To_Geodetic converts Polar
+ *  Stereographic coordinates using the file-scope state.  See
+ *  Convert_Polar_Stereographic_To_Geodetic_Ctx.
+ */
+
+  return Convert_Polar_Stereographic_To_Geodetic_Ctx(&Polar_Context, Easting,
+                                                     Northing, Latitude, Longitude);
+} /* END OF Convert_Polar_Stereographic_To_Geodetic */
+
+
+long Convert_Polar_Stereographic_To_Geodetic_Ctx (const Polar_Stereographic_Context *ctx,
+                                                  double Easting,
+                                                  double Northing,
+                                                  double *Latitude,
+                                                  double *Longitude)
+
+{ /*  BEGIN Convert_Polar_Stereographic_To_Geodetic_Ctx  */
+/*
+ *  The function Convert_Polar_Stereographic_To_Geodetic_Ctx converts Polar
  *  Stereographic coordinates (easting and northing) to geodetic
- *  coordinates (latitude and longitude) according to the current ellipsoid
- *  and Polar Stereographic projection Parameters. If any errors occur, the
- *  code(s) are returned by the function, otherwise POLAR_NO_ERROR
+ *  coordinates (latitude and longitude) according to the ellipsoid and
+ *  Polar Stereographic projection Parameters held in ctx. If any errors
+ *  occur, the code(s) are returned by the function, otherwise POLAR_NO_ERROR
  *  is returned.
  *
+ *  ctx              : Polar Stereographic context              (input)
  *  Easting          : Easting (X), in meters                   (input)
  *  Northing         : Northing (Y), in meters                  (input)
  *  Latitude         : Latitude, in radians                     (output)
@@ -422,102 +786,198 @@ long Convert_Polar_Stereographic_To_Geodetic (double Easting,
  *
  */
 
-  double dy = 0, dx = 0;
-  double rho = 0;
-  double t;
-  double PHI, sin_PHI;
-  double tempPHI = 0.0;
-  double essin;
-  double pow_es;
-  double delta_radius;
-  long Error_Code = POLAR_NO_ERROR;
-  double min_easting = Polar_False_Easting - Polar_Delta_Easting;
-  double max_easting = Polar_False_Easting + Polar_Delta_Easting;
-  double min_northing = Polar_False_Northing - Polar_Delta_Northing;
-  double max_northing = Polar_False_Northing + Polar_Delta_Northing;
+  double rho;
+  long Error_Code;
 
-  if (Easting > max_easting || Easting < min_easting)
-  { /* Easting out of range */
-    Error_Code |= POLAR_EASTING_ERROR;
-  }
-  if (Northing > max_northing || Northing < min_northing)
-  { /* Northing out of range */
-    Error_Code |= POLAR_NORTHING_ERROR;
+  Error_Code = Check_Projected(ctx, Easting, Northing, &rho);
+  if (!Error_Code)
+  { /* no errors */
+    Unproject_Point(ctx, Easting, Northing, rho, Latitude, Longitude);
   }
+  return (Error_Code);
+} /* END OF Convert_Polar_Stereographic_To_Geodetic_Ctx */
 
-  if (!Error_Code)
-  {
-    dy = Northing - Polar_False_Northing;
-    dx = Easting - Polar_False_Easting;
 
-    /* Radius of point with origin of false easting, false northing */
-    rho = sqrt(dx * dx + dy * dy);   
-    
-    delta_radius = sqrt(Polar_Delta_Easting * Polar_Delta_Easting + Polar_Delta_Northing * Polar_Delta_Northing);
+long Convert_Geodetic_To_Polar_Stereographic_Batch (const double *Latitude,
+                                                    const double *Longitude,
+                                                    size_t Count,
+                                                    double *Easting,
+                                                    double *Northing,
+                                                    long *Error_Codes)
 
-    if(rho > delta_radius)
-    { /* Point is outside of projection area */
-      Error_Code |= POLAR_RADIUS_ERROR;
-    }
+{  /* BEGIN Convert_Geodetic_To_Polar_Stereographic_Batch */
 
-    if (!Error_Code)
-    { /* no errors */
-      if ((dy == 0.0) && (dx == 0.0))
-      {
-        *Latitude = PI_OVER_2;
-        *Longitude = Polar_Origin_Long;
+/*
+ * The function Convert_Geodetic_To_Polar_Stereographic_Batch converts
+ * geodetic coordinates using the file-scope state.  See
+ * Convert_Geodetic_To_Polar_Stereographic_Batch_Ctx.
+ */
 
-      }
-      else
-      {
-        if (Southern_Hemisphere != 0)
-        {
-          dy *= -1.0;
-          dx *= -1.0;
-        }
-
-        if (fabs(fabs(Polar_Origin_Lat) - PI_OVER_2) > 1.0e-10)
-          t = rho * tc / (Polar_a_mc);
-        else
-          t = rho * e4 / (two_Polar_a);
-        PHI = PI_OVER_2 - 2.0 * atan(t);
-        while (fabs(PHI - tempPHI) > 1.0e-10)
-        {
-          tempPHI = PHI;
-          sin_PHI = sin(PHI);
-          essin =  es * sin_PHI;
-          pow_es = POLAR_POW(essin);
-          PHI = PI_OVER_2 - 2.0 * atan(t * pow_es);
-        }
-        *Latitude = PHI;
-        *Longitude = Polar_Origin_Long + atan2(dx, -dy);
-
-        if (*Longitude > PI)
-          *Longitude -= TWO_PI;
-        else if (*Longitude < -PI)
-          *Longitude += TWO_PI;
-
-
-        if (*Latitude > PI_OVER_2)  /* force distorted values to 90, -90 degrees */
-          *Latitude = PI_OVER_2;
-        else if (*Latitude < -PI_OVER_2)
-          *Latitude = -PI_OVER_2;
-
-        if (*Longitude > PI)  /* force distorted values to 180, -180 degrees */
-          *Longitude = PI;
-        else if (*Longitude < -PI)
-          *Longitude = -PI;
+  return Convert_Geodetic_To_Polar_Stereographic_Batch_Ctx(&Polar_Context, Latitude, Longitude,
+                                                           Count, Easting, Northing, Error_Codes);
+} /* END OF Convert_Geodetic_To_Polar_Stereographic_Batch */
+
+
+long Convert_Geodetic_To_Polar_Stereographic_Batch_Ctx (const Polar_Stereographic_Context *ctx,
+                                                        const double *Latitude,
+                                                        const double *Longitude,
+                                                        size_t Count,
+                                                        double *Easting,
+                                                        double *Northing,
+                                                        long *Error_Codes)
 
+{  /* BEGIN Convert_Geodetic_To_Polar_Stereographic_Batch_Ctx */
+
+/*
+ * The function Convert_Geodetic_To_Polar_Stereographic_Batch_Ctx converts
+ * Count geodetic coordinates (latitude and longitude) to Polar
+ * Stereographic coordinates (easting and northing), according to the
+ * ellipsoid and Polar Stereographic projection parameters held in ctx.
+ * Each row gets exactly what Convert_Geodetic_To_Polar_Stereographic_Ctx
+ * returns for it; rows with errors are left unchanged.  The number of such
+ * rows is returned by the function.
+ *
+ *    ctx        :  Polar Stereographic context               (input)
+ *    Latitude   :  Latitudes, in radians                     (input)
+ *    Longitude  :  Longitudes, in radians                    (input)
+ *    Count      :  Number of coordinates                     (input)
+ *    Easting    :  Eastings (X), in meters                   (output)
+ *    Northing   :  Northings (Y), in meters                  (output)
+ *    Error_Codes:  Error code of each row, or NULL           (output)
+ */
+
+  double lat[BATCH_BLOCK];
+  double dlam[BATCH_BLOCK];
+  double east[BATCH_BLOCK];
+  double north[BATCH_BLOCK];
+  long   code[BATCH_BLOCK];
+  size_t start;
+  size_t n;
+  size_t i;
+  long   Error_Count = 0;
+
+  for (start = 0; start < Count; start += n)
+  {
+    n = Count - start;
+    if (n > BATCH_BLOCK)
+      n = BATCH_BLOCK;
+    for (i = 0; i < n; i++)
+    {
+      code[i] = Check_Geodetic(ctx, Latitude[start + i], Longitude[start + i], &lat[i], &dlam[i]);
+      if (code[i])
+      { /* project a harmless stand-in, the result is dropped */
+        lat[i] = 0.0;
+        dlam[i] = 0.0;
       }
-      if (Southern_Hemisphere != 0)
+    }
+    Project_Block(ctx, lat, dlam, n, east, north);
+    for (i = 0; i < n; i++)
+    {
+      if (code[i])
+        Error_Count++;
+      else
       {
-        *Latitude *= -1.0;
-        *Longitude *= -1.0;
+        Easting[start + i] = east[i];
+        Northing[start + i] = north[i];
       }
+      if (Error_Codes)
+        Error_Codes[start + i] = code[i];
     }
   }
-  return (Error_Code);
-} /* END OF Convert_Polar_Stereographic_To_Geodetic */
+  return (Error_Count);
+} /* END OF Convert_Geodetic_To_Polar_Stereographic_Batch_Ctx */
+
+
+long Convert_Polar_Stereographic_To_Geodetic_Batch (const double *Easting,
+                                                    const double *Northing,
+                                                    size_t Count,
+                                                    double *Latitude,
+                                                    double *Longitude,
+                                                    long *Error_Codes)
+
+{ /*  BEGIN Convert_Polar_Stereographic_To_Geodetic_Batch  */
+/*
+ *  The function Convert_Polar_Stereographic_To_Geodetic_Batch converts
+ *  Polar Stereographic coordinates using the file-scope state.  See
+ *  Convert_Polar_Stereographic_To_Geodetic_Batch_Ctx.
+ */
+
+  return Convert_Polar_Stereographic_To_Geodetic_Batch_Ctx(&Polar_Context, Easting, Northing,
+                                                           Count, Latitude, Longitude, Error_Codes);
+} /* END OF Convert_Polar_Stereographic_To_Geodetic_Batch */
 
 
+long Convert_Polar_Stereographic_To_Geodetic_Batch_Ctx (const Polar_Stereographic_Context *ctx,
+                                                        const double *Easting,
+                                                        const double *Northing,
+                                                        size_t Count,
+                                                        double *Latitude,
+                                                        double *Longitude,
+                                                        long *Error_Codes)
 
+{ /*  BEGIN Convert_Polar_Stereographic_To_Geodetic_Batch_Ctx  */
+/*
+ *  The function Convert_Polar_Stereographic_To_Geodetic_Batch_Ctx converts
+ *  Count Polar Stereographic coordinates (easting and northing) to geodetic
+ *  coordinates (latitude and longitude) according to the ellipsoid and
+ *  Polar Stereographic projection parameters held in ctx.  Each row gets
+ *  exactly what Convert_Polar_Stereographic_To_Geodetic_Ctx returns for it;
+ *  rows with errors are left unchanged.  The number of such rows is
+ *  returned by the function.
+ *
+ *  ctx              : Polar Stereographic context              (input)
+ *  Easting          : Eastings (X), in meters                  (input)
+ *  Northing         : Northings (Y), in meters                 (input)
+ *  Count            : Number of coordinates                    (input)
+ *  Latitude         : Latitudes, in radians                    (output)
+ *  Longitude        : Longitudes, in radians                   (output)
+ *  Error_Codes      : Error code of each row, or NULL          (output)
+ */
+
+  double east[BATCH_BLOCK];
+  double north[BATCH_BLOCK];
+  double rho[BATCH_BLOCK];
+  double lat[BATCH_BLOCK];
+  double lon[BATCH_BLOCK];
+  long   code[BATCH_BLOCK];
+  size_t start;
+  size_t n;
+  size_t i;
+  long   Error_Count = 0;
+
+  for (start = 0; start < Count; start += n)
+  {
+    n = Count - start;
+    if (n > BATCH_BLOCK)
+      n = BATCH_BLOCK;
+    for (i = 0; i < n; i++)
+    {
+      code[i] = Check_Projected(ctx, Easting[start + i], Northing[start + i], &rho[i]);
+      if (code[i])
+      { /* unproject a harmless stand-in, the result is dropped */
+        east[i] = ctx->False_Easting;
+        north[i] = ctx->False_Northing;
+        rho[i] = 0.0;
+      }
+      else
+      {
+        east[i] = Easting[start + i];
+        north[i] = Northing[start + i];
+      }
+    }
+    Unproject_Block(ctx, east, north, rho, n, lat, lon);
+    for (i = 0; i < n; i++)
+    {
+      if (code[i])
+        Error_Count++;
+      else
+      {
+        Latitude[start + i] = lat[i];
+        Longitude[start + i] = lon[i];
+      }
+      if (Error_Codes)
+        Error_Codes[start + i] = code[i];
+    }
+  }
+  return (Error_Count);
+} /* END OF Convert_Polar_Stereographic_To_Geodetic_Batch_Ctx */
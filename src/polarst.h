@@ -105,6 +105,42 @@
   #define POLAR_INV_F_ERROR             0x0080
   #define POLAR_RADIUS_ERROR            0x0100
 
+
+  #include <stddef.h>
+
+
+/**********************************************************************/
+/*
+ *                        TYPES
+ */
+
+/*
+ * A Polar_Stereographic_Context holds the ellipsoid and projection state
+ * that the non-reentrant functions below keep in file-scope variables.
+ * Each thread of execution that converts coordinates concurrently must use
+ * its own context (or share one that is no longer being set).  A context
+ * must be set with Set_Polar_Stereographic_Parameters_Ctx before use.
+ */
+
+  typedef struct Polar_Stereographic_Context_Value
+  {
+    double a;                    /* Semi-major axis of ellipsoid in meters  */
+    double f;                    /* Flattening of ellipsoid                 */
+    double es;                   /* Eccentricity of ellipsoid               */
+    double es_OVER_2;            /* es / 2.0                                */
+    double Southern_Hemisphere;  /* Flag variable                           */
+    double tc;
+    double e4;
+    double a_mc;                 /* a * mc                                  */
+    double two_a;                /* 2.0 * a                                 */
+    double Origin_Lat;           /* Latitude of origin in radians           */
+    double Origin_Long;          /* Longitude of origin in radians          */
+    double False_Easting;        /* False easting in meters                 */
+    double False_Northing;       /* False northing in meters                */
+    double Delta_Easting;        /* Maximum variance for easting and        */
+    double Delta_Northing;       /* northing values                         */
+  } Polar_Stereographic_Context;
+
 /**********************************************************************/
 /*
  *                        FUNCTION PROTOTYPES
@@ -192,6 +228,144 @@ extern "C" {
  *  Latitude         : Latitude, in radians                     (output)
  *  Longitude        : Longitude, in radians                    (output)
  *
+ */
+
+  long Set_Polar_Stereographic_Parameters_Ctx (Polar_Stereographic_Context *ctx,
+                                               double a,
+                                               double f,
+                                               double Latitude_of_True_Scale,
+                                               double Longitude_Down_from_Pole,
+                                               double False_Easting,
+                                               double False_Northing);
+/*
+ *  The function Set_Polar_Stereographic_Parameters_Ctx is the reentrant form
+ *  of Set_Polar_Stereographic_Parameters.  It sets the state variables held
+ *  in the context ctx instead of the file-scope state.
+ *
+ *  ctx              : Polar Stereographic context                     (output)
+ */
+
+
+  void Get_Polar_Stereographic_Parameters_Ctx (const Polar_Stereographic_Context *ctx,
+                                               double *a,
+                                               double *f,
+                                               double *Latitude_of_True_Scale,
+                                               double *Longitude_Down_from_Pole,
+                                               double *False_Easting,
+                                               double *False_Northing);
+/*
+ * The function Get_Polar_Stereographic_Parameters_Ctx returns the ellipsoid
+ * parameters and Polar projection parameters held in the context ctx.
+ *
+ *  ctx              : Polar Stereographic context                     (input)
+ */
+
+
+  long Convert_Geodetic_To_Polar_Stereographic_Ctx (const Polar_Stereographic_Context *ctx,
+                                                    double Latitude,
+                                                    double Longitude,
+                                                    double *Easting,
+                                                    double *Northing);
+/*
+ * The function Convert_Geodetic_To_Polar_Stereographic_Ctx is the reentrant
+ * form of Convert_Geodetic_To_Polar_Stereographic.  It uses the ellipsoid
+ * and projection parameters held in the context ctx.
+ *
+ *    ctx        :  Polar Stereographic context               (input)
+ */
+
+
+  long Convert_Polar_Stereographic_To_Geodetic_Ctx (const Polar_Stereographic_Context *ctx,
+                                                    double Easting,
+                                                    double Northing,
+                                                    double *Latitude,
+                                                    double *Longitude);
+/*
+ * The function Convert_Polar_Stereographic_To_Geodetic_Ctx is the reentrant
+ * form of Convert_Polar_Stereographic_To_Geodetic.  It uses the ellipsoid
+ * and projection parameters held in the context ctx.
+ *
+ *  ctx              : Polar Stereographic context              (input)
+ */
+
+
+  long Convert_Geodetic_To_Polar_Stereographic_Batch (const double *Latitude,
+                                                      const double *Longitude,
+                                                      size_t Count,
+                                                      double *Easting,
+                                                      double *Northing,
+                                                      long *Error_Codes);
+/*
+ * The function Convert_Geodetic_To_Polar_Stereographic_Batch converts Count
+ * geodetic coordinates, all in the hemisphere of the projection, to Polar
+ * Stereographic coordinates according to the current ellipsoid and
+ * projection parameters, with a vectorized kernel.  Each row gets the
+ * result and error code that Convert_Geodetic_To_Polar_Stereographic
+ * returns for it; rows with errors are left unchanged.  The number of rows
+ * with errors is returned by the function.
+ *
+ *    Latitude   :  Latitudes, in radians                     (input)
+ *    Longitude  :  Longitudes, in radians                    (input)
+ *    Count      :  Number of coordinates                     (input)
+ *    Easting    :  Eastings (X), in meters                   (output)
+ *    Northing   :  Northings (Y), in meters                  (output)
+ *    Error_Codes:  Error code of each row, or NULL           (output)
+ */
+
+
+  long Convert_Geodetic_To_Polar_Stereographic_Batch_Ctx (const Polar_Stereographic_Context *ctx,
+                                                          const double *Latitude,
+                                                          const double *Longitude,
+                                                          size_t Count,
+                                                          double *Easting,
+                                                          double *Northing,
+                                                          long *Error_Codes);
+/*
+ * The function Convert_Geodetic_To_Polar_Stereographic_Batch_Ctx is the
+ * reentrant form of Convert_Geodetic_To_Polar_Stereographic_Batch.  It uses
+ * the ellipsoid and projection parameters held in the context ctx.
+ *
+ *  ctx              : Polar Stereographic context              (input)
+ */
+
+
+  long Convert_Polar_Stereographic_To_Geodetic_Batch (const double *Easting,
+                                                      const double *Northing,
+                                                      size_t Count,
+                                                      double *Latitude,
+                                                      double *Longitude,
+                                                      long *Error_Codes);
+/*
+ * The function Convert_Polar_Stereographic_To_Geodetic_Batch converts
+ * Count Polar Stereographic coordinates to geodetic coordinates according
+ * to the current ellipsoid and projection parameters, with a vectorized
+ * kernel.  Each row gets the result and error code that
+ * Convert_Polar_Stereographic_To_Geodetic returns for it; rows with errors
+ * are left unchanged.  The number of rows with errors is returned by the
+ * function.
+ *
+ *  Easting          : Eastings (X), in meters                  (input)
+ *  Northing         : Northings (Y), in meters                 (input)
+ *  Count            : Number of coordinates                    (input)
+ *  Latitude         : Latitudes, in radians                    (output)
+ *  Longitude        : Longitudes, in radians                   (output)
+ *  Error_Codes      : Error code of each row, or NULL          (output)
+ */
+
+
+  long Convert_Polar_Stereographic_To_Geodetic_Batch_Ctx (const Polar_Stereographic_Context *ctx,
+                                                          const double *Easting,
+                                                          const double *Northing,
+                                                          size_t Count,
+                                                          double *Latitude,
+                                                          double *Longitude,
+                                                          long *Error_Codes);
+/*
+ * The function Convert_Polar_Stereographic_To_Geodetic_Batch_Ctx is the
+ * reentrant form of Convert_Polar_Stereographic_To_Geodetic_Batch.  It uses
+ * the ellipsoid and projection parameters held in the context ctx.
+ *
+ *  ctx              : Polar Stereographic context              (input)
  */
 
   #ifdef __cplusplus
@@ -48,6 +48,10 @@
  *    Further information on TRANSVERSE MERCATOR can be found in the 
  *    Reuse Manual.
  *
+ *    The Kruger series engine follows C. F. F. Karney, "Transverse
+ *    Mercator with an accuracy of a few nanometers", J. Geodesy 85(8),
+ *    475-485 (2011).
+ *
  *    TRANSVERSE MERCATOR originated from :  
  *                      U.S. Army Topographic Engineering Center
  *                      Geospatial Information Division
@@ -86,10 +90,18 @@
  */
 
 #include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "kernel.h"
 #include "tranmerc.h"
 
 /*
  *    math.h      - Standard C math library
+ *    stddef.h    - Is for size_t
+ *    stdint.h    - Is for uint64_t
+ *    string.h    - Is for memcpy
+ *    kernel.h    - Is for the batch kernel attributes and math
  *    tranmerc.h  - Is for prototype error checking
  */
 
@@ -106,17 +118,16 @@
 #define MIN_SCALE_FACTOR  0.3
 #define MAX_SCALE_FACTOR  3.0
 
-#define SPHTMD(Latitude) ((double) (TranMerc_ap * Latitude \
-      - TranMerc_bp * sin(2.e0 * Latitude) + TranMerc_cp * sin(4.e0 * Latitude) \
-      - TranMerc_dp * sin(6.e0 * Latitude) + TranMerc_ep * sin(8.e0 * Latitude) ) )
-
-#define SPHSN(Latitude) ((double) (TranMerc_a / sqrt( 1.e0 - TranMerc_es * \
-      pow(sin(Latitude), 2))))
+#define ROUND_BITS   UINT64_C(0x4338000000000000) /* Bits of ROUND_MAGIC       */
+#define INV_LN2      1.44269504088896338700e+00  /* 1 over ln(2)              */
+#define LN2_HI       6.93147180369123816490e-01  /* ln(2), first 32 bits      */
+#define LN2_LO       1.90821492927058770002e-10  /* ln(2) less LN2_HI         */
+#define FAST_ROUND_MAGIC  12582912.0f           /* 1.5 * 2^23, rounds a float */
+#define FAST_PIO2_1  1.5703125f                  /* PI over 2, first 11 bits   */
+#define FAST_PIO2_2  4.837512969970703125e-4f    /* next 11 bits               */
+#define FAST_PIO2_3  7.54978995489188216e-8f     /* PI over 2 less the above   */
 
-#define SPHSR(Latitude) ((double) (TranMerc_a * (1.e0 - TranMerc_es) / \
-    pow(DENOM(Latitude), 3)))
-
-#define DENOM(Latitude) ((double) (sqrt(1.e0 - TranMerc_es * pow(sin(Latitude),2))))
+#define BATCH_BLOCK  256  /* Rows projected at a time by the batch function */
 
 
 /**************************************************************************/
@@ -124,29 +135,35 @@
  *
  */
 
-/* Ellipsoid Parameters, default to WGS 84  */
-static double TranMerc_a = 6378137.0;              /* Semi-major axis of ellipsoid in meters */
-static double TranMerc_f = 1 / 298.257223563;      /* Flattening of ellipsoid  */
-static double TranMerc_es = 0.0066943799901413800; /* Eccentricity (0.08181919084262188000) squared */
-static double TranMerc_ebs = 0.0067394967565869;   /* Second Eccentricity squared */
-
-/* Transverse_Mercator projection Parameters */
-static double TranMerc_Origin_Lat = 0.0;           /* Latitude of origin in radians */
-static double TranMerc_Origin_Long = 0.0;          /* Longitude of origin in radians */
-static double TranMerc_False_Northing = 0.0;       /* False northing in meters */
-static double TranMerc_False_Easting = 0.0;        /* False easting in meters */
-static double TranMerc_Scale_Factor = 1.0;         /* Scale factor  */
-
-/* Isometeric to geodetic latitude parameters, default to WGS 84 */
-static double TranMerc_ap = 6367449.1458008;
-static double TranMerc_bp = 16038.508696861;
-static double TranMerc_cp = 16.832613334334;
-static double TranMerc_dp = 0.021984404273757;
-static double TranMerc_ep = 3.1148371319283e-005;
-
-/* Maximum variance for easting and northing values for WGS 84. */
-static double TranMerc_Delta_Easting = 40000000.0;
-static double TranMerc_Delta_Northing = 40000000.0;
+/* State used by the non-reentrant functions, default to WGS 84 */
+static Transverse_Mercator_Context TranMerc_Context =
+  {
+    6378137.0,              /* Semi-major axis of ellipsoid in meters */
+    1 / 298.257223563,      /* Flattening of ellipsoid  */
+    0.0066943799901413800,  /* Eccentricity (0.08181919084262188000) squared */
+    0.0067394967565869,     /* Second Eccentricity squared */
+    0.0,                    /* Latitude of origin in radians */
+    0.0,                    /* Longitude of origin in radians */
+    0.0,                    /* False northing in meters */
+    0.0,                    /* False easting in meters */
+    1.0,                    /* Scale factor  */
+    6367449.1458008,        /* Isometeric to geodetic latitude parameters */
+    16038.508696861,
+    16.832613334334,
+    0.021984404273757,
+    3.1148371319283e-005,
+    40000000.0,             /* Maximum variance for easting and northing */
+    40000000.0,             /* values for WGS 84. */
+    0.0,                    /* True meridional distance of origin */
+    1 / 6378137.0,          /* Reciprocal of semi-major axis */
+    1 / (6378137.0 * (1 - 0.0066943799901413800)), /* and of equator meridian radius */
+    {1 / 2.0, 1 / 24.0, 1 / 720.0, 1 / 40320.0,   /* Inverse series denominators */
+     1.0, 1 / 6.0, 1 / 120.0, 1 / 5040.0},
+    TRANMERC_THOMAS,        /* Series engine, the Kruger coefficients are */
+                            /* computed when it is selected               */
+    0.0, 0.0, 0.0, 0.0,     /* Kruger eccentricity, radius and origin */
+    {0}, {0}, {0}           /* Kruger series */
+  };
 
 /* These state variables are for optimization purposes. The only function
  * that should modify them is Set_Tranverse_Mercator_Parameters.         */
@@ -158,6 +175,873 @@ static double TranMerc_Delta_Northing = 40000000.0;
  */
 
 
+static FORCE_INLINE double SPHTMD (const Transverse_Mercator_Context *ctx,
+                      double Latitude,
+                      double Sin_Lat,
+                      double Cos_Lat)
+{ /* BEGIN SPHTMD */
+  /*
+   * The function SPHTMD returns the true meridional distance of Latitude,
+   * ap * Latitude - bp * sin(2 Latitude) + cp * sin(4 Latitude)
+   * - dp * sin(6 Latitude) + ep * sin(8 Latitude), summed with Clenshaw's
+   * recurrence on the sine and cosine of Latitude instead of four sin calls.
+   *
+   *    ctx           : Transverse Mercator context                 (input)
+   *    Latitude      : Latitude in radians                         (input)
+   *    Sin_Lat       : Sine of Latitude                            (input)
+   *    Cos_Lat       : Cosine of Latitude                          (input)
+   */
+
+  double y = 2.e0 * (Cos_Lat * Cos_Lat - Sin_Lat * Sin_Lat); /* 2 cos(2 Latitude) */
+  double b1;
+  double b2;
+  double b3;
+  double b4;
+
+  b4 = ctx->ep;
+  b3 = y * b4 - ctx->dp;
+  b2 = y * b3 - b4 + ctx->cp;
+  b1 = y * b2 - b3 - ctx->bp;
+  return (ctx->ap * Latitude + b1 * 2.e0 * Sin_Lat * Cos_Lat);
+} /* END OF SPHTMD */
+
+
+static FORCE_INLINE uint64_t Double_Bits (double x)
+{ /* BEGIN Double_Bits */
+  /*
+   * The function Double_Bits returns the IEEE 754 representation of x.
+   *
+   *    x             : Value                                       (input)
+   */
+
+  uint64_t Bits;
+
+  memcpy(&Bits, &x, sizeof(Bits));
+  return (Bits);
+} /* END OF Double_Bits */
+
+
+static FORCE_INLINE double Bits_Double (uint64_t Bits)
+{ /* BEGIN Bits_Double */
+  /*
+   * The function Bits_Double returns the double whose IEEE 754
+   * representation is Bits.
+   *
+   *    Bits          : IEEE 754 representation                     (input)
+   */
+
+  double x;
+
+  memcpy(&x, &Bits, sizeof(x));
+  return (x);
+} /* END OF Bits_Double */
+
+
+static FORCE_INLINE double Exp (double x)
+{ /* BEGIN Exp */
+  /*
+   * The function Exp returns e to the power x, for |x| < 700, as 2^k times
+   * the Taylor series through the 13th power of the remainder x - k ln(2),
+   * which is at most ln(2) / 2.  The power of two is added to the exponent
+   * bits, so that, like Sin_Cos, it has no branches or library calls.
+   *
+   *    x             : Exponent                                    (input)
+   */
+
+  double q = x * INV_LN2 + ROUND_MAGIC;    /* k in its low bits */
+  double k = q - ROUND_MAGIC;
+  double r = (x - k * LN2_HI) - k * LN2_LO;
+  double p;
+
+  p = 1.e0 + r * (1.e0 + r * (0.5e0 + r * (1.66666666666666667e-01
+      + r * (4.16666666666666667e-02 + r * (8.33333333333333333e-03
+      + r * (1.38888888888888889e-03 + r * (1.98412698412698413e-04
+      + r * (2.48015873015873016e-05 + r * (2.75573192239858907e-06
+      + r * (2.75573192239858907e-07 + r * (2.50521083854417188e-08
+      + r * (2.08767569878680990e-09 + r * 1.60590438368216146e-10))))))))))));
+  return (Bits_Double(Double_Bits(p) + ((Double_Bits(q) - ROUND_BITS) << 52)));
+} /* END OF Exp */
+
+
+static FORCE_INLINE double Log (double x)
+{ /* BEGIN Log */
+  /*
+   * The function Log returns the natural logarithm of a normal x > 0 with
+   * the fdlibm polynomial, after taking the exponent k out of the bits of
+   * x so that the rest is between sqrt(2) / 2 and sqrt(2).  Like Sin_Cos
+   * it has no branches or library calls.
+   *
+   *    x             : Argument, normal and positive               (input)
+   */
+
+  /* shift the bits so that mantissas from sqrt(2) up carry into k */
+  uint64_t b = Double_Bits(x) + (UINT64_C(0x3ff0000000000000) - UINT64_C(0x3fe6a09e667f3bcd));
+  double k = Bits_Double(ROUND_BITS + ((b >> 52) - 1023)) - ROUND_MAGIC;
+  double f = Bits_Double((b & UINT64_C(0x000fffffffffffff)) + UINT64_C(0x3fe6a09e667f3bcd)) - 1.e0;
+  double hfsq = 0.5e0 * f * f;
+  double s = f / (2.e0 + f);
+  double z = s * s;
+  double w = z * z;
+  double r;
+
+  r = z * (6.666666666666735130e-01 + w * (2.857142874366239149e-01
+      + w * (1.818357216161805012e-01 + w * 1.479819860511658591e-01)))
+      + w * (3.999999999940941908e-01 + w * (2.222219843214978396e-01
+      + w * 1.531383769920937332e-01));
+  return (k * LN2_HI - ((hfsq - (s * (hfsq + r) + k * LN2_LO)) - f));
+} /* END OF Log */
+
+
+static FORCE_INLINE double Sqrt (double x)
+{ /* BEGIN Sqrt */
+  /*
+   * The function Sqrt returns the square root of x >= 0 from an estimate of
+   * its reciprocal taken from the exponent bits, four Newton steps that
+   * each double its 5 correct bits, and a last step on the root itself.
+   * It is exact to an ulp, and unlike sqrt it leaves no error handling
+   * branch that keeps loops over it from vectorizing.
+   *
+   *    x             : Argument, zero or more                      (input)
+   */
+
+  double r = Bits_Double(UINT64_C(0x5fe6eb50c7b537a9) - (Double_Bits(x) >> 1));
+  double h = 0.5e0 * x;
+  double y;
+
+  r = r * (1.5e0 - h * r * r);
+  r = r * (1.5e0 - h * r * r);
+  r = r * (1.5e0 - h * r * r);
+  r = r * (1.5e0 - h * r * r);
+  y = x * r;
+  return (y + 0.5e0 * r * (x - y * y));
+} /* END OF Sqrt */
+
+
+static FORCE_INLINE double Pow_E (const Transverse_Mercator_Context *ctx,
+                                  double Sin_Lat)
+{ /* BEGIN Pow_E */
+  /*
+   * The function Pow_E returns ((1 - e sin) / (1 + e sin))^(e / 2), that
+   * is exp(-e * atanh(e * Sin_Lat)), without calling pow: e * Sin_Lat is at
+   * most 0.09 for the accepted flattenings, where the atanh series through
+   * the 15th power and the exp series through the 6th are exact to double
+   * precision.
+   *
+   *    ctx           : Transverse Mercator context                 (input)
+   *    Sin_Lat       : Sine of latitude                            (input)
+   */
+
+  double x = ctx->e * Sin_Lat;
+  double x2 = x * x;
+  double y;
+
+  y = -ctx->e * x * (1.e0 + x2 * (3.33333333333333333e-01 + x2 * (2.0e-01
+      + x2 * (1.42857142857142857e-01 + x2 * (1.11111111111111111e-01
+      + x2 * (9.09090909090909091e-02 + x2 * (7.69230769230769231e-02
+      + x2 * 6.66666666666666667e-02)))))));
+  return (1.e0 + y * (1.e0 + y * (0.5e0 + y * (1.66666666666666667e-01
+          + y * (4.16666666666666667e-02 + y * (8.33333333333333333e-03
+          + y * 1.38888888888888889e-03))))));
+} /* END OF Pow_E */
+
+
+static FORCE_INLINE void Clenshaw_Step (double Coeff,
+                                        double Ar,
+                                        double Ai,
+                                        double *Yr,
+                                        double *Yi,
+                                        double *Zr,
+                                        double *Zi)
+{ /* BEGIN Clenshaw_Step */
+  /*
+   * The function Clenshaw_Step takes one step y(k) = a y(k+1) - y(k+2) + c(k)
+   * of Clenshaw's recurrence with complex a and y and real c.
+   *
+   *    Coeff         : Series coefficient c(k)                     (input)
+   *    Ar, Ai        : Real and imaginary parts of a               (input)
+   *    Yr, Yi        : y(k+1), replaced by y(k)                    (input/output)
+   *    Zr, Zi        : y(k+2), replaced by y(k+1)                  (input/output)
+   */
+
+  double r = Ar * *Yr - Ai * *Yi - *Zr + Coeff;
+  double i = Ar * *Yi + Ai * *Yr - *Zi;
+
+  *Zr = *Yr;
+  *Zi = *Yi;
+  *Yr = r;
+  *Yi = i;
+} /* END OF Clenshaw_Step */
+
+
+static FORCE_INLINE void Kruger_Sum (const double *Coeff,
+                                     double Sin_2x,
+                                     double Cos_2x,
+                                     double Sinh_2y,
+                                     double Cosh_2y,
+                                     double *Re,
+                                     double *Im)
+{ /* BEGIN Kruger_Sum */
+  /*
+   * The function Kruger_Sum returns the sum of Coeff[j-1] sin(2 j z) for j
+   * = 1 to 6 and z = x + i y, summed with Clenshaw's recurrence on
+   * 2 cos(2 z) from the sines and cosines of 2 x and 2 y.
+   *
+   *    Coeff         : Six series coefficients                     (input)
+   *    Sin_2x        : Sine of 2 x                                 (input)
+   *    Cos_2x        : Cosine of 2 x                               (input)
+   *    Sinh_2y       : Hyperbolic sine of 2 y                      (input)
+   *    Cosh_2y       : Hyperbolic cosine of 2 y                    (input)
+   *    Re            : Real part of the sum                        (output)
+   *    Im            : Imaginary part of the sum                   (output)
+   */
+
+  double ar = 2.e0 * Cos_2x * Cosh_2y;    /* 2 cos(2 z) */
+  double ai = -2.e0 * Sin_2x * Sinh_2y;
+  double sr = Sin_2x * Cosh_2y;           /* sin(2 z) */
+  double si = Cos_2x * Sinh_2y;
+  double yr = 0.e0;
+  double yi = 0.e0;
+  double zr = 0.e0;
+  double zi = 0.e0;
+
+  Clenshaw_Step(Coeff[5], ar, ai, &yr, &yi, &zr, &zi);
+  Clenshaw_Step(Coeff[4], ar, ai, &yr, &yi, &zr, &zi);
+  Clenshaw_Step(Coeff[3], ar, ai, &yr, &yi, &zr, &zi);
+  Clenshaw_Step(Coeff[2], ar, ai, &yr, &yi, &zr, &zi);
+  Clenshaw_Step(Coeff[1], ar, ai, &yr, &yi, &zr, &zi);
+  Clenshaw_Step(Coeff[0], ar, ai, &yr, &yi, &zr, &zi);
+  *Re = yr * sr - yi * si;
+  *Im = yr * si + yi * sr;
+} /* END OF Kruger_Sum */
+
+
+static FORCE_INLINE double Inv_Radical (double x)
+{ /* BEGIN Inv_Radical */
+  /*
+   * The function Inv_Radical returns 1 / sqrt(1 - x) for x = es * sin^2,
+   * without calling sqrt: x is at most 0.008 for the accepted flattenings,
+   * where the binomial series through x^8 is exact to double precision.
+   *
+   *    x             : es times the squared sine of latitude       (input)
+   */
+
+  return (1.e0 + x * (0.5e0 + x * (0.375e0 + x * (0.3125e0
+          + x * (0.2734375e0 + x * (0.24609375e0 + x * (0.2255859375e0
+          + x * (0.20947265625e0 + x * 0.196380615234375e0))))))));
+} /* END OF Inv_Radical */
+
+
+static long Check_Geodetic (const Transverse_Mercator_Context *ctx,
+                            double Latitude,
+                            double Longitude,
+                            double *Delta_Long)
+{ /* BEGIN Check_Geodetic */
+  /*
+   * The function Check_Geodetic checks a geodetic coordinate against the
+   * projection held in ctx and, if it can be projected, returns its
+   * longitude difference from the central meridian.  The error code(s) and
+   * warning are returned by the function, otherwise TRANMERC_NO_ERROR is
+   * returned.
+   *
+   *    ctx           : Transverse Mercator context                 (input)
+   *    Latitude      : Latitude in radians                         (input)
+   *    Longitude     : Longitude in radians                        (input)
+   *    Delta_Long    : Longitude less the central meridian         (output)
+   */
+
+  double dlam;    /* Delta longitude - Difference in Longitude       */
+  long    Error_Code = TRANMERC_NO_ERROR;
+  double temp_Origin;
+  double temp_Long;
+
+  if ((Latitude < -MAX_LAT) || (Latitude > MAX_LAT))
+  {  /* Latitude out of range */
+    Error_Code|= TRANMERC_LAT_ERROR;
+  }
+  if (Longitude > PI)
+    Longitude -= (2 * PI);
+  if ((Longitude < (ctx->Origin_Long - MAX_DELTA_LONG))
+      || (Longitude > (ctx->Origin_Long + MAX_DELTA_LONG)))
+  {
+    if (Longitude < 0)
+      temp_Long = Longitude + 2 * PI;
+    else
+      temp_Long = Longitude;
+    if (ctx->Origin_Long < 0)
+      temp_Origin = ctx->Origin_Long + 2 * PI;
+    else
+      temp_Origin = ctx->Origin_Long;
+    if ((temp_Long < (temp_Origin - MAX_DELTA_LONG))
+        || (temp_Long > (temp_Origin + MAX_DELTA_LONG)))
+      Error_Code|= TRANMERC_LON_ERROR;
+  }
+  if (!Error_Code)
+  { /* no errors */
+
+    /* 
+     *  Delta Longitude
+     */
+    dlam = Longitude - ctx->Origin_Long;
+
+    if (fabs(dlam) > (9.0 * PI / 180))
+    { /* Distortion will result if Longitude is more than 9 degrees from the Central Meridian */
+      Error_Code |= TRANMERC_LON_WARNING;
+    }
+
+    if (dlam > PI)
+      dlam -= (2 * PI);
+    if (dlam < -PI)
+      dlam += (2 * PI);
+    if (fabs(dlam) < 2.e-10)
+      dlam = 0.0;
+    *Delta_Long = dlam;
+  }
+  return (Error_Code);
+} /* END OF Check_Geodetic */
+
+
+static FORCE_INLINE void Project_Point (const Transverse_Mercator_Context *ctx,
+                                        double Latitude,
+                                        double dlam,
+                                        double *Easting,
+                                        double *Northing)
+{ /* BEGIN Project_Point */
+  /*
+   * The function Project_Point evaluates the Transverse Mercator series for
+   * a latitude and a longitude difference that Check_Geodetic accepted.  It
+   * is shared by the scalar and batch conversions, which therefore agree.
+   *
+   *    ctx           : Transverse Mercator context                 (input)
+   *    Latitude      : Latitude in radians                         (input)
+   *    dlam          : Longitude less the central meridian         (input)
+   *    Easting       : Easting/X in meters                         (output)
+   *    Northing      : Northing/Y in meters                        (output)
+   */
+
+  double c;       /* Cosine of latitude                          */
+  double c2;
+  double c3;
+  double c5;
+  double c7;
+  double dlam2;
+  double eta;     /* constant - TranMerc_ebs *c *c                   */
+  double eta2;
+  double eta3;
+  double eta4;
+  double s;       /* Sine of latitude                        */
+  double sn;      /* Radius of curvature in the prime vertical       */
+  double t;       /* Tangent of latitude                             */
+  double tan2;
+  double tan3;
+  double tan4;
+  double tan5;
+  double tan6;
+  double t1;      /* Term in coordinate conversion formula - GP to Y */
+  double t2;      /* Term in coordinate conversion formula - GP to Y */
+  double t3;      /* Term in coordinate conversion formula - GP to Y */
+  double t4;      /* Term in coordinate conversion formula - GP to Y */
+  double t5;      /* Term in coordinate conversion formula - GP to Y */
+  double t6;      /* Term in coordinate conversion formula - GP to Y */
+  double t7;      /* Term in coordinate conversion formula - GP to Y */
+  double t8;      /* Term in coordinate conversion formula - GP to Y */
+  double t9;      /* Term in coordinate conversion formula - GP to Y */
+  double tmd;     /* True Meridional distance                        */
+  double tmdo;    /* True Meridional distance for latitude of origin */
+
+  Sin_Cos(Latitude, &s, &c);
+  c2 = c * c;
+  c3 = c2 * c;
+  c5 = c3 * c2;
+  c7 = c5 * c2;
+  t = s / c;
+  tan2 = t * t;
+  tan3 = tan2 * t;
+  tan4 = tan3 * t;
+  tan5 = tan4 * t;
+  tan6 = tan5 * t;
+  eta = ctx->ebs * c2;
+  eta2 = eta * eta;
+  eta3 = eta2 * eta;
+  eta4 = eta3 * eta;
+
+  /* radius of curvature in prime vertical */
+  sn = ctx->a * Inv_Radical(ctx->es * s * s);
+
+  /* True Meridianal Distances */
+  tmd = SPHTMD(ctx, Latitude, s, c);
+
+  /*  Origin  */
+  tmdo = ctx->Origin_Tmd;
+
+  /* northing */
+  t1 = (tmd - tmdo) * ctx->Scale_Factor;
+  t2 = sn * s * c * ctx->Scale_Factor/ 2.e0;
+  t3 = sn * s * c3 * ctx->Scale_Factor * (5.e0 - tan2 + 9.e0 * eta 
+                                              + 4.e0 * eta2) /24.e0; 
+
+  t4 = sn * s * c5 * ctx->Scale_Factor * (61.e0 - 58.e0 * tan2
+                                              + tan4 + 270.e0 * eta - 330.e0 * tan2 * eta + 445.e0 * eta2
+                                              + 324.e0 * eta3 -680.e0 * tan2 * eta2 + 88.e0 * eta4 
+                                              -600.e0 * tan2 * eta3 - 192.e0 * tan2 * eta4) / 720.e0;
+
+  t5 = sn * s * c7 * ctx->Scale_Factor * (1385.e0 - 3111.e0 * 
+                                              tan2 + 543.e0 * tan4 - tan6) / 40320.e0;
+
+  dlam2 = dlam * dlam;
+  *Northing = ctx->False_Northing + t1
+              + dlam2 * (t2 + dlam2 * (t3 + dlam2 * (t4 + dlam2 * t5)));
+
+  /* Easting */
+  t6 = sn * c * ctx->Scale_Factor;
+  t7 = sn * c3 * ctx->Scale_Factor * (1.e0 - tan2 + eta ) /6.e0;
+  t8 = sn * c5 * ctx->Scale_Factor * (5.e0 - 18.e0 * tan2 + tan4
+                                          + 14.e0 * eta - 58.e0 * tan2 * eta + 13.e0 * eta2 + 4.e0 * eta3 
+                                          - 64.e0 * tan2 * eta2 - 24.e0 * tan2 * eta3 )/ 120.e0;
+  t9 = sn * c7 * ctx->Scale_Factor * ( 61.e0 - 479.e0 * tan2
+                                           + 179.e0 * tan4 - tan6 ) /5040.e0;
+
+  *Easting = ctx->False_Easting
+             + dlam * (t6 + dlam2 * (t7 + dlam2 * (t8 + dlam2 * t9)));
+} /* END OF Project_Point */
+
+
+static long Check_Projected (const Transverse_Mercator_Context *ctx,
+                             double Easting,
+                             double Northing)
+{ /* BEGIN Check_Projected */
+  /*
+   * The function Check_Projected checks that an easting and northing are
+   * within the range of the projection held in ctx.  The error code(s) are
+   * returned by the function, otherwise TRANMERC_NO_ERROR is returned.
+   *
+   *    ctx           : Transverse Mercator context                 (input)
+   *    Easting       : Easting/X in meters                         (input)
+   *    Northing      : Northing/Y in meters                        (input)
+   */
+
+  long Error_Code = TRANMERC_NO_ERROR;
+
+  if ((Easting < (ctx->False_Easting - ctx->Delta_Easting))
+      ||(Easting > (ctx->False_Easting + ctx->Delta_Easting)))
+  { /* Easting out of range  */
+    Error_Code |= TRANMERC_EASTING_ERROR;
+  }
+  if ((Northing < (ctx->False_Northing - ctx->Delta_Northing))
+      || (Northing > (ctx->False_Northing + ctx->Delta_Northing)))
+  { /* Northing out of range */
+    Error_Code |= TRANMERC_NORTHING_ERROR;
+  }
+  return (Error_Code);
+} /* END OF Check_Projected */
+
+
+static FORCE_INLINE double Footpoint_Step (const Transverse_Mercator_Context *ctx,
+                                            double tmd,
+                                            double ftphi)
+{ /* BEGIN Footpoint_Step */
+  /*
+   * The function Footpoint_Step returns the next estimate of the footpoint
+   * latitude, the latitude whose true meridional distance is tmd, by
+   * dividing the remaining distance by the meridian radius of curvature
+   * at the current estimate ftphi.
+   *
+   *    ctx           : Transverse Mercator context                 (input)
+   *    tmd           : True meridional distance in meters          (input)
+   *    ftphi         : Footpoint latitude estimate in radians      (input)
+   */
+
+  double c;       /* Cosine of latitude                          */
+  double s;       /* Sine of latitude                        */
+  double x;       /* es * s * s                                      */
+  double isr;     /* Reciprocal radius of curvature in the meridian  */
+
+  Sin_Cos(ftphi, &s, &c);
+  x = ctx->es * s * s;
+  /* (1 - x)^(3/2) / (a (1 - es)) */
+  isr = (1.e0 - x) * (1.e0 - x) * Inv_Radical(x) * ctx->Inv_Equator_Sr;
+  return (ftphi + (tmd - SPHTMD(ctx, ftphi, s, c)) * isr);
+} /* END OF Footpoint_Step */
+
+
+static FORCE_INLINE void Unproject_Point (const Transverse_Mercator_Context *ctx,
+                                          double Easting,
+                                          double Northing,
+                                          double *Latitude,
+                                          double *Delta_Long,
+                                          double *Cos_Lat)
+{ /* BEGIN Unproject_Point */
+  /*
+   * The function Unproject_Point evaluates the inverse Transverse Mercator
+   * series for an easting and northing that Check_Projected accepted.  The
+   * radii of curvature enter only as reciprocals, computed without sqrt, so
+   * that the footpoint iteration and the series take a single division.
+   * It is shared by the scalar and batch conversions, which therefore agree.
+   *
+   *    ctx           : Transverse Mercator context                 (input)
+   *    Easting       : Easting/X in meters                         (input)
+   *    Northing      : Northing/Y in meters                        (input)
+   *    Latitude      : Latitude in radians                         (output)
+   *    Delta_Long    : Longitude less the central meridian         (output)
+   *    Cos_Lat       : Cosine of Latitude                          (output)
+   */
+
+  double c;       /* Cosine of latitude                          */
+  double de;      /* Delta easting - Difference in Easting (Easting-Fe)    */
+  double de2;
+  const double *d = ctx->Inv_Denom; /* Reciprocal series denominators */
+  double eta;     /* constant - TranMerc_ebs *c *c                   */
+  double eta2;
+  double eta3;
+  double eta4;
+  double ftphi;   /* Footpoint latitude                              */
+  double r;       /* 1 / sqrt(1 - es * s * s)                        */
+  double s;       /* Sine of latitude                        */
+  double sec;     /* Secant of latitude                              */
+  double isn;     /* Reciprocal radius of curvature in the prime vertical */
+  double isn3;
+  double isn5;
+  double isn7;
+  double isr;     /* Reciprocal radius of curvature in the meridian  */
+  double t;       /* Tangent of latitude                             */
+  double tan2;
+  double tan4;
+  double tan6;
+  double t10;     /* Term in coordinate conversion formula - GP to Y */
+  double t11;     /* Term in coordinate conversion formula - GP to Y */
+  double t12;     /* Term in coordinate conversion formula - GP to Y */
+  double t13;     /* Term in coordinate conversion formula - GP to Y */
+  double t14;     /* Term in coordinate conversion formula - GP to Y */
+  double t15;     /* Term in coordinate conversion formula - GP to Y */
+  double t16;     /* Term in coordinate conversion formula - GP to Y */
+  double t17;     /* Term in coordinate conversion formula - GP to Y */
+  double tmd;     /* True Meridional distance                        */
+  double x;       /* es * s * s                                      */
+
+  /* True Meridional Distance, 1 / Scale_Factor is d[4] */
+  tmd = ctx->Origin_Tmd + (Northing - ctx->False_Northing) * d[4];
+
+  /* First Estimate */
+  ftphi = tmd * ctx->Inv_Equator_Sr;
+
+  /* Five fixed steps, written out so that the loops over rows vectorize */
+  ftphi = Footpoint_Step(ctx, tmd, ftphi);
+  ftphi = Footpoint_Step(ctx, tmd, ftphi);
+  ftphi = Footpoint_Step(ctx, tmd, ftphi);
+  ftphi = Footpoint_Step(ctx, tmd, ftphi);
+  ftphi = Footpoint_Step(ctx, tmd, ftphi);
+
+  /* Sine Cosine terms */
+  Sin_Cos(ftphi, &s, &c);
+
+  /* Reciprocal radii of curvature in the meridian and prime vertical */
+  x = ctx->es * s * s;
+  r = Inv_Radical(x);
+  isr = (1.e0 - x) * (1.e0 - x) * r * ctx->Inv_Equator_Sr;
+  isn = (1.e0 - x) * r * ctx->Inv_a;
+  isn3 = isn * isn * isn;
+  isn5 = isn3 * isn * isn;
+  isn7 = isn5 * isn * isn;
+
+  /* Tangent Value  */
+  sec = 1.e0 / c;
+  t = s * sec;
+  tan2 = t * t;
+  tan4 = tan2 * tan2;
+  tan6 = tan4 * tan2;
+  eta = ctx->ebs * c * c;
+  eta2 = eta * eta;
+  eta3 = eta2 * eta;
+  eta4 = eta3 * eta;
+  de = Easting - ctx->False_Easting;
+  de = (fabs(de) < 0.0001) ? 0.0 : de;
+  de2 = de * de;
+
+  /* Latitude */
+  t10 = t * isr * isn * d[0];
+  t11 = t * (5.e0  + 3.e0 * tan2 + eta - 4.e0 * eta2
+             - 9.e0 * tan2 * eta) * isr * isn3 * d[1];
+  t12 = t * (61.e0 + 90.e0 * tan2 + 46.e0 * eta + 45.E0 * tan4
+             - 252.e0 * tan2 * eta  - 3.e0 * eta2 + 100.e0 
+             * eta3 - 66.e0 * tan2 * eta2 - 90.e0 * tan4
+             * eta + 88.e0 * eta4 + 225.e0 * tan4 * eta2
+             + 84.e0 * tan2* eta3 - 192.e0 * tan2 * eta4)
+        * isr * isn5 * d[2];
+  t13 = t * ( 1385.e0 + 3633.e0 * tan2 + 4095.e0 * tan4 + 1575.e0 
+              * tan6) * isr * isn7 * d[3];
+  *Latitude = ftphi - de2 * (t10 - de2 * (t11 - de2 * (t12 - de2 * t13)));
+
+  t14 = isn * sec * d[4];
+
+  t15 = (1.e0 + 2.e0 * tan2 + eta) * isn3 * sec * d[5];
+
+  t16 = (5.e0 + 6.e0 * eta + 28.e0 * tan2 - 3.e0 * eta2
+         + 8.e0 * tan2 * eta + 24.e0 * tan4 - 4.e0 
+         * eta3 + 4.e0 * tan2 * eta2 + 24.e0 
+         * tan2 * eta3) * isn5 * sec * d[6];
+
+  t17 = (61.e0 +  662.e0 * tan2 + 1320.e0 * tan4 + 720.e0 
+         * tan6) * isn7 * sec * d[7];
+
+  /* Difference in Longitude */
+  *Delta_Long = de * (t14 - de2 * (t15 - de2 * (t16 - de2 * t17)));
+
+  Sin_Cos(*Latitude, &s, Cos_Lat);
+} /* END OF Unproject_Point */
+
+
+static long Finish_Geodetic (const Transverse_Mercator_Context *ctx,
+                             double Lat,
+                             double dlam,
+                             double Cos_Lat,
+                             double *Latitude,
+                             double *Longitude)
+{ /* BEGIN Finish_Geodetic */
+  /*
+   * The function Finish_Geodetic returns the latitude and longitude found
+   * by Unproject_Point, the longitude wrapped to +/- PI, and checks them.
+   * The error code(s) and warning are returned by the function, otherwise
+   * TRANMERC_NO_ERROR is returned.
+   *
+   *    ctx           : Transverse Mercator context                 (input)
+   *    Lat           : Latitude in radians                         (input)
+   *    dlam          : Longitude less the central meridian         (input)
+   *    Cos_Lat       : Cosine of Lat                               (input)
+   *    Latitude      : Latitude in radians                         (output)
+   *    Longitude     : Longitude in radians                        (output)
+   */
+
+  long Error_Code = TRANMERC_NO_ERROR;
+
+  *Latitude = Lat;
+
+  /* Longitude */
+  (*Longitude) = ctx->Origin_Long + dlam;
+
+  if((fabs)(*Latitude) > (90.0 * PI / 180.0))
+    Error_Code |= TRANMERC_NORTHING_ERROR;
+
+  if((*Longitude) > (PI))
+  {
+    *Longitude -= (2 * PI);
+    if((fabs)(*Longitude) > PI)
+      Error_Code |= TRANMERC_EASTING_ERROR;
+  }
+  else if((*Longitude) < (-PI))
+  {
+    *Longitude += (2 * PI);
+    if((fabs)(*Longitude) > PI)
+      Error_Code |= TRANMERC_EASTING_ERROR;
+  }
+
+  if (fabs(dlam) > (9.0 * PI / 180) * Cos_Lat)
+  { /* Distortion will result if Longitude is more than 9 degrees from the Central Meridian at the equator */
+    /* and decreases to 0 degrees at the poles */
+    /* As you move towards the poles, distortion will become more significant */
+    Error_Code |= TRANMERC_LON_WARNING;
+  }
+  return (Error_Code);
+} /* END OF Finish_Geodetic */
+
+
+static FORCE_INLINE void Kruger_Xi_Eta (const Transverse_Mercator_Context *ctx,
+                                        double Latitude,
+                                        double dlam,
+                                        double *Xi,
+                                        double *Eta)
+{ /* BEGIN Kruger_Xi_Eta */
+  /*
+   * The function Kruger_Xi_Eta returns the Transverse Mercator coordinates
+   * of a latitude and a longitude difference on the sphere of radius
+   * Kr_Radius: the conformal latitude and the longitude give the spherical
+   * coordinates xi' and eta', which Kruger's alpha series take to xi and
+   * eta.  The sines and cosines of 2 xi' and 2 eta' come from the conformal
+   * latitude by rational formulas; only xi' and eta' themselves take an
+   * arc tangent and a logarithm.
+   *
+   *    ctx           : Transverse Mercator context                 (input)
+   *    Latitude      : Latitude in radians                         (input)
+   *    dlam          : Longitude less the central meridian         (input)
+   *    Xi            : Northing over Kr_Radius                     (output)
+   *    Eta           : Easting over Kr_Radius                      (output)
+   */
+
+  double c;       /* Cosine of latitude                              */
+  double cl;      /* Cosine of dlam                                  */
+  double h;       /* w * w + c * c                                   */
+  double im;
+  double p;       /* w * w - c * c                                   */
+  double iq;      /* 1 / (p * p + u * u)                             */
+  double re;
+  double s;       /* Sine of latitude                                */
+  double sl;      /* Sine of dlam                                    */
+  double u;       /* 2 c w cos(dlam)                                 */
+  double v;       /* 2 c w sin(dlam)                                 */
+  double w;       /* tan(PI/4 + conformal latitude / 2) * c          */
+
+  /*
+   * With h = w^2 + c^2 the conformal latitude has sine p / h and cosine
+   * 2 c w / h, and tan(xi') = p / u, tanh(eta') = v / h.
+   */
+  Sin_Cos(Latitude, &s, &c);
+  Sin_Cos(dlam, &sl, &cl);
+  w = (1.e0 + s) * Pow_E(ctx, s);
+  h = w * w + c * c;
+  p = w * w - c * c;
+  u = 2.e0 * c * w * cl;
+  v = 2.e0 * c * w * sl;
+  iq = 1.e0 / (p * p + u * u);    /* p^2 + u^2 = h^2 - v^2 */
+  Kruger_Sum(ctx->Alpha, 2.e0 * p * u * iq, (u * u - p * p) * iq,
+             2.e0 * v * h * iq, (h * h + v * v) * iq, &re, &im);
+  *Xi = Atan2(p, u) + re;
+  *Eta = 0.5e0 * Log((h + v) * (h + v) * iq) + im;
+} /* END OF Kruger_Xi_Eta */
+
+
+static FORCE_INLINE void Kruger_Project_Point (const Transverse_Mercator_Context *ctx,
+                                               double Latitude,
+                                               double dlam,
+                                               double *Easting,
+                                               double *Northing)
+{ /* BEGIN Kruger_Project_Point */
+  /*
+   * The function Kruger_Project_Point is the TRANMERC_KRUGER form of
+   * Project_Point.
+   *
+   *    ctx           : Transverse Mercator context                 (input)
+   *    Latitude      : Latitude in radians                         (input)
+   *    dlam          : Longitude less the central meridian         (input)
+   *    Easting       : Easting/X in meters                         (output)
+   *    Northing      : Northing/Y in meters                        (output)
+   */
+
+  double xi;
+  double eta;
+
+  Kruger_Xi_Eta(ctx, Latitude, dlam, &xi, &eta);
+  *Easting = ctx->False_Easting + ctx->Kr_Radius * eta;
+  *Northing = ctx->False_Northing + ctx->Kr_Radius * (xi - ctx->Kr_Origin);
+} /* END OF Kruger_Project_Point */
+
+
+static FORCE_INLINE void Kruger_Unproject_Point (const Transverse_Mercator_Context *ctx,
+                                                 double Easting,
+                                                 double Northing,
+                                                 double *Latitude,
+                                                 double *Delta_Long,
+                                                 double *Cos_Lat)
+{ /* BEGIN Kruger_Unproject_Point */
+  /*
+   * The function Kruger_Unproject_Point is the TRANMERC_KRUGER form of
+   * Unproject_Point.  Kruger's beta series take xi and eta to the spherical
+   * coordinates xi' and eta', which give the conformal latitude and the
+   * longitude, and the delta series takes the conformal latitude to the
+   * latitude, so that there is no iteration.
+   *
+   *    ctx           : Transverse Mercator context                 (input)
+   *    Easting       : Easting/X in meters                         (input)
+   *    Northing      : Northing/Y in meters                        (input)
+   *    Latitude      : Latitude in radians                         (output)
+   *    Delta_Long    : Longitude less the central meridian         (output)
+   *    Cos_Lat       : Cosine of Latitude                          (output)
+   */
+
+  double c;       /* Cosine of xi'                                   */
+  double ch;      /* Hyperbolic cosine of eta'                       */
+  double cc;      /* Cosine of conformal latitude                    */
+  double ex;      /* Exponential of 2 eta, then of eta'              */
+  double eta;     /* Easting over Kr_Radius, then eta'               */
+  double hyp;     /* Cosine of conformal latitude times ch           */
+  double im;
+  double re;
+  double s;       /* Sine of xi'                                     */
+  double sh;      /* Hyperbolic sine of eta'                         */
+  double sc;      /* Sine of conformal latitude                      */
+  double xi;      /* Northing over Kr_Radius, then xi'               */
+
+  xi = (Northing - ctx->False_Northing) * ctx->Kr_Inv_Radius + ctx->Kr_Origin;
+  eta = (Easting - ctx->False_Easting) * ctx->Kr_Inv_Radius;
+
+  Sin_Cos(2.e0 * xi, &s, &c);
+  ex = Exp(2.e0 * eta);
+  Kruger_Sum(ctx->Beta, s, c, 0.5e0 * (ex - 1.e0 / ex), 0.5e0 * (ex + 1.e0 / ex), &re, &im);
+  xi -= re;
+  eta -= im;
+
+  Sin_Cos(xi, &s, &c);
+  ex = Exp(eta);
+  sh = 0.5e0 * (ex - 1.e0 / ex);
+  ch = 0.5e0 * (ex + 1.e0 / ex);
+  hyp = Sqrt(sh * sh + c * c);
+  sc = s / ch;
+  cc = hyp / ch;
+  Kruger_Sum(ctx->Delta, 2.e0 * sc * cc, (cc - sc) * (cc + sc), 0.e0, 1.e0, &re, &im);
+  *Latitude = Atan2(s, hyp) + re;
+  *Delta_Long = Atan2(sh, c);
+
+  Sin_Cos(*Latitude, &s, Cos_Lat);
+} /* END OF Kruger_Unproject_Point */
+
+
+static void Set_Kruger_Coefficients (Transverse_Mercator_Context *ctx)
+{ /* BEGIN Set_Kruger_Coefficients */
+  /*
+   * The function Set_Kruger_Coefficients computes the Kruger series
+   * coefficients, to 6th order in the third flattening n, for the
+   * ellipsoid and projection parameters held in ctx.
+   *
+   *    ctx           : Transverse Mercator context                 (input/output)
+   */
+
+  double n = ctx->f / (2.e0 - ctx->f);
+  double n2 = n * n;
+  double n3 = n2 * n;
+  double n4 = n3 * n;
+  double n5 = n4 * n;
+  double n6 = n5 * n;
+  double eta;
+
+  ctx->e = sqrt(ctx->es);
+  /* rectifying radius */
+  ctx->Kr_Radius = ctx->Scale_Factor * ctx->a / (1.e0 + n)
+                   * (1.e0 + n2 / 4.e0 + n4 / 64.e0 + n6 / 256.e0);
+  ctx->Kr_Inv_Radius = 1.e0 / ctx->Kr_Radius;
+
+  ctx->Alpha[0] = n / 2.e0 - 2.e0 * n2 / 3.e0 + 5.e0 * n3 / 16.e0 + 41.e0 * n4 / 180.e0
+                  - 127.e0 * n5 / 288.e0 + 7891.e0 * n6 / 37800.e0;
+  ctx->Alpha[1] = 13.e0 * n2 / 48.e0 - 3.e0 * n3 / 5.e0 + 557.e0 * n4 / 1440.e0
+                  + 281.e0 * n5 / 630.e0 - 1983433.e0 * n6 / 1935360.e0;
+  ctx->Alpha[2] = 61.e0 * n3 / 240.e0 - 103.e0 * n4 / 140.e0 + 15061.e0 * n5 / 26880.e0
+                  + 167603.e0 * n6 / 181440.e0;
+  ctx->Alpha[3] = 49561.e0 * n4 / 161280.e0 - 179.e0 * n5 / 168.e0
+                  + 6601661.e0 * n6 / 7257600.e0;
+  ctx->Alpha[4] = 34729.e0 * n5 / 80640.e0 - 3418889.e0 * n6 / 1995840.e0;
+  ctx->Alpha[5] = 212378941.e0 * n6 / 319334400.e0;
+
+  ctx->Beta[0] = n / 2.e0 - 2.e0 * n2 / 3.e0 + 37.e0 * n3 / 96.e0 - n4 / 360.e0
+                 - 81.e0 * n5 / 512.e0 + 96199.e0 * n6 / 604800.e0;
+  ctx->Beta[1] = n2 / 48.e0 + n3 / 15.e0 - 437.e0 * n4 / 1440.e0 + 46.e0 * n5 / 105.e0
+                 - 1118711.e0 * n6 / 3870720.e0;
+  ctx->Beta[2] = 17.e0 * n3 / 480.e0 - 37.e0 * n4 / 840.e0 - 209.e0 * n5 / 4480.e0
+                 + 5569.e0 * n6 / 90720.e0;
+  ctx->Beta[3] = 4397.e0 * n4 / 161280.e0 - 11.e0 * n5 / 504.e0
+                 - 830251.e0 * n6 / 7257600.e0;
+  ctx->Beta[4] = 4583.e0 * n5 / 161280.e0 - 108847.e0 * n6 / 3991680.e0;
+  ctx->Beta[5] = 20648693.e0 * n6 / 638668800.e0;
+
+  ctx->Delta[0] = 2.e0 * n - 2.e0 * n2 / 3.e0 - 2.e0 * n3 + 116.e0 * n4 / 45.e0
+                  + 26.e0 * n5 / 45.e0 - 2854.e0 * n6 / 675.e0;
+  ctx->Delta[1] = 7.e0 * n2 / 3.e0 - 8.e0 * n3 / 5.e0 - 227.e0 * n4 / 45.e0
+                  + 2704.e0 * n5 / 315.e0 + 2323.e0 * n6 / 945.e0;
+  ctx->Delta[2] = 56.e0 * n3 / 15.e0 - 136.e0 * n4 / 35.e0 - 1262.e0 * n5 / 105.e0
+                  + 73814.e0 * n6 / 2835.e0;
+  ctx->Delta[3] = 4279.e0 * n4 / 630.e0 - 332.e0 * n5 / 35.e0 - 399572.e0 * n6 / 14175.e0;
+  ctx->Delta[4] = 4174.e0 * n5 / 315.e0 - 144838.e0 * n6 / 6237.e0;
+  ctx->Delta[5] = 601676.e0 * n6 / 22275.e0;
+
+  Kruger_Xi_Eta(ctx, ctx->Origin_Lat, 0.e0, &ctx->Kr_Origin, &eta);
+} /* END OF Set_Kruger_Coefficients */
+
+
 long Set_Transverse_Mercator_Parameters(double a,
                                         double f,
                                         double Origin_Latitude,
@@ -168,12 +1052,36 @@ long Set_Transverse_Mercator_Parameters(double a,
 
 { /* BEGIN Set_Tranverse_Mercator_Parameters */
   /*
-   * The function Set_Tranverse_Mercator_Parameters receives the ellipsoid
+   * The function Set_Tranverse_Mercator_Parameters sets the file-scope
+   * state used by the non-reentrant conversion functions.  See
+   * Set_Transverse_Mercator_Parameters_Ctx.
+   */
+
+  return Set_Transverse_Mercator_Parameters_Ctx(&TranMerc_Context, a, f,
+                                                Origin_Latitude, Central_Meridian,
+                                                False_Easting, False_Northing,
+                                                Scale_Factor);
+}  /* END of Set_Transverse_Mercator_Parameters  */
+
+
+long Set_Transverse_Mercator_Parameters_Ctx(Transverse_Mercator_Context *ctx,
+                                            double a,
+                                            double f,
+                                            double Origin_Latitude,
+                                            double Central_Meridian,
+                                            double False_Easting,
+                                            double False_Northing,
+                                            double Scale_Factor)
+
+{ /* BEGIN Set_Tranverse_Mercator_Parameters_Ctx */
+  /*
+   * The function Set_Tranverse_Mercator_Parameters_Ctx receives the ellipsoid
    * parameters and Tranverse Mercator projection parameters as inputs, and
-   * sets the corresponding state variables. If any errors occur, the error
+   * sets the corresponding state variables in ctx. If any errors occur, the error
    * code(s) are returned by the function, otherwise TRANMERC_NO_ERROR is
    * returned.
    *
+   *    ctx               : Transverse Mercator context                (output)
    *    a                 : Semi-major axis of ellipsoid, in meters    (input)
    *    f                 : Flattening of ellipsoid						         (input)
    *    Origin_Latitude   : Latitude in radians at the origin of the   (input)
@@ -190,9 +1098,11 @@ long Set_Transverse_Mercator_Parameters(double a,
   double tn3;
   double tn4;
   double tn5;
+  double dlam;      /* Longitude less the central meridian */
   double dummy_northing;
   double TranMerc_b; /* Semi-minor axis of ellipsoid, in meters */
   double inv_f = 1 / f;
+  double k2;        /* Scale factor squared */
   long Error_Code = TRANMERC_NO_ERROR;
 
   if (a <= 0.0)
@@ -217,50 +1127,64 @@ long Set_Transverse_Mercator_Parameters(double a,
   }
   if (!Error_Code)
   { /* no errors */
-    TranMerc_a = a;
-    TranMerc_f = f;
-    TranMerc_Origin_Lat = Origin_Latitude;
+    ctx->a = a;
+    ctx->f = f;
+    ctx->Origin_Lat = Origin_Latitude;
     if (Central_Meridian > PI)
       Central_Meridian -= (2*PI);
-    TranMerc_Origin_Long = Central_Meridian;
-    TranMerc_False_Northing = False_Northing;
-    TranMerc_False_Easting = False_Easting; 
-    TranMerc_Scale_Factor = Scale_Factor;
+    ctx->Origin_Long = Central_Meridian;
+    ctx->False_Northing = False_Northing;
+    ctx->False_Easting = False_Easting; 
+    ctx->Scale_Factor = Scale_Factor;
 
     /* Eccentricity Squared */
-    TranMerc_es = 2 * TranMerc_f - TranMerc_f * TranMerc_f;
+    ctx->es = 2 * ctx->f - ctx->f * ctx->f;
     /* Second Eccentricity Squared */
-    TranMerc_ebs = (1 / (1 - TranMerc_es)) - 1;
+    ctx->ebs = (1 / (1 - ctx->es)) - 1;
 
-    TranMerc_b = TranMerc_a * (1 - TranMerc_f);    
+    TranMerc_b = ctx->a * (1 - ctx->f);    
     /*True meridianal constants  */
-    tn = (TranMerc_a - TranMerc_b) / (TranMerc_a + TranMerc_b);
+    tn = (ctx->a - TranMerc_b) / (ctx->a + TranMerc_b);
     tn2 = tn * tn;
     tn3 = tn2 * tn;
     tn4 = tn3 * tn;
     tn5 = tn4 * tn;
 
-    TranMerc_ap = TranMerc_a * (1.e0 - tn + 5.e0 * (tn2 - tn3)/4.e0
+    ctx->ap = ctx->a * (1.e0 - tn + 5.e0 * (tn2 - tn3)/4.e0
                                 + 81.e0 * (tn4 - tn5)/64.e0 );
-    TranMerc_bp = 3.e0 * TranMerc_a * (tn - tn2 + 7.e0 * (tn3 - tn4)
+    ctx->bp = 3.e0 * ctx->a * (tn - tn2 + 7.e0 * (tn3 - tn4)
                                        /8.e0 + 55.e0 * tn5/64.e0 )/2.e0;
-    TranMerc_cp = 15.e0 * TranMerc_a * (tn2 - tn3 + 3.e0 * (tn4 - tn5 )/4.e0) /16.0;
-    TranMerc_dp = 35.e0 * TranMerc_a * (tn3 - tn4 + 11.e0 * tn5 / 16.e0) / 48.e0;
-    TranMerc_ep = 315.e0 * TranMerc_a * (tn4 - tn5) / 512.e0;
-    Convert_Geodetic_To_Transverse_Mercator(MAX_LAT,
-                                            MAX_DELTA_LONG + Central_Meridian,
-                                            &TranMerc_Delta_Easting,
-                                            &TranMerc_Delta_Northing);
-    Convert_Geodetic_To_Transverse_Mercator(0,
-                                            MAX_DELTA_LONG + Central_Meridian,
-                                            &TranMerc_Delta_Easting,
-                                            &dummy_northing);
-    TranMerc_Delta_Northing++;
-    TranMerc_Delta_Easting++;
+    ctx->cp = 15.e0 * ctx->a * (tn2 - tn3 + 3.e0 * (tn4 - tn5 )/4.e0) /16.0;
+    ctx->dp = 35.e0 * ctx->a * (tn3 - tn4 + 11.e0 * tn5 / 16.e0) / 48.e0;
+    ctx->ep = 315.e0 * ctx->a * (tn4 - tn5) / 512.e0;
+    ctx->Origin_Tmd = SPHTMD(ctx, Origin_Latitude, sin(Origin_Latitude),
+                             cos(Origin_Latitude));
+    ctx->Inv_a = 1.e0 / ctx->a;
+    ctx->Inv_Equator_Sr = 1.e0 / (ctx->a * (1.e0 - ctx->es));
+    k2 = Scale_Factor * Scale_Factor;
+    ctx->Inv_Denom[0] = 1.e0 / (2.e0 * k2);
+    ctx->Inv_Denom[1] = 1.e0 / (24.e0 * k2 * k2);
+    ctx->Inv_Denom[2] = 1.e0 / (720.e0 * k2 * k2 * k2);
+    ctx->Inv_Denom[3] = 1.e0 / (40320.e0 * k2 * k2 * k2 * k2);
+    ctx->Inv_Denom[4] = 1.e0 / Scale_Factor;
+    ctx->Inv_Denom[5] = 1.e0 / (6.e0 * k2 * Scale_Factor);
+    ctx->Inv_Denom[6] = 1.e0 / (120.e0 * k2 * k2 * Scale_Factor);
+    ctx->Inv_Denom[7] = 1.e0 / (5040.e0 * k2 * k2 * k2 * Scale_Factor);
+    ctx->Engine = TRANMERC_THOMAS;
+    Set_Kruger_Coefficients(ctx);
+    /* the range of the projection is that of the Thomas series, for all engines */
+    if (!(Check_Geodetic(ctx, MAX_LAT, MAX_DELTA_LONG + Central_Meridian, &dlam)
+          & ~TRANMERC_LON_WARNING))
+      Project_Point(ctx, MAX_LAT, dlam, &ctx->Delta_Easting, &ctx->Delta_Northing);
+    if (!(Check_Geodetic(ctx, 0, MAX_DELTA_LONG + Central_Meridian, &dlam)
+          & ~TRANMERC_LON_WARNING))
+      Project_Point(ctx, 0, dlam, &ctx->Delta_Easting, &dummy_northing);
+    ctx->Delta_Northing++;
+    ctx->Delta_Easting++;
 
   } /* END OF if(!Error_Code) */
   return (Error_Code);
-}  /* END of Set_Transverse_Mercator_Parameters  */
+}  /* END of Set_Transverse_Mercator_Parameters_Ctx  */
 
 
 void Get_Transverse_Mercator_Parameters(double *a,
@@ -275,7 +1199,31 @@ void Get_Transverse_Mercator_Parameters(double *a,
   /*
    * The function Get_Transverse_Mercator_Parameters returns the current
    * ellipsoid and Transverse Mercator projection parameters.
+   */
+
+  Get_Transverse_Mercator_Parameters_Ctx(&TranMerc_Context, a, f,
+                                         Origin_Latitude, Central_Meridian,
+                                         False_Easting, False_Northing,
+                                         Scale_Factor);
+  return;
+} /* END OF Get_Tranverse_Mercator_Parameters */
+
+
+void Get_Transverse_Mercator_Parameters_Ctx(const Transverse_Mercator_Context *ctx,
+                                            double *a,
+                                            double *f,
+                                            double *Origin_Latitude,
+                                            double *Central_Meridian,
+                                            double *False_Easting,
+                                            double *False_Northing,
+                                            double *Scale_Factor)
+
+{ /* BEGIN Get_Tranverse_Mercator_Parameters_Ctx  */
+  /*
+   * The function Get_Transverse_Mercator_Parameters_Ctx returns the
+   * ellipsoid and Transverse Mercator projection parameters held in ctx.
    *
+   *    ctx               : Transverse Mercator context                (input)
    *    a                 : Semi-major axis of ellipsoid, in meters    (output)
    *    f                 : Flattening of ellipsoid						         (output)
    *    Origin_Latitude   : Latitude in radians at the origin of the   (output)
@@ -287,15 +1235,77 @@ void Get_Transverse_Mercator_Parameters(double *a,
    *    Scale_Factor      : Projection scale factor                    (output) 
    */
 
-  *a = TranMerc_a;
-  *f = TranMerc_f;
-  *Origin_Latitude = TranMerc_Origin_Lat;
-  *Central_Meridian = TranMerc_Origin_Long;
-  *False_Easting = TranMerc_False_Easting;
-  *False_Northing = TranMerc_False_Northing;
-  *Scale_Factor = TranMerc_Scale_Factor;
+  *a = ctx->a;
+  *f = ctx->f;
+  *Origin_Latitude = ctx->Origin_Lat;
+  *Central_Meridian = ctx->Origin_Long;
+  *False_Easting = ctx->False_Easting;
+  *False_Northing = ctx->False_Northing;
+  *Scale_Factor = ctx->Scale_Factor;
   return;
-} /* END OF Get_Tranverse_Mercator_Parameters */
+} /* END OF Get_Tranverse_Mercator_Parameters_Ctx */
+
+
+long Set_Transverse_Mercator_Engine(long Engine)
+
+{ /* BEGIN Set_Transverse_Mercator_Engine */
+  /*
+   * The function Set_Transverse_Mercator_Engine selects the series engine
+   * of the file-scope state.  See Set_Transverse_Mercator_Engine_Ctx.
+   */
+
+  return Set_Transverse_Mercator_Engine_Ctx(&TranMerc_Context, Engine);
+} /* END OF Set_Transverse_Mercator_Engine */
+
+
+long Set_Transverse_Mercator_Engine_Ctx(Transverse_Mercator_Context *ctx,
+                                        long Engine)
+
+{ /* BEGIN Set_Transverse_Mercator_Engine_Ctx */
+  /*
+   * The function Set_Transverse_Mercator_Engine_Ctx selects the series
+   * engine of ctx, TRANMERC_THOMAS or TRANMERC_KRUGER.  If Engine is invalid
+   * TRANMERC_ENGINE_ERROR is returned, otherwise TRANMERC_NO_ERROR.
+   *
+   *    ctx               : Transverse Mercator context                (input/output)
+   *    Engine            : TRANMERC_THOMAS or TRANMERC_KRUGER         (input)
+   */
+
+  if ((Engine != TRANMERC_THOMAS) && (Engine != TRANMERC_KRUGER))
+    return (TRANMERC_ENGINE_ERROR);
+  if ((Engine == TRANMERC_KRUGER) && (ctx->Kr_Radius == 0.0))
+  { /* the default context starts without them */
+    Set_Kruger_Coefficients(ctx);
+  }
+  ctx->Engine = Engine;
+  return (TRANMERC_NO_ERROR);
+} /* END OF Set_Transverse_Mercator_Engine_Ctx */
+
+
+long Get_Transverse_Mercator_Engine(void)
+
+{ /* BEGIN Get_Transverse_Mercator_Engine */
+  /*
+   * The function Get_Transverse_Mercator_Engine returns the series engine
+   * of the file-scope state.
+   */
+
+  return Get_Transverse_Mercator_Engine_Ctx(&TranMerc_Context);
+} /* END OF Get_Transverse_Mercator_Engine */
+
+
+long Get_Transverse_Mercator_Engine_Ctx(const Transverse_Mercator_Context *ctx)
+
+{ /* BEGIN Get_Transverse_Mercator_Engine_Ctx */
+  /*
+   * The function Get_Transverse_Mercator_Engine_Ctx returns the series
+   * engine of ctx.
+   *
+   *    ctx               : Transverse Mercator context                (input)
+   */
+
+  return (ctx->Engine);
+} /* END OF Get_Transverse_Mercator_Engine_Ctx */
 
 
 
@@ -308,150 +1318,452 @@ long Convert_Geodetic_To_Transverse_Mercator (double Latitude,
 
   /*
    * The function Convert_Geodetic_To_Transverse_Mercator converts geodetic
+   * (latitude and longitude) coordinates using the file-scope state.  See
+   * Convert_Geodetic_To_Transverse_Mercator_Ctx.
+   */
+
+  return Convert_Geodetic_To_Transverse_Mercator_Ctx(&TranMerc_Context, Latitude,
+                                                     Longitude, Easting, Northing);
+} /* END OF Convert_Geodetic_To_Transverse_Mercator */
+
+
+long Convert_Geodetic_To_Transverse_Mercator_Ctx (const Transverse_Mercator_Context *ctx,
+                                                  double Latitude,
+                                                  double Longitude,
+                                                  double *Easting,
+                                                  double *Northing)
+
+{      /* BEGIN Convert_Geodetic_To_Transverse_Mercator_Ctx */
+
+  /*
+   * The function Convert_Geodetic_To_Transverse_Mercator_Ctx converts geodetic
    * (latitude and longitude) coordinates to Transverse Mercator projection
-   * (easting and northing) coordinates, according to the current ellipsoid
-   * and Transverse Mercator projection coordinates.  If any errors occur, the
-   * error code(s) are returned by the function, otherwise TRANMERC_NO_ERROR is
-   * returned.
+   * (easting and northing) coordinates, according to the ellipsoid
+   * and Transverse Mercator projection coordinates held in ctx.  If any errors
+   * occur, the error code(s) are returned by the function, otherwise
+   * TRANMERC_NO_ERROR is returned.
    *
+   *    ctx           : Transverse Mercator context                 (input)
    *    Latitude      : Latitude in radians                         (input)
    *    Longitude     : Longitude in radians                        (input)
    *    Easting       : Easting/X in meters                         (output)
    *    Northing      : Northing/Y in meters                        (output)
    */
 
-  double c;       /* Cosine of latitude                          */
-  double c2;
-  double c3;
-  double c5;
-  double c7;
   double dlam;    /* Delta longitude - Difference in Longitude       */
-  double eta;     /* constant - TranMerc_ebs *c *c                   */
-  double eta2;
-  double eta3;
-  double eta4;
-  double s;       /* Sine of latitude                        */
-  double sn;      /* Radius of curvature in the prime vertical       */
-  double t;       /* Tangent of latitude                             */
-  double tan2;
-  double tan3;
-  double tan4;
-  double tan5;
-  double tan6;
-  double t1;      /* Term in coordinate conversion formula - GP to Y */
-  double t2;      /* Term in coordinate conversion formula - GP to Y */
-  double t3;      /* Term in coordinate conversion formula - GP to Y */
-  double t4;      /* Term in coordinate conversion formula - GP to Y */
-  double t5;      /* Term in coordinate conversion formula - GP to Y */
-  double t6;      /* Term in coordinate conversion formula - GP to Y */
-  double t7;      /* Term in coordinate conversion formula - GP to Y */
-  double t8;      /* Term in coordinate conversion formula - GP to Y */
-  double t9;      /* Term in coordinate conversion formula - GP to Y */
-  double tmd;     /* True Meridional distance                        */
-  double tmdo;    /* True Meridional distance for latitude of origin */
-  long    Error_Code = TRANMERC_NO_ERROR;
-  double temp_Origin;
-  double temp_Long;
+  long    Error_Code;
 
-  if ((Latitude < -MAX_LAT) || (Latitude > MAX_LAT))
-  {  /* Latitude out of range */
-    Error_Code|= TRANMERC_LAT_ERROR;
+  Error_Code = Check_Geodetic(ctx, Latitude, Longitude, &dlam);
+  if (!(Error_Code & ~TRANMERC_LON_WARNING))
+  { /* no errors */
+    if (ctx->Engine == TRANMERC_KRUGER)
+      Kruger_Project_Point(ctx, Latitude, dlam, Easting, Northing);
+    else
+      Project_Point(ctx, Latitude, dlam, Easting, Northing);
   }
-  if (Longitude > PI)
-    Longitude -= (2 * PI);
-  if ((Longitude < (TranMerc_Origin_Long - MAX_DELTA_LONG))
-      || (Longitude > (TranMerc_Origin_Long + MAX_DELTA_LONG)))
+  return (Error_Code);
+} /* END OF Convert_Geodetic_To_Transverse_Mercator_Ctx */
+
+
+BATCH_KERNEL
+static void Project_Block (const Transverse_Mercator_Context *ctx,
+                           const double *restrict Latitude,
+                           const double *restrict Delta_Long,
+                           size_t Count,
+                           double *restrict Easting,
+                           double *restrict Northing)
+{ /* BEGIN Project_Block */
+  /*
+   * The function Project_Block runs Project_Point over arrays of latitudes
+   * and longitude differences, several rows per vector instruction.
+   *
+   *    ctx           : Transverse Mercator context                 (input)
+   *    Latitude      : Latitudes in radians                        (input)
+   *    Delta_Long    : Longitudes less the central meridian        (input)
+   *    Count         : Number of rows                              (input)
+   *    Easting       : Eastings/X in meters                        (output)
+   *    Northing      : Northings/Y in meters                       (output)
+   */
+
+  size_t i;
+
+  for (i = 0; i < Count; i++)
+    Project_Point(ctx, Latitude[i], Delta_Long[i], &Easting[i], &Northing[i]);
+} /* END OF Project_Block */
+
+
+BATCH_KERNEL
+static void Kruger_Project_Block (const Transverse_Mercator_Context *ctx,
+                                  const double *restrict Latitude,
+                                  const double *restrict Delta_Long,
+                                  size_t Count,
+                                  double *restrict Easting,
+                                  double *restrict Northing)
+{ /* BEGIN Kruger_Project_Block */
+  /*
+   * The function Kruger_Project_Block is the TRANMERC_KRUGER form of
+   * Project_Block.
+   */
+
+  size_t i;
+
+  for (i = 0; i < Count; i++)
+    Kruger_Project_Point(ctx, Latitude[i], Delta_Long[i], &Easting[i], &Northing[i]);
+} /* END OF Kruger_Project_Block */
+
+
+static FORCE_INLINE void Fast_Sin_Cos (float Angle,
+                                       float *Sin_Angle,
+                                       float *Cos_Angle)
+{ /* BEGIN Fast_Sin_Cos */
+  /*
+   * The function Fast_Sin_Cos is the single precision form of Sin_Cos, with
+   * the Cephes sinf and cosf polynomials.  It is accurate to about 1e-7 for
+   * angles within +/- 10^3 radians.
+   *
+   *    Angle         : Angle in radians                            (input)
+   *    Sin_Angle     : Sine of Angle                               (output)
+   *    Cos_Angle     : Cosine of Angle                             (output)
+   */
+
+  float q = (Angle * (float)TWO_OVER_PI + FAST_ROUND_MAGIC) - FAST_ROUND_MAGIC;
+  float m = q - 4.f * ((q * 0.25f + FAST_ROUND_MAGIC) - FAST_ROUND_MAGIC);
+  float x = ((Angle - q * FAST_PIO2_1) - q * FAST_PIO2_2) - q * FAST_PIO2_3;
+  float z = x * x;
+  float w;
+  float s;
+  float c;
+  int   odd = (fabsf(m) == 1.f);
+
+  s = x + z * x * (-1.6666654611e-1f + z * (8.3321608736e-3f + z * -1.9515295891e-4f));
+  c = (1.f - 0.5f * z) + z * z * (4.166664568298827e-2f + z * (-1.388731625493765e-3f
+      + z * 2.443315711809948e-5f));
+  w = odd ? c : s;
+  c = odd ? s : c;
+  *Sin_Angle = ((m < 0.f) || (m > 1.5f)) ? -w : w;
+  *Cos_Angle = ((m > 0.5f) || (m < -1.5f)) ? -c : c;
+} /* END OF Fast_Sin_Cos */
+
+
+typedef struct Fast_Terms_Value
+{
+  double ap;              /* Meridional distance per radian of latitude */
+  double Origin_Tmd;      /* True meridional distance of Origin_Lat     */
+  double Scale_Factor;
+  double False_Easting;
+  double False_Northing;
+  float  a_k0;            /* Semi-major axis times scale factor         */
+  float  es;
+  float  ebs;
+  float  bp;              /* Meridional distance series                 */
+  float  cp;
+  float  dp;
+  float  ep;
+} Fast_Terms;
+
+
+static FORCE_INLINE void Fast_Project_Point (const Fast_Terms *k,
+                                             double Latitude,
+                                             double dlam,
+                                             double *Easting,
+                                             double *Northing)
+{ /* BEGIN Fast_Project_Point */
+  /*
+   * The function Fast_Project_Point is the single precision form of
+   * Project_Point.  Only the meridional distance term, which grows to 10^7
+   * meters, is summed in double precision; the trigonometric functions and
+   * the series in the longitude difference, which stay under 10^6 meters,
+   * are evaluated in single precision.
+   *
+   *    k             : Projection terms of Fast_Project_Block      (input)
+   *    Latitude      : Latitude in radians                         (input)
+   *    dlam          : Longitude less the central meridian         (input)
+   *    Easting       : Easting/X in meters                         (output)
+   *    Northing      : Northing/Y in meters                        (output)
+   */
+
+  float l = (float)dlam;
+  float l2 = l * l;
+  float s;
+  float c;
+  float c2;
+  float c3;
+  float c5;
+  float c7;
+  float t;
+  float tan2;
+  float tan4;
+  float tan6;
+  float eta;
+  float eta2;
+  float eta3;
+  float eta4;
+  float x;
+  float sn_k0;    /* Radius of curvature in the prime vertical times k0 */
+  float y;
+  float b1;
+  float b2;
+  float b3;
+  float t2;
+  float t3;
+  float t4;
+  float t5;
+  float t6;
+  float t7;
+  float t8;
+  float t9;
+
+  Fast_Sin_Cos((float)Latitude, &s, &c);
+  c2 = c * c;
+  c3 = c2 * c;
+  c5 = c3 * c2;
+  c7 = c5 * c2;
+  t = s / c;
+  tan2 = t * t;
+  tan4 = tan2 * tan2;
+  tan6 = tan4 * tan2;
+  eta = k->ebs * c2;
+  eta2 = eta * eta;
+  eta3 = eta2 * eta;
+  eta4 = eta3 * eta;
+
+  x = k->es * s * s;
+  sn_k0 = k->a_k0 * (1.f + x * (0.5f + x * (0.375f + x * (0.3125f + x * 0.2734375f))));
+
+  /* periodic part of the true meridional distance, as in SPHTMD */
+  y = 2.f * (c2 - s * s);
+  b3 = y * k->ep - k->dp;
+  b2 = y * b3 - k->ep + k->cp;
+  b1 = y * b2 - b3 - k->bp;
+
+  t2 = sn_k0 * s * c * 0.5f;
+  t3 = sn_k0 * s * c3 * (5.f - tan2 + 9.f * eta + 4.f * eta2) * (1.f / 24.f);
+  t4 = sn_k0 * s * c5 * (61.f - 58.f * tan2 + tan4 + 270.f * eta - 330.f * tan2 * eta
+                         + 445.f * eta2 + 324.f * eta3 - 680.f * tan2 * eta2 + 88.f * eta4
+                         - 600.f * tan2 * eta3 - 192.f * tan2 * eta4) * (1.f / 720.f);
+  t5 = sn_k0 * s * c7 * (1385.f - 3111.f * tan2 + 543.f * tan4 - tan6) * (1.f / 40320.f);
+  *Northing = k->False_Northing
+              + ((k->ap * Latitude - k->Origin_Tmd) + (double)(b1 * 2.f * s * c)) * k->Scale_Factor
+              + (double)(l2 * (t2 + l2 * (t3 + l2 * (t4 + l2 * t5))));
+
+  t6 = sn_k0 * c;
+  t7 = sn_k0 * c3 * (1.f - tan2 + eta) * (1.f / 6.f);
+  t8 = sn_k0 * c5 * (5.f - 18.f * tan2 + tan4 + 14.f * eta - 58.f * tan2 * eta + 13.f * eta2
+                     + 4.f * eta3 - 64.f * tan2 * eta2 - 24.f * tan2 * eta3) * (1.f / 120.f);
+  t9 = sn_k0 * c7 * (61.f - 479.f * tan2 + 179.f * tan4 - tan6) * (1.f / 5040.f);
+  *Easting = k->False_Easting + (double)(l * (t6 + l2 * (t7 + l2 * (t8 + l2 * t9))));
+} /* END OF Fast_Project_Point */
+
+
+BATCH_KERNEL
+static void Fast_Project_Block (const Transverse_Mercator_Context *ctx,
+                                const double *restrict Latitude,
+                                const double *restrict Delta_Long,
+                                size_t Count,
+                                double *restrict Easting,
+                                double *restrict Northing)
+{ /* BEGIN Fast_Project_Block */
+  /*
+   * The function Fast_Project_Block runs Fast_Project_Point over arrays of
+   * latitudes and longitude differences.  Single precision fits twice as
+   * many rows in a vector as Project_Block does.
+   */
+
+  Fast_Terms k;
+  size_t i;
+
+  k.ap = ctx->ap;
+  k.Origin_Tmd = ctx->Origin_Tmd;
+  k.Scale_Factor = ctx->Scale_Factor;
+  k.False_Easting = ctx->False_Easting;
+  k.False_Northing = ctx->False_Northing;
+  k.a_k0 = (float)(ctx->a * ctx->Scale_Factor);
+  k.es = (float)ctx->es;
+  k.ebs = (float)ctx->ebs;
+  k.bp = (float)ctx->bp;
+  k.cp = (float)ctx->cp;
+  k.dp = (float)ctx->dp;
+  k.ep = (float)ctx->ep;
+  for (i = 0; i < Count; i++)
+    Fast_Project_Point(&k, Latitude[i], Delta_Long[i], &Easting[i], &Northing[i]);
+} /* END OF Fast_Project_Block */
+
+
+long Convert_Geodetic_To_Transverse_Mercator_Batch (const double *Latitude,
+                                                    const double *Longitude,
+                                                    size_t Count,
+                                                    double *Easting,
+                                                    double *Northing,
+                                                    long *Error_Codes)
+
+{      /* BEGIN Convert_Geodetic_To_Transverse_Mercator_Batch */
+
+  /*
+   * The function Convert_Geodetic_To_Transverse_Mercator_Batch converts
+   * geodetic coordinates using the file-scope state.  See
+   * Convert_Geodetic_To_Transverse_Mercator_Batch_Ctx.
+   */
+
+  return Convert_Geodetic_To_Transverse_Mercator_Batch_Ctx(&TranMerc_Context, Latitude, Longitude,
+                                                           Count, Easting, Northing, Error_Codes);
+} /* END OF Convert_Geodetic_To_Transverse_Mercator_Batch */
+
+
+static long Project_Rows (const Transverse_Mercator_Context *ctx,
+                          const double *Latitude,
+                          const double *Longitude,
+                          size_t Count,
+                          double *Easting,
+                          double *Northing,
+                          long *Error_Codes,
+                          int Fast)
+{ /* BEGIN Project_Rows */
+  /*
+   * The function Project_Rows checks and projects Count geodetic
+   * coordinates block by block, with Fast_Project_Block if Fast is set and
+   * the kernel of the context's engine otherwise.  Rows with errors other
+   * than TRANMERC_LON_WARNING are left unchanged and counted.
+   *
+   *    ctx           : Transverse Mercator context                 (input)
+   *    Latitude      : Latitudes in radians                        (input)
+   *    Longitude     : Longitudes in radians                       (input)
+   *    Count         : Number of coordinates                       (input)
+   *    Easting       : Eastings/X in meters                        (output)
+   *    Northing      : Northings/Y in meters                       (output)
+   *    Error_Codes   : Error code of each row, or NULL             (output)
+   *    Fast          : Nonzero for the single precision kernel     (input)
+   */
+
+  double lat[BATCH_BLOCK];
+  double dlam[BATCH_BLOCK];
+  double east[BATCH_BLOCK];
+  double north[BATCH_BLOCK];
+  long   code[BATCH_BLOCK];
+  size_t start;
+  size_t n;
+  size_t i;
+  long   Error_Count = 0;
+
+  for (start = 0; start < Count; start += n)
   {
-    if (Longitude < 0)
-      temp_Long = Longitude + 2 * PI;
-    else
-      temp_Long = Longitude;
-    if (TranMerc_Origin_Long < 0)
-      temp_Origin = TranMerc_Origin_Long + 2 * PI;
+    n = Count - start;
+    if (n > BATCH_BLOCK)
+      n = BATCH_BLOCK;
+    for (i = 0; i < n; i++)
+    {
+      code[i] = Check_Geodetic(ctx, Latitude[start + i], Longitude[start + i], &dlam[i]);
+      if (code[i] & ~TRANMERC_LON_WARNING)
+      { /* project a harmless stand-in, the result is dropped */
+        lat[i] = 0.0;
+        dlam[i] = 0.0;
+      }
+      else
+        lat[i] = Latitude[start + i];
+    }
+    if (Fast)
+      Fast_Project_Block(ctx, lat, dlam, n, east, north);
+    else if (ctx->Engine == TRANMERC_KRUGER)
+      Kruger_Project_Block(ctx, lat, dlam, n, east, north);
     else
-      temp_Origin = TranMerc_Origin_Long;
-    if ((temp_Long < (temp_Origin - MAX_DELTA_LONG))
-        || (temp_Long > (temp_Origin + MAX_DELTA_LONG)))
-      Error_Code|= TRANMERC_LON_ERROR;
+      Project_Block(ctx, lat, dlam, n, east, north);
+    for (i = 0; i < n; i++)
+    {
+      if (code[i] & ~TRANMERC_LON_WARNING)
+        Error_Count++;
+      else
+      {
+        Easting[start + i] = east[i];
+        Northing[start + i] = north[i];
+      }
+      if (Error_Codes)
+        Error_Codes[start + i] = code[i];
+    }
   }
-  if (!Error_Code)
-  { /* no errors */
+  return (Error_Count);
+} /* END OF Project_Rows */
 
-    /* 
-     *  Delta Longitude
-     */
-    dlam = Longitude - TranMerc_Origin_Long;
 
-    if (fabs(dlam) > (9.0 * PI / 180))
-    { /* Distortion will result if Longitude is more than 9 degrees from the Central Meridian */
-      Error_Code |= TRANMERC_LON_WARNING;
-    }
+long Convert_Geodetic_To_Transverse_Mercator_Batch_Ctx (const Transverse_Mercator_Context *ctx,
+                                                        const double *Latitude,
+                                                        const double *Longitude,
+                                                        size_t Count,
+                                                        double *Easting,
+                                                        double *Northing,
+                                                        long *Error_Codes)
 
-    if (dlam > PI)
-      dlam -= (2 * PI);
-    if (dlam < -PI)
-      dlam += (2 * PI);
-    if (fabs(dlam) < 2.e-10)
-      dlam = 0.0;
+{      /* BEGIN Convert_Geodetic_To_Transverse_Mercator_Batch_Ctx */
 
-    s = sin(Latitude);
-    c = cos(Latitude);
-    c2 = c * c;
-    c3 = c2 * c;
-    c5 = c3 * c2;
-    c7 = c5 * c2;
-    t = tan (Latitude);
-    tan2 = t * t;
-    tan3 = tan2 * t;
-    tan4 = tan3 * t;
-    tan5 = tan4 * t;
-    tan6 = tan5 * t;
-    eta = TranMerc_ebs * c2;
-    eta2 = eta * eta;
-    eta3 = eta2 * eta;
-    eta4 = eta3 * eta;
-
-    /* radius of curvature in prime vertical */
-    sn = SPHSN(Latitude);
-
-    /* True Meridianal Distances */
-    tmd = SPHTMD(Latitude);
-
-    /*  Origin  */
-    tmdo = SPHTMD (TranMerc_Origin_Lat);
-
-    /* northing */
-    t1 = (tmd - tmdo) * TranMerc_Scale_Factor;
-    t2 = sn * s * c * TranMerc_Scale_Factor/ 2.e0;
-    t3 = sn * s * c3 * TranMerc_Scale_Factor * (5.e0 - tan2 + 9.e0 * eta 
-                                                + 4.e0 * eta2) /24.e0; 
-
-    t4 = sn * s * c5 * TranMerc_Scale_Factor * (61.e0 - 58.e0 * tan2
-                                                + tan4 + 270.e0 * eta - 330.e0 * tan2 * eta + 445.e0 * eta2
-                                                + 324.e0 * eta3 -680.e0 * tan2 * eta2 + 88.e0 * eta4 
-                                                -600.e0 * tan2 * eta3 - 192.e0 * tan2 * eta4) / 720.e0;
-
-    t5 = sn * s * c7 * TranMerc_Scale_Factor * (1385.e0 - 3111.e0 * 
-                                                tan2 + 543.e0 * tan4 - tan6) / 40320.e0;
-
-    *Northing = TranMerc_False_Northing + t1 + pow(dlam,2.e0) * t2
-                + pow(dlam,4.e0) * t3 + pow(dlam,6.e0) * t4
-                + pow(dlam,8.e0) * t5; 
-
-    /* Easting */
-    t6 = sn * c * TranMerc_Scale_Factor;
-    t7 = sn * c3 * TranMerc_Scale_Factor * (1.e0 - tan2 + eta ) /6.e0;
-    t8 = sn * c5 * TranMerc_Scale_Factor * (5.e0 - 18.e0 * tan2 + tan4
-                                            + 14.e0 * eta - 58.e0 * tan2 * eta + 13.e0 * eta2 + 4.e0 * eta3 
-                                            - 64.e0 * tan2 * eta2 - 24.e0 * tan2 * eta3 )/ 120.e0;
-    t9 = sn * c7 * TranMerc_Scale_Factor * ( 61.e0 - 479.e0 * tan2
-                                             + 179.e0 * tan4 - tan6 ) /5040.e0;
-
-    *Easting = TranMerc_False_Easting + dlam * t6 + pow(dlam,3.e0) * t7 
-               + pow(dlam,5.e0) * t8 + pow(dlam,7.e0) * t9;
-  }
-  return (Error_Code);
-} /* END OF Convert_Geodetic_To_Transverse_Mercator */
+  /*
+   * The function Convert_Geodetic_To_Transverse_Mercator_Batch_Ctx converts
+   * Count geodetic (latitude and longitude) coordinates to Transverse
+   * Mercator projection (easting and northing) coordinates, according to the
+   * ellipsoid and projection parameters held in ctx.  Each row gets exactly
+   * what Convert_Geodetic_To_Transverse_Mercator_Ctx returns for it; rows
+   * with errors other than TRANMERC_LON_WARNING are left unchanged.  The
+   * number of such rows is returned by the function.
+   *
+   *    ctx           : Transverse Mercator context                 (input)
+   *    Latitude      : Latitudes in radians                        (input)
+   *    Longitude     : Longitudes in radians                       (input)
+   *    Count         : Number of coordinates                       (input)
+   *    Easting       : Eastings/X in meters                        (output)
+   *    Northing      : Northings/Y in meters                       (output)
+   *    Error_Codes   : Error code of each row, or NULL             (output)
+   */
+
+  return Project_Rows(ctx, Latitude, Longitude, Count, Easting, Northing, Error_Codes, 0);
+} /* END OF Convert_Geodetic_To_Transverse_Mercator_Batch_Ctx */
+
+
+long Convert_Geodetic_To_Transverse_Mercator_Fast_Batch (const double *Latitude,
+                                                         const double *Longitude,
+                                                         size_t Count,
+                                                         double *Easting,
+                                                         double *Northing,
+                                                         long *Error_Codes)
+
+{      /* BEGIN Convert_Geodetic_To_Transverse_Mercator_Fast_Batch */
+
+  /*
+   * The function Convert_Geodetic_To_Transverse_Mercator_Fast_Batch converts
+   * geodetic coordinates using the file-scope state.  See
+   * Convert_Geodetic_To_Transverse_Mercator_Fast_Batch_Ctx.
+   */
+
+  return Convert_Geodetic_To_Transverse_Mercator_Fast_Batch_Ctx(&TranMerc_Context, Latitude,
+                                                                Longitude, Count, Easting,
+                                                                Northing, Error_Codes);
+} /* END OF Convert_Geodetic_To_Transverse_Mercator_Fast_Batch */
+
+
+long Convert_Geodetic_To_Transverse_Mercator_Fast_Batch_Ctx (const Transverse_Mercator_Context *ctx,
+                                                             const double *Latitude,
+                                                             const double *Longitude,
+                                                             size_t Count,
+                                                             double *Easting,
+                                                             double *Northing,
+                                                             long *Error_Codes)
+
+{      /* BEGIN Convert_Geodetic_To_Transverse_Mercator_Fast_Batch_Ctx */
+
+  /*
+   * The function Convert_Geodetic_To_Transverse_Mercator_Fast_Batch_Ctx is
+   * Convert_Geodetic_To_Transverse_Mercator_Batch_Ctx with the Thomas series
+   * evaluated mostly in single precision, whatever the engine of ctx.  Error
+   * codes are the same; eastings and northings are within
+   * TRANMERC_FAST_TOLERANCE meters of the double precision ones.
+   *
+   *    ctx           : Transverse Mercator context                 (input)
+   *    Latitude      : Latitudes in radians                        (input)
+   *    Longitude     : Longitudes in radians                       (input)
+   *    Count         : Number of coordinates                       (input)
+   *    Easting       : Eastings/X in meters                        (output)
+   *    Northing      : Northings/Y in meters                       (output)
+   *    Error_Codes   : Error code of each row, or NULL             (output)
+   */
+
+  return Project_Rows(ctx, Latitude, Longitude, Count, Easting, Northing, Error_Codes, 1);
+} /* END OF Convert_Geodetic_To_Transverse_Mercator_Fast_Batch_Ctx */
 
 
 long Convert_Transverse_Mercator_To_Geodetic (
@@ -463,156 +1775,199 @@ long Convert_Transverse_Mercator_To_Geodetic (
 
   /*
    * The function Convert_Transverse_Mercator_To_Geodetic converts Transverse
-   * Mercator projection (easting and northing) coordinates to geodetic
-   * (latitude and longitude) coordinates, according to the current ellipsoid
-   * and Transverse Mercator projection parameters.  If any errors occur, the
-   * error code(s) are returned by the function, otherwise TRANMERC_NO_ERROR is
-   * returned.
+   * Mercator projection coordinates using the file-scope state.  See
+   * Convert_Transverse_Mercator_To_Geodetic_Ctx.
+   */
+
+  return Convert_Transverse_Mercator_To_Geodetic_Ctx(&TranMerc_Context, Easting,
+                                                     Northing, Latitude, Longitude);
+} /* END OF Convert_Transverse_Mercator_To_Geodetic */
+
+
+long Convert_Transverse_Mercator_To_Geodetic_Ctx (
+                                                 const Transverse_Mercator_Context *ctx,
+                                                 double Easting,
+                                                 double Northing,
+                                                 double *Latitude,
+                                                 double *Longitude)
+{      /* BEGIN Convert_Transverse_Mercator_To_Geodetic_Ctx */
+
+  /*
+   * The function Convert_Transverse_Mercator_To_Geodetic_Ctx converts
+   * Transverse Mercator projection (easting and northing) coordinates to
+   * geodetic (latitude and longitude) coordinates, according to the ellipsoid
+   * and Transverse Mercator projection parameters held in ctx.  If any errors
+   * occur, the error code(s) are returned by the function, otherwise
+   * TRANMERC_NO_ERROR is returned.
    *
+   *    ctx           : Transverse Mercator context                 (input)
    *    Easting       : Easting/X in meters                         (input)
    *    Northing      : Northing/Y in meters                        (input)
    *    Latitude      : Latitude in radians                         (output)
    *    Longitude     : Longitude in radians                        (output)
    */
 
-  double c;       /* Cosine of latitude                          */
-  double de;      /* Delta easting - Difference in Easting (Easting-Fe)    */
+  double Lat;     /* Latitude                                        */
   double dlam;    /* Delta longitude - Difference in Longitude       */
-  double eta;     /* constant - TranMerc_ebs *c *c                   */
-  double eta2;
-  double eta3;
-  double eta4;
-  double ftphi;   /* Footpoint latitude                              */
-  int    i;       /* Loop iterator                   */
-  double s;       /* Sine of latitude                        */
-  double sn;      /* Radius of curvature in the prime vertical       */
-  double sr;      /* Radius of curvature in the meridian             */
-  double t;       /* Tangent of latitude                             */
-  double tan2;
-  double tan4;
-  double t10;     /* Term in coordinate conversion formula - GP to Y */
-  double t11;     /* Term in coordinate conversion formula - GP to Y */
-  double t12;     /* Term in coordinate conversion formula - GP to Y */
-  double t13;     /* Term in coordinate conversion formula - GP to Y */
-  double t14;     /* Term in coordinate conversion formula - GP to Y */
-  double t15;     /* Term in coordinate conversion formula - GP to Y */
-  double t16;     /* Term in coordinate conversion formula - GP to Y */
-  double t17;     /* Term in coordinate conversion formula - GP to Y */
-  double tmd;     /* True Meridional distance                        */
-  double tmdo;    /* True Meridional distance for latitude of origin */
-  long Error_Code = TRANMERC_NO_ERROR;
-
-  if ((Easting < (TranMerc_False_Easting - TranMerc_Delta_Easting))
-      ||(Easting > (TranMerc_False_Easting + TranMerc_Delta_Easting)))
-  { /* Easting out of range  */
-    Error_Code |= TRANMERC_EASTING_ERROR;
-  }
-  if ((Northing < (TranMerc_False_Northing - TranMerc_Delta_Northing))
-      || (Northing > (TranMerc_False_Northing + TranMerc_Delta_Northing)))
-  { /* Northing out of range */
-    Error_Code |= TRANMERC_NORTHING_ERROR;
-  }
+  double Cos_Lat; /* Cosine of latitude                              */
+  long Error_Code;
 
+  Error_Code = Check_Projected(ctx, Easting, Northing);
   if (!Error_Code)
   {
-    /* True Meridional Distances for latitude of origin */
-    tmdo = SPHTMD(TranMerc_Origin_Lat);
+    if (ctx->Engine == TRANMERC_KRUGER)
+      Kruger_Unproject_Point(ctx, Easting, Northing, &Lat, &dlam, &Cos_Lat);
+    else
+      Unproject_Point(ctx, Easting, Northing, &Lat, &dlam, &Cos_Lat);
+    Error_Code = Finish_Geodetic(ctx, Lat, dlam, Cos_Lat, Latitude, Longitude);
+  }
+  return (Error_Code);
+} /* END OF Convert_Transverse_Mercator_To_Geodetic_Ctx */
+
+
+BATCH_KERNEL
+static void Unproject_Block (const Transverse_Mercator_Context *ctx,
+                             const double *restrict Easting,
+                             const double *restrict Northing,
+                             size_t Count,
+                             double *restrict Latitude,
+                             double *restrict Delta_Long,
+                             double *restrict Cos_Lat)
+{ /* BEGIN Unproject_Block */
+  /*
+   * The function Unproject_Block runs Unproject_Point over arrays of
+   * eastings and northings, several rows per vector instruction.
+   *
+   *    ctx           : Transverse Mercator context                 (input)
+   *    Easting       : Eastings/X in meters                        (input)
+   *    Northing      : Northings/Y in meters                       (input)
+   *    Count         : Number of rows                              (input)
+   *    Latitude      : Latitudes in radians                        (output)
+   *    Delta_Long    : Longitudes less the central meridian        (output)
+   *    Cos_Lat       : Cosines of the latitudes                    (output)
+   */
 
-    /*  Origin  */
-    tmd = tmdo +  (Northing - TranMerc_False_Northing) / TranMerc_Scale_Factor; 
+  size_t i;
 
-    /* First Estimate */
-    sr = SPHSR(0.e0);
-    ftphi = tmd/sr;
+  for (i = 0; i < Count; i++)
+    Unproject_Point(ctx, Easting[i], Northing[i], &Latitude[i], &Delta_Long[i], &Cos_Lat[i]);
+} /* END OF Unproject_Block */
 
-    for (i = 0; i < 5 ; i++)
-    {
-      t10 = SPHTMD (ftphi);
-      sr = SPHSR(ftphi);
-      ftphi = ftphi + (tmd - t10) / sr;
-    }
 
-    /* Radius of Curvature in the meridian */
-    sr = SPHSR(ftphi);
-
-    /* Radius of Curvature in the meridian */
-    sn = SPHSN(ftphi);
-
-    /* Sine Cosine terms */
-    s = sin(ftphi);
-    c = cos(ftphi);
-
-    /* Tangent Value  */
-    t = tan(ftphi);
-    tan2 = t * t;
-    tan4 = tan2 * tan2;
-    eta = TranMerc_ebs * pow(c,2);
-    eta2 = eta * eta;
-    eta3 = eta2 * eta;
-    eta4 = eta3 * eta;
-    de = Easting - TranMerc_False_Easting;
-    if (fabs(de) < 0.0001)
-      de = 0.0;
-
-    /* Latitude */
-    t10 = t / (2.e0 * sr * sn * pow(TranMerc_Scale_Factor, 2));
-    t11 = t * (5.e0  + 3.e0 * tan2 + eta - 4.e0 * pow(eta,2)
-               - 9.e0 * tan2 * eta) / (24.e0 * sr * pow(sn,3) 
-                                       * pow(TranMerc_Scale_Factor,4));
-    t12 = t * (61.e0 + 90.e0 * tan2 + 46.e0 * eta + 45.E0 * tan4
-               - 252.e0 * tan2 * eta  - 3.e0 * eta2 + 100.e0 
-               * eta3 - 66.e0 * tan2 * eta2 - 90.e0 * tan4
-               * eta + 88.e0 * eta4 + 225.e0 * tan4 * eta2
-               + 84.e0 * tan2* eta3 - 192.e0 * tan2 * eta4)
-          / ( 720.e0 * sr * pow(sn,5) * pow(TranMerc_Scale_Factor, 6) );
-    t13 = t * ( 1385.e0 + 3633.e0 * tan2 + 4095.e0 * tan4 + 1575.e0 
-                * pow(t,6))/ (40320.e0 * sr * pow(sn,7) * pow(TranMerc_Scale_Factor,8));
-    *Latitude = ftphi - pow(de,2) * t10 + pow(de,4) * t11 - pow(de,6) * t12 
-                + pow(de,8) * t13;
-
-    t14 = 1.e0 / (sn * c * TranMerc_Scale_Factor);
-
-    t15 = (1.e0 + 2.e0 * tan2 + eta) / (6.e0 * pow(sn,3) * c * 
-                                        pow(TranMerc_Scale_Factor,3));
-
-    t16 = (5.e0 + 6.e0 * eta + 28.e0 * tan2 - 3.e0 * eta2
-           + 8.e0 * tan2 * eta + 24.e0 * tan4 - 4.e0 
-           * eta3 + 4.e0 * tan2 * eta2 + 24.e0 
-           * tan2 * eta3) / (120.e0 * pow(sn,5) * c  
-                             * pow(TranMerc_Scale_Factor,5));
-
-    t17 = (61.e0 +  662.e0 * tan2 + 1320.e0 * tan4 + 720.e0 
-           * pow(t,6)) / (5040.e0 * pow(sn,7) * c 
-                          * pow(TranMerc_Scale_Factor,7));
-
-    /* Difference in Longitude */
-    dlam = de * t14 - pow(de,3) * t15 + pow(de,5) * t16 - pow(de,7) * t17;
-
-    /* Longitude */
-    (*Longitude) = TranMerc_Origin_Long + dlam;
-
-    if((fabs)(*Latitude) > (90.0 * PI / 180.0))
-      Error_Code |= TRANMERC_NORTHING_ERROR;
-
-    if((*Longitude) > (PI))
+BATCH_KERNEL
+static void Kruger_Unproject_Block (const Transverse_Mercator_Context *ctx,
+                                    const double *restrict Easting,
+                                    const double *restrict Northing,
+                                    size_t Count,
+                                    double *restrict Latitude,
+                                    double *restrict Delta_Long,
+                                    double *restrict Cos_Lat)
+{ /* BEGIN Kruger_Unproject_Block */
+  /*
+   * The function Kruger_Unproject_Block is the TRANMERC_KRUGER form of
+   * Unproject_Block.
+   */
+
+  size_t i;
+
+  for (i = 0; i < Count; i++)
+    Kruger_Unproject_Point(ctx, Easting[i], Northing[i], &Latitude[i], &Delta_Long[i], &Cos_Lat[i]);
+} /* END OF Kruger_Unproject_Block */
+
+
+long Convert_Transverse_Mercator_To_Geodetic_Batch (const double *Easting,
+                                                    const double *Northing,
+                                                    size_t Count,
+                                                    double *Latitude,
+                                                    double *Longitude,
+                                                    long *Error_Codes)
+
+{      /* BEGIN Convert_Transverse_Mercator_To_Geodetic_Batch */
+
+  /*
+   * The function Convert_Transverse_Mercator_To_Geodetic_Batch converts
+   * Transverse Mercator projection coordinates using the file-scope state.
+   * See Convert_Transverse_Mercator_To_Geodetic_Batch_Ctx.
+   */
+
+  return Convert_Transverse_Mercator_To_Geodetic_Batch_Ctx(&TranMerc_Context, Easting, Northing,
+                                                           Count, Latitude, Longitude, Error_Codes);
+} /* END OF Convert_Transverse_Mercator_To_Geodetic_Batch */
+
+
+long Convert_Transverse_Mercator_To_Geodetic_Batch_Ctx (const Transverse_Mercator_Context *ctx,
+                                                        const double *Easting,
+                                                        const double *Northing,
+                                                        size_t Count,
+                                                        double *Latitude,
+                                                        double *Longitude,
+                                                        long *Error_Codes)
+
+{      /* BEGIN Convert_Transverse_Mercator_To_Geodetic_Batch_Ctx */
+
+  /*
+   * The function Convert_Transverse_Mercator_To_Geodetic_Batch_Ctx converts
+   * Count Transverse Mercator projection (easting and northing) coordinates
+   * to geodetic (latitude and longitude) coordinates, according to the
+   * ellipsoid and projection parameters held in ctx.  Each row gets exactly
+   * what Convert_Transverse_Mercator_To_Geodetic_Ctx returns for it; rows
+   * outside the range of the projection are left unchanged.  The number of
+   * rows with errors other than TRANMERC_LON_WARNING is returned by the
+   * function.
+   *
+   *    ctx           : Transverse Mercator context                 (input)
+   *    Easting       : Eastings/X in meters                        (input)
+   *    Northing      : Northings/Y in meters                       (input)
+   *    Count         : Number of coordinates                       (input)
+   *    Latitude      : Latitudes in radians                        (output)
+   *    Longitude     : Longitudes in radians                       (output)
+   *    Error_Codes   : Error code of each row, or NULL             (output)
+   */
+
+  double east[BATCH_BLOCK];
+  double north[BATCH_BLOCK];
+  double lat[BATCH_BLOCK];
+  double dlam[BATCH_BLOCK];
+  double cos_lat[BATCH_BLOCK];
+  long   code[BATCH_BLOCK];
+  size_t start;
+  size_t n;
+  size_t i;
+  long   Error_Count = 0;
+
+  for (start = 0; start < Count; start += n)
+  {
+    n = Count - start;
+    if (n > BATCH_BLOCK)
+      n = BATCH_BLOCK;
+    for (i = 0; i < n; i++)
     {
-      *Longitude -= (2 * PI);
-      if((fabs)(*Longitude) > PI)
-        Error_Code |= TRANMERC_EASTING_ERROR;
+      code[i] = Check_Projected(ctx, Easting[start + i], Northing[start + i]);
+      if (code[i])
+      { /* project a harmless stand-in, the result is dropped */
+        east[i] = ctx->False_Easting;
+        north[i] = ctx->False_Northing;
+      }
+      else
+      {
+        east[i] = Easting[start + i];
+        north[i] = Northing[start + i];
+      }
     }
-    else if((*Longitude) < (-PI))
+    if (ctx->Engine == TRANMERC_KRUGER)
+      Kruger_Unproject_Block(ctx, east, north, n, lat, dlam, cos_lat);
+    else
+      Unproject_Block(ctx, east, north, n, lat, dlam, cos_lat);
+    for (i = 0; i < n; i++)
     {
-      *Longitude += (2 * PI);
-      if((fabs)(*Longitude) > PI)
-        Error_Code |= TRANMERC_EASTING_ERROR;
-    }
-
-    if (fabs(dlam) > (9.0 * PI / 180) * cos(*Latitude))
-    { /* Distortion will result if Longitude is more than 9 degrees from the Central Meridian at the equator */
-      /* and decreases to 0 degrees at the poles */
-      /* As you move towards the poles, distortion will become more significant */
-      Error_Code |= TRANMERC_LON_WARNING;
+      if (!code[i])
+        code[i] = Finish_Geodetic(ctx, lat[i], dlam[i], cos_lat[i],
+                                  &Latitude[start + i], &Longitude[start + i]);
+      if (code[i] & ~TRANMERC_LON_WARNING)
+        Error_Count++;
+      if (Error_Codes)
+        Error_Codes[start + i] = code[i];
     }
   }
-  return (Error_Code);
-} /* END OF Convert_Transverse_Mercator_To_Geodetic */
+  return (Error_Count);
+} /* END OF Convert_Transverse_Mercator_To_Geodetic_Batch_Ctx */
@@ -40,6 +40,8 @@
  *                                     range (0.3 to 3.0)
  *		 TM_LON_WARNING              : Distortion will result if longitude is more
  *                                      than 9 degrees from the Central Meridian
+ *       TRANMERC_ENGINE_ERROR       : Series engine is neither TRANMERC_THOMAS
+ *                                      nor TRANMERC_KRUGER
  *
  * REUSE NOTES
  *
@@ -99,6 +101,62 @@
   #define TRANMERC_INV_F_ERROR        0x0080
   #define TRANMERC_SCALE_FACTOR_ERROR 0x0100
   #define TRANMERC_LON_WARNING        0x0200
+  #define TRANMERC_ENGINE_ERROR       0x0400
+
+  #define TRANMERC_THOMAS             0  /* Thomas (Redfearn) series, the default */
+  #define TRANMERC_KRUGER             1  /* Kruger n-series, 6th order            */
+
+  #define TRANMERC_FAST_TOLERANCE     1.0  /* Meters, bound on the error of the */
+                                           /* _Fast_Batch functions             */
+
+
+  #include <stddef.h>
+
+
+/***************************************************************************/
+/*
+ *                              TYPES
+ */
+
+/*
+ * A Transverse_Mercator_Context holds the ellipsoid and projection state
+ * that the non-reentrant functions below keep in file-scope variables.
+ * Each thread of execution that converts coordinates concurrently must use
+ * its own context (or share one that is no longer being set).  A context
+ * must be set with Set_Transverse_Mercator_Parameters_Ctx before use.
+ */
+
+  typedef struct Transverse_Mercator_Context_Value
+  {
+    double a;               /* Semi-major axis of ellipsoid in meters        */
+    double f;               /* Flattening of ellipsoid                       */
+    double es;              /* Eccentricity squared                          */
+    double ebs;             /* Second eccentricity squared                   */
+    double Origin_Lat;      /* Latitude of origin in radians                 */
+    double Origin_Long;     /* Longitude of origin in radians                */
+    double False_Northing;  /* False northing in meters                      */
+    double False_Easting;   /* False easting in meters                       */
+    double Scale_Factor;    /* Scale factor                                  */
+    double ap;              /* Isometric to geodetic latitude parameters     */
+    double bp;
+    double cp;
+    double dp;
+    double ep;
+    double Delta_Easting;   /* Maximum variance for easting and northing     */
+    double Delta_Northing;
+    double Origin_Tmd;      /* True meridional distance of Origin_Lat        */
+    double Inv_a;           /* Reciprocal of a                               */
+    double Inv_Equator_Sr;  /* Reciprocal meridian radius at the equator     */
+    double Inv_Denom[8];    /* Reciprocal denominators of the inverse series */
+    long   Engine;          /* TRANMERC_THOMAS or TRANMERC_KRUGER            */
+    double e;               /* Eccentricity                                  */
+    double Kr_Radius;       /* Scale factor times rectifying radius          */
+    double Kr_Inv_Radius;   /* Reciprocal of Kr_Radius                       */
+    double Kr_Origin;       /* Kruger northing of Origin_Lat over Kr_Radius  */
+    double Alpha[6];        /* Kruger series, conformal to TM coordinates    */
+    double Beta[6];         /* Kruger series, TM to conformal coordinates    */
+    double Delta[6];        /* Conformal to geodetic latitude series         */
+  } Transverse_Mercator_Context;
 
 
 /***************************************************************************/
@@ -162,6 +220,30 @@ extern "C" {
  */
 
 
+  long Set_Transverse_Mercator_Engine(long Engine);
+/*
+ * The function Set_Transverse_Mercator_Engine selects the series the
+ * conversions evaluate: TRANMERC_THOMAS, the Thomas (Redfearn) series in
+ * powers of the longitude difference used by default, or TRANMERC_KRUGER,
+ * Kruger's series in the third flattening n to 6th order.  The Kruger
+ * series stays accurate to a few nanometers as far as 90 degrees from the
+ * central meridian, where the Thomas series is good to a millimeter only
+ * within about 9 degrees.  The range checks, and so the error codes, do not
+ * depend on the engine.  Setting the parameters selects TRANMERC_THOMAS
+ * again.  If Engine is invalid TRANMERC_ENGINE_ERROR is returned, otherwise
+ * TRANMERC_NO_ERROR.
+ *
+ *    Engine            : TRANMERC_THOMAS or TRANMERC_KRUGER         (input)
+ */
+
+
+  long Get_Transverse_Mercator_Engine(void);
+/*
+ * The function Get_Transverse_Mercator_Engine returns the series engine,
+ * TRANMERC_THOMAS or TRANMERC_KRUGER.
+ */
+
+
   long Convert_Geodetic_To_Transverse_Mercator (double Latitude,
                                                 double Longitude,
                                                 double *Easting,
@@ -202,6 +284,206 @@ extern "C" {
  */
 
 
+  long Set_Transverse_Mercator_Parameters_Ctx(Transverse_Mercator_Context *ctx,
+                                              double a,
+                                              double f,
+                                              double Origin_Latitude,
+                                              double Central_Meridian,
+                                              double False_Easting,
+                                              double False_Northing,
+                                              double Scale_Factor);
+/*
+ * The function Set_Transverse_Mercator_Parameters_Ctx is the reentrant form
+ * of Set_Transverse_Mercator_Parameters.  It sets the state variables held
+ * in the context ctx instead of the file-scope state.
+ *
+ *    ctx               : Transverse Mercator context                (output)
+ */
+
+
+  void Get_Transverse_Mercator_Parameters_Ctx(const Transverse_Mercator_Context *ctx,
+                                              double *a,
+                                              double *f,
+                                              double *Origin_Latitude,
+                                              double *Central_Meridian,
+                                              double *False_Easting,
+                                              double *False_Northing,
+                                              double *Scale_Factor);
+/*
+ * The function Get_Transverse_Mercator_Parameters_Ctx returns the ellipsoid
+ * and Transverse Mercator projection parameters held in the context ctx.
+ *
+ *    ctx               : Transverse Mercator context                (input)
+ */
+
+
+  long Set_Transverse_Mercator_Engine_Ctx(Transverse_Mercator_Context *ctx,
+                                          long Engine);
+/*
+ * The function Set_Transverse_Mercator_Engine_Ctx is the reentrant form of
+ * Set_Transverse_Mercator_Engine.  It selects the engine of the context ctx.
+ *
+ *    ctx               : Transverse Mercator context                (input/output)
+ */
+
+
+  long Get_Transverse_Mercator_Engine_Ctx(const Transverse_Mercator_Context *ctx);
+/*
+ * The function Get_Transverse_Mercator_Engine_Ctx returns the series
+ * engine of the context ctx.
+ *
+ *    ctx               : Transverse Mercator context                (input)
+ */
+
+
+  long Convert_Geodetic_To_Transverse_Mercator_Ctx (const Transverse_Mercator_Context *ctx,
+                                                    double Latitude,
+                                                    double Longitude,
+                                                    double *Easting,
+                                                    double *Northing);
+/*
+ * The function Convert_Geodetic_To_Transverse_Mercator_Ctx is the reentrant
+ * form of Convert_Geodetic_To_Transverse_Mercator.  It uses the ellipsoid
+ * and projection parameters held in the context ctx.
+ *
+ *    ctx           : Transverse Mercator context                 (input)
+ */
+
+
+  long Convert_Transverse_Mercator_To_Geodetic_Ctx (const Transverse_Mercator_Context *ctx,
+                                                    double Easting,
+                                                    double Northing,
+                                                    double *Latitude,
+                                                    double *Longitude);
+/*
+ * The function Convert_Transverse_Mercator_To_Geodetic_Ctx is the reentrant
+ * form of Convert_Transverse_Mercator_To_Geodetic.  It uses the ellipsoid
+ * and projection parameters held in the context ctx.
+ *
+ *    ctx           : Transverse Mercator context                 (input)
+ */
+
+
+  long Convert_Geodetic_To_Transverse_Mercator_Batch (const double *Latitude,
+                                                      const double *Longitude,
+                                                      size_t Count,
+                                                      double *Easting,
+                                                      double *Northing,
+                                                      long *Error_Codes);
+/*
+ * The function Convert_Geodetic_To_Transverse_Mercator_Batch converts Count
+ * geodetic coordinates to Transverse Mercator projection coordinates,
+ * according to the current ellipsoid and projection parameters, with a
+ * vectorized kernel.  Each row gets the result and error code that
+ * Convert_Geodetic_To_Transverse_Mercator returns for it; rows with errors
+ * other than TRANMERC_LON_WARNING are left unchanged.  The number of such
+ * rows is returned by the function.
+ *
+ *    Latitude      : Latitudes in radians                        (input)
+ *    Longitude     : Longitudes in radians                       (input)
+ *    Count         : Number of coordinates                       (input)
+ *    Easting       : Eastings/X in meters                        (output)
+ *    Northing      : Northings/Y in meters                       (output)
+ *    Error_Codes   : Error code of each row, or NULL             (output)
+ */
+
+
+  long Convert_Geodetic_To_Transverse_Mercator_Batch_Ctx (const Transverse_Mercator_Context *ctx,
+                                                          const double *Latitude,
+                                                          const double *Longitude,
+                                                          size_t Count,
+                                                          double *Easting,
+                                                          double *Northing,
+                                                          long *Error_Codes);
+/*
+ * The function Convert_Geodetic_To_Transverse_Mercator_Batch_Ctx is the
+ * reentrant form of Convert_Geodetic_To_Transverse_Mercator_Batch.  It uses
+ * the ellipsoid and projection parameters held in the context ctx.
+ *
+ *    ctx           : Transverse Mercator context                 (input)
+ */
+
+
+  long Convert_Geodetic_To_Transverse_Mercator_Fast_Batch (const double *Latitude,
+                                                           const double *Longitude,
+                                                           size_t Count,
+                                                           double *Easting,
+                                                           double *Northing,
+                                                           long *Error_Codes);
+/*
+ * The function Convert_Geodetic_To_Transverse_Mercator_Fast_Batch is
+ * Convert_Geodetic_To_Transverse_Mercator_Batch with a kernel that evaluates
+ * the Thomas series mostly in single precision, fitting twice as many rows
+ * in a vector, whatever the selected engine.  Error codes are the same, and
+ * for points within 9 degrees of the central meridian, 85 degrees of the
+ * equator and scale factors up to 1, eastings and northings are within
+ * TRANMERC_FAST_TOLERANCE meters of those of the double precision kernel.
+ *
+ *    Latitude      : Latitudes in radians                        (input)
+ *    Longitude     : Longitudes in radians                       (input)
+ *    Count         : Number of coordinates                       (input)
+ *    Easting       : Eastings/X in meters                        (output)
+ *    Northing      : Northings/Y in meters                       (output)
+ *    Error_Codes   : Error code of each row, or NULL             (output)
+ */
+
+
+  long Convert_Geodetic_To_Transverse_Mercator_Fast_Batch_Ctx (const Transverse_Mercator_Context *ctx,
+                                                               const double *Latitude,
+                                                               const double *Longitude,
+                                                               size_t Count,
+                                                               double *Easting,
+                                                               double *Northing,
+                                                               long *Error_Codes);
+/*
+ * The function Convert_Geodetic_To_Transverse_Mercator_Fast_Batch_Ctx is the
+ * reentrant form of Convert_Geodetic_To_Transverse_Mercator_Fast_Batch.  It
+ * uses the ellipsoid and projection parameters held in the context ctx.
+ *
+ *    ctx           : Transverse Mercator context                 (input)
+ */
+
+
+  long Convert_Transverse_Mercator_To_Geodetic_Batch (const double *Easting,
+                                                      const double *Northing,
+                                                      size_t Count,
+                                                      double *Latitude,
+                                                      double *Longitude,
+                                                      long *Error_Codes);
+/*
+ * The function Convert_Transverse_Mercator_To_Geodetic_Batch converts Count
+ * Transverse Mercator projection coordinates to geodetic coordinates,
+ * according to the current ellipsoid and projection parameters, with a
+ * vectorized kernel.  Each row gets the result and error code that
+ * Convert_Transverse_Mercator_To_Geodetic returns for it; rows outside the
+ * range of the projection are left unchanged.  The number of rows with
+ * errors other than TRANMERC_LON_WARNING is returned by the function.
+ *
+ *    Easting       : Eastings/X in meters                        (input)
+ *    Northing      : Northings/Y in meters                       (input)
+ *    Count         : Number of coordinates                       (input)
+ *    Latitude      : Latitudes in radians                        (output)
+ *    Longitude     : Longitudes in radians                       (output)
+ *    Error_Codes   : Error code of each row, or NULL             (output)
+ */
+
+
+  long Convert_Transverse_Mercator_To_Geodetic_Batch_Ctx (const Transverse_Mercator_Context *ctx,
+                                                          const double *Easting,
+                                                          const double *Northing,
+                                                          size_t Count,
+                                                          double *Latitude,
+                                                          double *Longitude,
+                                                          long *Error_Codes);
+/*
+ * The function Convert_Transverse_Mercator_To_Geodetic_Batch_Ctx is the
+ * reentrant form of Convert_Transverse_Mercator_To_Geodetic_Batch.  It uses
+ * the ellipsoid and projection parameters held in the context ctx.
+ *
+ *    ctx           : Transverse Mercator context                 (input)
+ */
+
+
   #ifdef __cplusplus
 }
   #endif
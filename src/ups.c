@@ -106,14 +106,119 @@
 #define MIN_SOUTH_LAT (-79.5*PI/180.0)
 #define MIN_EAST_NORTH 0
 #define MAX_EAST_NORTH 4000000
+#define BATCH_BLOCK    256   /* Rows converted at a time by the batch functions */
 
 /* Ellipsoid Parameters, default to WGS 84  */
-static double UPS_a = 6378137.0;          /* Semi-major axis of ellipsoid in meters   */
-static double UPS_f = 1 / 298.257223563;  /* Flattening of ellipsoid  */
+static UPS_Context UPS_Default_Context =
+  {
+    6378137.0,                /* Semi-major axis of ellipsoid in meters   */
+    1 / 298.257223563,        /* Flattening of ellipsoid  */
+    .Hemisphere_Parameters = {{0}}
+  };
+/* Hemisphere parameters of UPS_Default_Context are built on first use */
+static long UPS_Default_Context_Set = 0;
 const double UPS_False_Easting = 2000000;
 const double UPS_False_Northing = 2000000;
-static double UPS_Origin_Latitude = MAX_ORIGIN_LAT;  /*set default = North Hemisphere */
-static double UPS_Origin_Longitude = 0.0;
+static const double UPS_Origin_Longitude = 0.0;
+
+
+/************************************************************************/
+/*                              LOCAL FUNCTIONS
+ *
+ */
+
+static UPS_Context *Default_UPS_Context (void)
+{
+/*
+ * The function Default_UPS_Context returns the context used by the
+ * non-reentrant functions, computing its hemisphere parameters on first use.
+ */
+
+  if (!UPS_Default_Context_Set)
+  {
+    Set_UPS_Parameters_Ctx(&UPS_Default_Context, UPS_Default_Context.a,
+                           UPS_Default_Context.f);
+    UPS_Default_Context_Set = 1;
+  }
+  return (&UPS_Default_Context);
+}  /* END OF Default_UPS_Context */
+
+
+static long Check_Geodetic (double Latitude,
+                            double Longitude)
+{
+/*
+ * The function Check_Geodetic checks that a geodetic coordinate is within
+ * UPS coverage.  If any errors occur, the error code(s) are returned by the
+ * function, otherwise UPS_NO_ERROR is returned.
+ *
+ *    Latitude      : Latitude in radians                       (input)
+ *    Longitude     : Longitude in radians                      (input)
+ */
+
+  long Error_Code = UPS_NO_ERROR;
+
+  /* missing values (NaN) fail no comparison, so check them as well */
+  if ((Latitude < -MAX_LAT) || (Latitude > MAX_LAT) || (Latitude != Latitude))
+  {   /* latitude out of range */
+    Error_Code |= UPS_LAT_ERROR;
+  }
+  if ((Latitude < 0) && (Latitude > MIN_SOUTH_LAT))
+    Error_Code |= UPS_LAT_ERROR;
+  if ((Latitude >= 0) && (Latitude < MIN_NORTH_LAT))
+    Error_Code |= UPS_LAT_ERROR;
+  if ((Longitude < -PI) || (Longitude > (2 * PI)) || (Longitude != Longitude))
+  {  /* slam out of range */
+    Error_Code |= UPS_LON_ERROR;
+  }
+  return (Error_Code);
+}  /* END OF Check_Geodetic */
+
+
+static long Check_UPS (char   Hemisphere,
+                       double Easting,
+                       double Northing)
+{
+/*
+ * The function Check_UPS checks the range of UPS coordinates.  If any
+ * errors occur, the error code(s) are returned by the function, otherwise
+ * UPS_NO_ERROR is returned.
+ *
+ *    Hemisphere    : Hemisphere either 'N' or 'S'              (input)
+ *    Easting       : Easting/X in meters                       (input)
+ *    Northing      : Northing/Y in meters                      (input)
+ */
+
+  long Error_Code = UPS_NO_ERROR;
+
+  if ((Hemisphere != 'N') && (Hemisphere != 'S'))
+    Error_Code |= UPS_HEMISPHERE_ERROR;
+  if ((Easting < MIN_EAST_NORTH) || (Easting > MAX_EAST_NORTH) || (Easting != Easting))
+    Error_Code |= UPS_EASTING_ERROR;
+  if ((Northing < MIN_EAST_NORTH) || (Northing > MAX_EAST_NORTH) || (Northing != Northing))
+    Error_Code |= UPS_NORTHING_ERROR;
+  return (Error_Code);
+}  /* END OF Check_UPS */
+
+
+static long Check_UPS_Latitude (double Latitude)
+{
+/*
+ * The function Check_UPS_Latitude returns UPS_LAT_ERROR if the latitude
+ * found by an inverse projection is outside UPS coverage, otherwise
+ * UPS_NO_ERROR.
+ *
+ *    Latitude      : Latitude in radians                       (input)
+ */
+
+  long Error_Code = UPS_NO_ERROR;
+
+  if ((Latitude < 0) && (Latitude > MIN_SOUTH_LAT))
+    Error_Code |= UPS_LAT_ERROR;
+  if ((Latitude >= 0) && (Latitude < MIN_NORTH_LAT))
+    Error_Code |= UPS_LAT_ERROR;
+  return (Error_Code);
+}  /* END OF Check_UPS_Latitude */
 
 
 /************************************************************************/
@@ -132,6 +237,35 @@ long Set_UPS_Parameters( double a,
  *
  *   a     : Semi-major axis of ellipsoid in meters (input)
  *   f     : Flattening of ellipsoid					      (input)
+ */
+
+  long Error_Code = UPS_NO_ERROR;
+
+  if (UPS_Default_Context_Set && (a == UPS_Default_Context.a)
+      && (f == UPS_Default_Context.f))
+  { /* same ellipsoid, the hemisphere parameters are still current */
+    return (UPS_NO_ERROR);
+  }
+  Error_Code = Set_UPS_Parameters_Ctx(&UPS_Default_Context, a, f);
+  if (!Error_Code)
+    UPS_Default_Context_Set = 1;
+  return (Error_Code);
+}  /* END of Set_UPS_Parameters  */
+
+
+long Set_UPS_Parameters_Ctx( UPS_Context *ctx,
+                             double a,
+                             double f)
+{
+/*
+ * The function Set_UPS_Parameters_Ctx receives the ellipsoid parameters and
+ * sets the corresponding state variables in ctx. If any errors occur, the
+ * error code(s) are returned by the function, otherwise UPS_NO_ERROR is
+ * returned.
+ *
+ *   ctx   : UPS context                            (output)
+ *   a     : Semi-major axis of ellipsoid in meters (input)
+ *   f     : Flattening of ellipsoid                (input)
  */
 
   double inv_f = 1 / f;
@@ -148,11 +282,17 @@ long Set_UPS_Parameters( double a,
 
   if (!Error_Code)
   { /* no errors */
-    UPS_a = a;
-    UPS_f = f;
+    ctx->a = a;
+    ctx->f = f;
+    Set_Polar_Stereographic_Parameters_Ctx(&ctx->Hemisphere_Parameters[0],
+                                           a, f, MAX_ORIGIN_LAT, UPS_Origin_Longitude,
+                                           UPS_False_Easting, UPS_False_Northing);
+    Set_Polar_Stereographic_Parameters_Ctx(&ctx->Hemisphere_Parameters[1],
+                                           a, f, -MAX_ORIGIN_LAT, UPS_Origin_Longitude,
+                                           UPS_False_Easting, UPS_False_Northing);
   }
   return (Error_Code);
-}  /* END of Set_UPS_Parameters  */
+}  /* END of Set_UPS_Parameters_Ctx  */
 
 
 void Get_UPS_Parameters( double *a,
@@ -165,12 +305,30 @@ void Get_UPS_Parameters( double *a,
  *  f      : Flattening of ellipsoid					       (output)
  */
 
-  *a = UPS_a;
-  *f = UPS_f;
+  Get_UPS_Parameters_Ctx(&UPS_Default_Context, a, f);
   return;
 } /* END OF Get_UPS_Parameters */
 
 
+void Get_UPS_Parameters_Ctx( const UPS_Context *ctx,
+                             double *a,
+                             double *f)
+{
+/*
+ * The function Get_UPS_Parameters_Ctx returns the ellipsoid parameters held
+ * in ctx.
+ *
+ *  ctx    : UPS context                             (input)
+ *  a      : Semi-major axis of ellipsoid, in meters (output)
+ *  f      : Flattening of ellipsoid                 (output)
+ */
+
+  *a = ctx->a;
+  *f = ctx->f;
+  return;
+} /* END OF Get_UPS_Parameters_Ctx */
+
+
 long Convert_Geodetic_To_UPS ( double Latitude,
                                double Longitude,
                                char   *Hemisphere,
@@ -191,54 +349,56 @@ long Convert_Geodetic_To_UPS ( double Latitude,
  *    Northing      : Northing/Y in meters                      (output)
  */
 
-  double tempEasting, tempNorthing;
-  long Error_Code = UPS_NO_ERROR;
+  return Convert_Geodetic_To_UPS_Ctx(Default_UPS_Context(), Latitude, Longitude,
+                                     Hemisphere, Easting, Northing);
+}  /* END OF Convert_Geodetic_To_UPS  */
 
-  if ((Latitude < -MAX_LAT) || (Latitude > MAX_LAT))
-  {   /* latitude out of range */
-    Error_Code |= UPS_LAT_ERROR;
-  }
-  if ((Latitude < 0) && (Latitude > MIN_SOUTH_LAT))
-    Error_Code |= UPS_LAT_ERROR;
-  if ((Latitude >= 0) && (Latitude < MIN_NORTH_LAT))
-    Error_Code |= UPS_LAT_ERROR;
-  if ((Longitude < -PI) || (Longitude > (2 * PI)))
-  {  /* slam out of range */
-    Error_Code |= UPS_LON_ERROR;
-  }
 
+long Convert_Geodetic_To_UPS_Ctx ( const UPS_Context *ctx,
+                                   double Latitude,
+                                   double Longitude,
+                                   char   *Hemisphere,
+                                   double *Easting,
+                                   double *Northing)
+{
+/*
+ *  The function Convert_Geodetic_To_UPS_Ctx converts geodetic (latitude and
+ *  longitude) coordinates to UPS (hemisphere, easting, and northing)
+ *  coordinates, according to the ellipsoid parameters held in ctx. If any
+ *  errors occur, the error code(s) are returned by the function,
+ *  otherwide UPS_NO_ERROR is returned.
+ *
+ *    ctx           : UPS context                               (input)
+ *    Latitude      : Latitude in radians                       (input)
+ *    Longitude     : Longitude in radians                      (input)
+ *    Hemisphere    : Hemisphere either 'N' or 'S'              (output)
+ *    Easting       : Easting/X in meters                       (output)
+ *    Northing      : Northing/Y in meters                      (output)
+ */
+
+  double tempEasting, tempNorthing;
+  long Error_Code;
+
+  Error_Code = Check_Geodetic(Latitude, Longitude);
   if (!Error_Code)
   {  /* no errors */
     if (Latitude < 0)
-    {
-      UPS_Origin_Latitude = -MAX_ORIGIN_LAT; 
       *Hemisphere = 'S';
-    }
     else
-    {
-      UPS_Origin_Latitude = MAX_ORIGIN_LAT; 
       *Hemisphere = 'N';
-    }
-
 
-    Set_Polar_Stereographic_Parameters( UPS_a,
-                                        UPS_f,
-                                        UPS_Origin_Latitude,
-                                        UPS_Origin_Longitude,
-                                        UPS_False_Easting,
-                                        UPS_False_Northing);
-
-    Convert_Geodetic_To_Polar_Stereographic(Latitude,
-                                            Longitude,
-                                            &tempEasting,
-                                            &tempNorthing);
+    Convert_Geodetic_To_Polar_Stereographic_Ctx(&ctx->Hemisphere_Parameters[Latitude < 0],
+                                                Latitude,
+                                                Longitude,
+                                                &tempEasting,
+                                                &tempNorthing);
 
     *Easting = tempEasting;
     *Northing = tempNorthing;
   }  /*  END of if(!Error_Code)   */
 
   return Error_Code;
-}  /* END OF Convert_Geodetic_To_UPS  */
+}  /* END OF Convert_Geodetic_To_UPS_Ctx  */
 
 
 long Convert_UPS_To_Geodetic(char   Hemisphere,
@@ -261,42 +421,260 @@ long Convert_UPS_To_Geodetic(char   Hemisphere,
  *    Longitude     : Longitude in radians                      (output)
  */
 
-  long Error_Code = UPS_NO_ERROR;
+  return Convert_UPS_To_Geodetic_Ctx(Default_UPS_Context(), Hemisphere, Easting,
+                                     Northing, Latitude, Longitude);
+}  /*  END OF Convert_UPS_To_Geodetic  */ 
 
-  if ((Hemisphere != 'N') && (Hemisphere != 'S'))
-    Error_Code |= UPS_HEMISPHERE_ERROR;
-  if ((Easting < MIN_EAST_NORTH) || (Easting > MAX_EAST_NORTH))
-    Error_Code |= UPS_EASTING_ERROR;
-  if ((Northing < MIN_EAST_NORTH) || (Northing > MAX_EAST_NORTH))
-    Error_Code |= UPS_NORTHING_ERROR;
 
-  if (Hemisphere =='N')
-  {UPS_Origin_Latitude = MAX_ORIGIN_LAT;}
-  if (Hemisphere =='S')
-  {UPS_Origin_Latitude = -MAX_ORIGIN_LAT;}
+long Convert_UPS_To_Geodetic_Ctx(const UPS_Context *ctx,
+                                 char   Hemisphere,
+                                 double Easting,
+                                 double Northing,
+                                 double *Latitude,
+                                 double *Longitude)
+{
+/*
+ *  The function Convert_UPS_To_Geodetic_Ctx converts UPS (hemisphere,
+ *  easting, and northing) coordinates to geodetic (latitude and longitude)
+ *  coordinates according to the ellipsoid parameters held in ctx.  If any
+ *  errors occur, the error code(s) are returned by the function, otherwise
+ *  UPS_NO_ERROR is returned.
+ *
+ *    ctx           : UPS context                               (input)
+ *    Hemisphere    : Hemisphere either 'N' or 'S'              (input)
+ *    Easting       : Easting/X in meters                       (input)
+ *    Northing      : Northing/Y in meters                      (input)
+ *    Latitude      : Latitude in radians                       (output)
+ *    Longitude     : Longitude in radians                      (output)
+ */
+
+  long Error_Code;
 
+  Error_Code = Check_UPS(Hemisphere, Easting, Northing);
   if (!Error_Code)
   {   /*  no errors   */
-    Set_Polar_Stereographic_Parameters( UPS_a,
-                                        UPS_f,
-                                        UPS_Origin_Latitude,
-                                        UPS_Origin_Longitude,
-                                        UPS_False_Easting,
-                                        UPS_False_Northing);
+    Convert_Polar_Stereographic_To_Geodetic_Ctx( &ctx->Hemisphere_Parameters[Hemisphere == 'S'],
+                                                 Easting,
+                                                 Northing,
+                                                 Latitude,
+                                                 Longitude); 
 
 
+    Error_Code = Check_UPS_Latitude(*Latitude);
+  }  /*  END OF if(!Error_Code) */
+  return (Error_Code);
+}  /*  END OF Convert_UPS_To_Geodetic_Ctx  */ 
 
-    Convert_Polar_Stereographic_To_Geodetic( Easting,
-                                             Northing,
-                                             Latitude,
-                                             Longitude); 
 
+long Convert_Geodetic_To_UPS_Batch (const double *Latitude,
+                                    const double *Longitude,
+                                    size_t Count,
+                                    char   *Hemisphere,
+                                    double *Easting,
+                                    double *Northing,
+                                    long   *Error_Codes)
+{
+/*
+ *  The function Convert_Geodetic_To_UPS_Batch converts geodetic
+ *  coordinates according to the current ellipsoid parameters.  See
+ *  Convert_Geodetic_To_UPS_Batch_Ctx.
+ */
+
+  return Convert_Geodetic_To_UPS_Batch_Ctx(Default_UPS_Context(), Latitude, Longitude, Count,
+                                           Hemisphere, Easting, Northing, Error_Codes);
+}  /* END OF Convert_Geodetic_To_UPS_Batch */
+
+
+long Convert_Geodetic_To_UPS_Batch_Ctx (const UPS_Context *ctx,
+                                        const double *Latitude,
+                                        const double *Longitude,
+                                        size_t Count,
+                                        char   *Hemisphere,
+                                        double *Easting,
+                                        double *Northing,
+                                        long   *Error_Codes)
+{
+/*
+ *  The function Convert_Geodetic_To_UPS_Batch_Ctx converts Count geodetic
+ *  (latitude and longitude) coordinates to UPS (hemisphere, easting, and
+ *  northing) coordinates, according to the ellipsoid parameters held in
+ *  ctx.  The rows of each block are split by hemisphere and each half is
+ *  projected at once by the batch Polar Stereographic kernel; each row gets
+ *  exactly what Convert_Geodetic_To_UPS_Ctx returns for it.  The number of
+ *  rows with errors is returned by the function.
+ *
+ *    ctx           : UPS context                               (input)
+ *    Latitude      : Latitudes in radians                      (input)
+ *    Longitude     : Longitudes in radians                     (input)
+ *    Count         : Number of coordinates                     (input)
+ *    Hemisphere    : Hemispheres, either 'N' or 'S'            (output)
+ *    Easting       : Eastings/X in meters                      (output)
+ *    Northing      : Northings/Y in meters                     (output)
+ *    Error_Codes   : Error code of each row, or NULL           (output)
+ */
+
+  long   code[BATCH_BLOCK];
+  size_t row[BATCH_BLOCK];      /* Northern rows first, then southern */
+  double lat[BATCH_BLOCK];
+  double lon[BATCH_BLOCK];
+  double east[BATCH_BLOCK];
+  double north[BATCH_BLOCK];
+  size_t start;
+  size_t n;
+  size_t i;
+  size_t k;
+  size_t south;
+  size_t m;
+  long   Error_Count = 0;
+
+  for (start = 0; start < Count; start += n)
+  {
+    n = Count - start;
+    if (n > BATCH_BLOCK)
+      n = BATCH_BLOCK;
+    for (i = 0; i < n; i++)
+      code[i] = Check_Geodetic(Latitude[start + i], Longitude[start + i]);
+    m = 0;
+    for (south = 0; south < 2; south++)
+    {
+      for (i = 0; i < n; i++)
+      {
+        if (!code[i] && ((size_t)(Latitude[start + i] < 0) == south))
+        {
+          row[m] = i;
+          lat[m] = Latitude[start + i];
+          lon[m] = Longitude[start + i];
+          m++;
+        }
+      }
+      if (!south)
+        k = m;
+    }
+    /* rows within UPS coverage are always within the projection */
+    Convert_Geodetic_To_Polar_Stereographic_Batch_Ctx(&ctx->Hemisphere_Parameters[0], lat, lon, k,
+                                                      east, north, NULL);
+    Convert_Geodetic_To_Polar_Stereographic_Batch_Ctx(&ctx->Hemisphere_Parameters[1], &lat[k], &lon[k],
+                                                      m - k, &east[k], &north[k], NULL);
+    for (k = 0; k < m; k++)
+    {
+      Hemisphere[start + row[k]] = (lat[k] < 0) ? 'S' : 'N';
+      Easting[start + row[k]] = east[k];
+      Northing[start + row[k]] = north[k];
+    }
+    for (i = 0; i < n; i++)
+    {
+      if (code[i])
+        Error_Count++;
+      if (Error_Codes)
+        Error_Codes[start + i] = code[i];
+    }
+  }
+  return (Error_Count);
+}  /* END OF Convert_Geodetic_To_UPS_Batch_Ctx */
+
+
+long Convert_UPS_To_Geodetic_Batch (const char   *Hemisphere,
+                                    const double *Easting,
+                                    const double *Northing,
+                                    size_t Count,
+                                    double *Latitude,
+                                    double *Longitude,
+                                    long   *Error_Codes)
+{
+/*
+ *  The function Convert_UPS_To_Geodetic_Batch converts UPS coordinates
+ *  according to the current ellipsoid parameters.  See
+ *  Convert_UPS_To_Geodetic_Batch_Ctx.
+ */
+
+  return Convert_UPS_To_Geodetic_Batch_Ctx(Default_UPS_Context(), Hemisphere, Easting, Northing,
+                                           Count, Latitude, Longitude, Error_Codes);
+}  /* END OF Convert_UPS_To_Geodetic_Batch */
 
-    if ((*Latitude < 0) && (*Latitude > MIN_SOUTH_LAT))
-      Error_Code |= UPS_LAT_ERROR;
-    if ((*Latitude >= 0) && (*Latitude < MIN_NORTH_LAT))
-      Error_Code |= UPS_LAT_ERROR;
-  }  /*  END OF if(!Error_Code) */
-  return (Error_Code);
-}  /*  END OF Convert_UPS_To_Geodetic  */ 
 
+long Convert_UPS_To_Geodetic_Batch_Ctx (const UPS_Context *ctx,
+                                        const char   *Hemisphere,
+                                        const double *Easting,
+                                        const double *Northing,
+                                        size_t Count,
+                                        double *Latitude,
+                                        double *Longitude,
+                                        long   *Error_Codes)
+{
+/*
+ *  The function Convert_UPS_To_Geodetic_Batch_Ctx converts Count UPS
+ *  (hemisphere, easting, and northing) coordinates to geodetic (latitude
+ *  and longitude) coordinates according to the ellipsoid parameters held
+ *  in ctx.  The rows of each block are split by hemisphere and each half is
+ *  unprojected at once by the batch Polar Stereographic kernel; each row
+ *  gets exactly what Convert_UPS_To_Geodetic_Ctx returns for it.  The
+ *  number of rows with errors is returned by the function.
+ *
+ *    ctx           : UPS context                               (input)
+ *    Hemisphere    : Hemispheres, either 'N' or 'S'            (input)
+ *    Easting       : Eastings/X in meters                      (input)
+ *    Northing      : Northings/Y in meters                     (input)
+ *    Count         : Number of coordinates                     (input)
+ *    Latitude      : Latitudes in radians                      (output)
+ *    Longitude     : Longitudes in radians                     (output)
+ *    Error_Codes   : Error code of each row, or NULL           (output)
+ */
+
+  long   code[BATCH_BLOCK];
+  size_t row[BATCH_BLOCK];      /* Northern rows first, then southern */
+  double east[BATCH_BLOCK];
+  double north[BATCH_BLOCK];
+  double lat[BATCH_BLOCK];
+  double lon[BATCH_BLOCK];
+  size_t start;
+  size_t n;
+  size_t i;
+  size_t k;
+  size_t south;
+  size_t m;
+  long   Error_Count = 0;
+
+  for (start = 0; start < Count; start += n)
+  {
+    n = Count - start;
+    if (n > BATCH_BLOCK)
+      n = BATCH_BLOCK;
+    for (i = 0; i < n; i++)
+      code[i] = Check_UPS(Hemisphere[start + i], Easting[start + i], Northing[start + i]);
+    m = 0;
+    for (south = 0; south < 2; south++)
+    {
+      for (i = 0; i < n; i++)
+      {
+        if (!code[i] && ((size_t)(Hemisphere[start + i] == 'S') == south))
+        {
+          row[m] = i;
+          east[m] = Easting[start + i];
+          north[m] = Northing[start + i];
+          m++;
+        }
+      }
+      if (!south)
+        k = m;
+    }
+    /* UPS eastings and northings are always within the projection */
+    Convert_Polar_Stereographic_To_Geodetic_Batch_Ctx(&ctx->Hemisphere_Parameters[0], east, north, k,
+                                                      lat, lon, NULL);
+    Convert_Polar_Stereographic_To_Geodetic_Batch_Ctx(&ctx->Hemisphere_Parameters[1], &east[k], &north[k],
+                                                      m - k, &lat[k], &lon[k], NULL);
+    for (k = 0; k < m; k++)
+    {
+      Latitude[start + row[k]] = lat[k];
+      Longitude[start + row[k]] = lon[k];
+      code[row[k]] = Check_UPS_Latitude(lat[k]);
+    }
+    for (i = 0; i < n; i++)
+    {
+      if (code[i])
+        Error_Count++;
+      if (Error_Codes)
+        Error_Codes[start + i] = code[i];
+    }
+  }
+  return (Error_Count);
+}  /* END OF Convert_UPS_To_Geodetic_Batch_Ctx */
@@ -1,5 +1,7 @@
 #ifndef UPS_H
   #define UPS_H
+
+#include "polarst.h"
 /********************************************************************/
 /* RSC IDENTIFIER: UPS
  *
@@ -95,6 +97,28 @@
   #define UPS_INV_F_ERROR             0x0040
 
 
+/**********************************************************************/
+/*
+ *                        TYPES
+ */
+
+/*
+ * A UPS_Context holds the ellipsoid state that the non-reentrant
+ * functions below keep in file-scope variables, along with the polar
+ * stereographic parameters of both hemispheres for that ellipsoid.  A
+ * context must be set with Set_UPS_Parameters_Ctx before use.
+ */
+
+  typedef struct UPS_Context_Value
+  {
+    double a;                   /* Semi-major axis of ellipsoid in meters   */
+    double f;                   /* Flattening of ellipsoid                  */
+    Polar_Stereographic_Context Hemisphere_Parameters[2];
+                                /* Polar stereographic parameters by        */
+                                /* hemisphere (0 = 'N', 1 = 'S')            */
+  } UPS_Context;
+
+
 /**********************************************************************/
 /*
  *                        FUNCTION PROTOTYPES
@@ -166,6 +190,142 @@ extern "C" {
  *    Northing      : Northing/Y in meters                      (input)
  *    Latitude      : Latitude in radians                       (output)
  *    Longitude     : Longitude in radians                      (output)
+ */
+
+  long Set_UPS_Parameters_Ctx( UPS_Context *ctx,
+                               double a,
+                               double f);
+/*
+ * The function Set_UPS_Parameters_Ctx is the reentrant form of
+ * Set_UPS_Parameters.  It sets the state variables held in the context ctx
+ * and computes the polar stereographic parameters of both hemispheres.
+ *
+ *   ctx   : UPS context                            (output)
+ */
+
+
+  void Get_UPS_Parameters_Ctx( const UPS_Context *ctx,
+                               double *a,
+                               double *f);
+/*
+ * The function Get_UPS_Parameters_Ctx returns the ellipsoid parameters held
+ * in the context ctx.
+ *
+ *  ctx    : UPS context                             (input)
+ */
+
+
+  long Convert_Geodetic_To_UPS_Ctx ( const UPS_Context *ctx,
+                                     double Latitude,
+                                     double Longitude,
+                                     char   *Hemisphere,
+                                     double *Easting,
+                                     double *Northing);
+/*
+ *  The function Convert_Geodetic_To_UPS_Ctx is the reentrant form of
+ *  Convert_Geodetic_To_UPS.  It uses the ellipsoid parameters held in the
+ *  context ctx.
+ *
+ *    ctx           : UPS context                               (input)
+ */
+
+
+  long Convert_UPS_To_Geodetic_Ctx(const UPS_Context *ctx,
+                                   char   Hemisphere,
+                                   double Easting,
+                                   double Northing,
+                                   double *Latitude,
+                                   double *Longitude);
+/*
+ *  The function Convert_UPS_To_Geodetic_Ctx is the reentrant form of
+ *  Convert_UPS_To_Geodetic.  It uses the ellipsoid parameters held in the
+ *  context ctx.
+ *
+ *    ctx           : UPS context                               (input)
+ */
+
+
+  long Convert_Geodetic_To_UPS_Batch (const double *Latitude,
+                                      const double *Longitude,
+                                      size_t Count,
+                                      char   *Hemisphere,
+                                      double *Easting,
+                                      double *Northing,
+                                      long   *Error_Codes);
+/*
+ *  The function Convert_Geodetic_To_UPS_Batch converts Count geodetic
+ *  coordinates to UPS coordinates according to the current ellipsoid
+ *  parameters, projecting the rows of each hemisphere with the vectorized
+ *  Polar Stereographic kernel.  Each row gets the result and error code
+ *  that Convert_Geodetic_To_UPS returns for it; rows with errors are left
+ *  unchanged.  The number of rows with errors is returned by the function.
+ *
+ *    Latitude      : Latitudes in radians                      (input)
+ *    Longitude     : Longitudes in radians                     (input)
+ *    Count         : Number of coordinates                     (input)
+ *    Hemisphere    : Hemispheres, either 'N' or 'S'            (output)
+ *    Easting       : Eastings/X in meters                      (output)
+ *    Northing      : Northings/Y in meters                     (output)
+ *    Error_Codes   : Error code of each row, or NULL           (output)
+ */
+
+
+  long Convert_Geodetic_To_UPS_Batch_Ctx (const UPS_Context *ctx,
+                                          const double *Latitude,
+                                          const double *Longitude,
+                                          size_t Count,
+                                          char   *Hemisphere,
+                                          double *Easting,
+                                          double *Northing,
+                                          long   *Error_Codes);
+/*
+ *  The function Convert_Geodetic_To_UPS_Batch_Ctx is the reentrant form of
+ *  Convert_Geodetic_To_UPS_Batch.  It uses the ellipsoid parameters held in
+ *  the context ctx.
+ *
+ *    ctx           : UPS context                               (input)
+ */
+
+
+  long Convert_UPS_To_Geodetic_Batch (const char   *Hemisphere,
+                                      const double *Easting,
+                                      const double *Northing,
+                                      size_t Count,
+                                      double *Latitude,
+                                      double *Longitude,
+                                      long   *Error_Codes);
+/*
+ *  The function Convert_UPS_To_Geodetic_Batch converts Count UPS
+ *  coordinates to geodetic coordinates according to the current ellipsoid
+ *  parameters, unprojecting the rows of each hemisphere with the vectorized
+ *  Polar Stereographic kernel.  Each row gets the result and error code
+ *  that Convert_UPS_To_Geodetic returns for it.  The number of rows with
+ *  errors is returned by the function.
+ *
+ *    Hemisphere    : Hemispheres, either 'N' or 'S'            (input)
+ *    Easting       : Eastings/X in meters                      (input)
+ *    Northing      : Northings/Y in meters                     (input)
+ *    Count         : Number of coordinates                     (input)
+ *    Latitude      : Latitudes in radians                      (output)
+ *    Longitude     : Longitudes in radians                     (output)
+ *    Error_Codes   : Error code of each row, or NULL           (output)
+ */
+
+
+  long Convert_UPS_To_Geodetic_Batch_Ctx (const UPS_Context *ctx,
+                                          const char   *Hemisphere,
+                                          const double *Easting,
+                                          const double *Northing,
+                                          size_t Count,
+                                          double *Latitude,
+                                          double *Longitude,
+                                          long   *Error_Codes);
+/*
+ *  The function Convert_UPS_To_Geodetic_Batch_Ctx is the reentrant form of
+ *  Convert_UPS_To_Geodetic_Batch.  It uses the ellipsoid parameters held in
+ *  the context ctx.
+ *
+ *    ctx           : UPS context                               (input)
  */
 
   #ifdef __cplusplus
@@ -86,15 +86,203 @@
  *                              DEFINES
  */
 
+#define BATCH_BLOCK  256  /* Rows converted at a time by the batch functions */
+
+/* Transverse Mercator errors with which no latitude is returned */
+#define TM_REJECTED  (TRANMERC_EASTING_ERROR | TRANMERC_NORTHING_ERROR)
+
 
 /***************************************************************************/
 /*
  *                              GLOBAL DECLARATIONS
  */
 
-static double UTM_a = 6378137.0;         /* Semi-major axis of ellipsoid in meters  */
-static double UTM_f = 1 / 298.257223563; /* Flattening of ellipsoid                 */
-static long   UTM_Override = 0;          /* Zone override flag                      */
+/* State used by the non-reentrant functions, default to WGS 84 */
+static UTM_Context UTM_Default_Context =
+  {
+    6378137.0,         /* Semi-major axis of ellipsoid in meters  */
+    1 / 298.257223563, /* Flattening of ellipsoid                 */
+    0,                 /* Zone override flag                      */
+    TRANMERC_THOMAS,   /* Series engine of every zone             */
+    .Zone_Parameters = {{{0}}}
+  };
+/* Zone parameters of UTM_Default_Context are built on first use */
+static long UTM_Default_Context_Set = 0;
+
+
+/***************************************************************************/
+/*
+ *                              LOCAL FUNCTIONS
+ */
+
+static UTM_Context *Default_UTM_Context (void)
+{
+/*
+ * The function Default_UTM_Context returns the context used by the
+ * non-reentrant functions, computing its zone parameters on first use.
+ */
+
+  if (!UTM_Default_Context_Set)
+  {
+    Set_UTM_Parameters_Ctx(&UTM_Default_Context, UTM_Default_Context.a,
+                           UTM_Default_Context.f, UTM_Default_Context.Override);
+    UTM_Default_Context_Set = 1;
+  }
+  return (&UTM_Default_Context);
+} /* END OF Default_UTM_Context */
+
+
+static long UTM_Zone (long   Override,
+                      double *Latitude,
+                      double *Longitude,
+                      long   *Zone)
+{
+/*
+ * The function UTM_Zone checks a geodetic coordinate and selects its UTM
+ * zone, applying the zone override Override.  The latitude and longitude
+ * are adjusted in place to the values the projection is evaluated at.  If
+ * any errors occur, the error code(s) are returned by the function,
+ * otherwise UTM_NO_ERROR is returned.
+ *
+ *    Override          : UTM override zone, zero indicates no override (input)
+ *    Latitude          : Latitude in radians                           (input/output)
+ *    Longitude         : Longitude in radians                          (input/output)
+ *    Zone              : UTM zone                                      (output)
+ */
+
+  long Lat_Degrees;
+  long Long_Degrees;
+  long temp_zone;
+  long Error_Code = UTM_NO_ERROR;
+
+  /* missing values (NaN) fail no comparison, so check them as well */
+  if ((*Latitude < MIN_LAT) || (*Latitude > MAX_LAT) || (*Latitude != *Latitude))
+  { /* Latitude out of range */
+    Error_Code |= UTM_LAT_ERROR;
+  }
+  if ((*Longitude < -PI) || (*Longitude > (2*PI)) || (*Longitude != *Longitude))
+  { /* Longitude out of range */
+    Error_Code |= UTM_LON_ERROR;
+  }
+  if ((Override < 0) || (Override > UTM_ZONES))
+  { /* Zone override out of range */
+    Error_Code |= UTM_ZONE_OVERRIDE_ERROR;
+  }
+  if (!Error_Code)
+  { /* no errors */
+    if((*Latitude > -1.0e-9) && (*Latitude < 0))
+      *Latitude = 0.0;
+    if (*Longitude < 0)
+      *Longitude += (2*PI) + 1.0e-10;
+
+    Lat_Degrees = (long)(*Latitude * 180.0 / PI);
+    Long_Degrees = (long)(*Longitude * 180.0 / PI);
+
+    if (*Longitude < PI)
+      temp_zone = (long)(31 + ((*Longitude * 180.0 / PI) / 6.0));
+    else
+      temp_zone = (long)(((*Longitude * 180.0 / PI) / 6.0) - 29);
+
+    if (temp_zone > 60)
+      temp_zone = 1;
+    /* UTM special cases */
+    if ((Lat_Degrees > 55) && (Lat_Degrees < 64) && (Long_Degrees > -1)
+        && (Long_Degrees < 3))
+      temp_zone = 31;
+    if ((Lat_Degrees > 55) && (Lat_Degrees < 64) && (Long_Degrees > 2)
+        && (Long_Degrees < 12))
+      temp_zone = 32;
+    if ((Lat_Degrees > 71) && (Long_Degrees > -1) && (Long_Degrees < 9))
+      temp_zone = 31;
+    if ((Lat_Degrees > 71) && (Long_Degrees > 8) && (Long_Degrees < 21))
+      temp_zone = 33;
+    if ((Lat_Degrees > 71) && (Long_Degrees > 20) && (Long_Degrees < 33))
+      temp_zone = 35;
+    if ((Lat_Degrees > 71) && (Long_Degrees > 32) && (Long_Degrees < 42))
+      temp_zone = 37;
+
+    if (Override)
+    {
+      if ((temp_zone == 1) && (Override == 60))
+        temp_zone = Override;
+      else if ((temp_zone == 60) && (Override == 1))
+        temp_zone = Override;
+      else if ((Lat_Degrees > 71) && (Long_Degrees > -1) && (Long_Degrees < 42))
+      {
+        if (((temp_zone-2) <= Override) && (Override <= (temp_zone+2)))
+          temp_zone = Override;
+        else
+          Error_Code = UTM_ZONE_OVERRIDE_ERROR;
+      }
+      else if (((temp_zone-1) <= Override) && (Override <= (temp_zone+1)))
+        temp_zone = Override;
+      else
+        Error_Code = UTM_ZONE_OVERRIDE_ERROR;
+    }
+    *Zone = temp_zone;
+  } /* END OF if (!Error_Code) */
+  return (Error_Code);
+} /* END OF UTM_Zone */
+
+
+static long Check_UTM (long   Zone,
+                       char   Hemisphere,
+                       double Easting,
+                       double Northing)
+{
+/*
+ * The function Check_UTM checks the range of UTM projection coordinates.
+ * If any errors occur, the error code(s) are returned by the function,
+ * otherwise UTM_NO_ERROR is returned.
+ *
+ *    Zone              : UTM zone                               (input)
+ *    Hemisphere        : North or South hemisphere              (input)
+ *    Easting           : Easting (X) in meters                  (input)
+ *    Northing          : Northing (Y) in meters                 (input)
+ */
+
+  long Error_Code = UTM_NO_ERROR;
+
+  if ((Zone < 1) || (Zone > 60))
+    Error_Code |= UTM_ZONE_ERROR;
+  if ((Hemisphere != 'S') && (Hemisphere != 'N'))
+    Error_Code |= UTM_HEMISPHERE_ERROR;
+  if ((Easting < MIN_EASTING) || (Easting > MAX_EASTING) || (Easting != Easting))
+    Error_Code |= UTM_EASTING_ERROR;
+  if ((Northing < MIN_NORTHING) || (Northing > MAX_NORTHING) || (Northing != Northing))
+    Error_Code |= UTM_NORTHING_ERROR;
+  return (Error_Code);
+} /* END OF Check_UTM */
+
+
+static long Check_UTM_Geodetic (long   TM_Error,
+                                double Latitude)
+{
+/*
+ * The function Check_UTM_Geodetic returns the UTM error code(s) of an
+ * inverse projection, from its Transverse Mercator error code(s) and the
+ * latitude it found, otherwise UTM_NO_ERROR.
+ *
+ *    TM_Error          : Transverse Mercator error code(s)      (input)
+ *    Latitude          : Latitude in radians                    (input)
+ */
+
+  long Error_Code = UTM_NO_ERROR;
+
+  if(TM_Error)
+  {
+    if(TM_Error & TRANMERC_EASTING_ERROR)
+      Error_Code |= UTM_EASTING_ERROR;
+    if(TM_Error & TRANMERC_NORTHING_ERROR)
+      Error_Code |= UTM_NORTHING_ERROR;
+  }
+
+  if ((Latitude < MIN_LAT) || (Latitude > MAX_LAT))
+  { /* Latitude out of range */
+    Error_Code |= UTM_NORTHING_ERROR;
+  }
+  return (Error_Code);
+} /* END OF Check_UTM_Geodetic */
 
 
 /***************************************************************************/
@@ -116,9 +304,43 @@ long Set_UTM_Parameters(double a,
  *    a                 : Semi-major axis of ellipsoid, in meters       (input)
  *    f                 : Flattening of ellipsoid						            (input)
  *    override          : UTM override zone, zero indicates no override (input)
+ */
+
+  long Error_Code = UTM_NO_ERROR;
+
+  if (UTM_Default_Context_Set && (a == UTM_Default_Context.a)
+      && (f == UTM_Default_Context.f) && (override >= 0) && (override <= 60))
+  { /* same ellipsoid, the zone parameters are still current */
+    UTM_Default_Context.Override = override;
+    return (UTM_NO_ERROR);
+  }
+  Error_Code = Set_UTM_Parameters_Ctx(&UTM_Default_Context, a, f, override);
+  if (!Error_Code)
+    UTM_Default_Context_Set = 1;
+  return (Error_Code);
+} /* END OF Set_UTM_Parameters */
+
+
+long Set_UTM_Parameters_Ctx(UTM_Context *ctx,
+                            double a,
+                            double f,
+                            long   override)
+{
+/*
+ * The function Set_UTM_Parameters_Ctx receives the ellipsoid parameters and
+ * UTM zone override parameter as inputs, and sets the corresponding state
+ * variables in ctx.  If any errors occur, the error code(s) are returned by
+ * the function, otherwise UTM_NO_ERROR is returned.
+ *
+ *    ctx               : UTM context                                   (output)
+ *    a                 : Semi-major axis of ellipsoid, in meters       (input)
+ *    f                 : Flattening of ellipsoid                       (input)
+ *    override          : UTM override zone, zero indicates no override (input)
  */
 
   double inv_f = 1 / f;
+  double Central_Meridian;
+  long zone;
   long Error_Code = UTM_NO_ERROR;
 
   if (a <= 0.0)
@@ -135,12 +357,28 @@ long Set_UTM_Parameters(double a,
   }
   if (!Error_Code)
   { /* no errors */
-    UTM_a = a;
-    UTM_f = f;
-    UTM_Override = override;
+    ctx->a = a;
+    ctx->f = f;
+    ctx->Override = override;
+    for (zone = 1; zone <= UTM_ZONES; zone++)
+    {
+      if (zone >= 31)
+        Central_Meridian = (6 * zone - 183) * PI / 180.0;
+      else
+        Central_Meridian = (6 * zone + 177) * PI / 180.0;
+      Set_Transverse_Mercator_Parameters_Ctx(&ctx->Zone_Parameters[zone - 1][0], a, f, 0,
+                                             Central_Meridian, 500000, 0, 0.9996);
+      Set_Transverse_Mercator_Parameters_Ctx(&ctx->Zone_Parameters[zone - 1][1], a, f, 0,
+                                             Central_Meridian, 500000, 10000000, 0.9996);
+    }
+    /* The zones are rebuilt with TRANMERC_THOMAS; keep the engine of ctx */
+    if (ctx->Engine == TRANMERC_KRUGER)
+      Set_UTM_Engine_Ctx(ctx, TRANMERC_KRUGER);
+    else
+      ctx->Engine = TRANMERC_THOMAS;
   }
   return (Error_Code);
-} /* END OF Set_UTM_Parameters */
+} /* END OF Set_UTM_Parameters_Ctx */
 
 
 void Get_UTM_Parameters(double *a,
@@ -156,12 +394,71 @@ void Get_UTM_Parameters(double *a,
  *    override          : UTM override zone, zero indicates no override (output)
  */
 
-  *a = UTM_a;
-  *f = UTM_f;
-  *override = UTM_Override;
+  Get_UTM_Parameters_Ctx(&UTM_Default_Context, a, f, override);
 } /* END OF Get_UTM_Parameters */
 
 
+void Get_UTM_Parameters_Ctx(const UTM_Context *ctx,
+                            double *a,
+                            double *f,
+                            long   *override)
+{
+/*
+ * The function Get_UTM_Parameters_Ctx returns the ellipsoid parameters and
+ * UTM zone override parameter held in ctx.
+ *
+ *    ctx               : UTM context                                   (input)
+ *    a                 : Semi-major axis of ellipsoid, in meters       (output)
+ *    f                 : Flattening of ellipsoid                       (output)
+ *    override          : UTM override zone, zero indicates no override (output)
+ */
+
+  *a = ctx->a;
+  *f = ctx->f;
+  *override = ctx->Override;
+} /* END OF Get_UTM_Parameters_Ctx */
+
+
+long Set_UTM_Engine(long Engine)
+{
+/*
+ * The function Set_UTM_Engine selects the Transverse Mercator series
+ * engine of the current state.  See Set_UTM_Engine_Ctx.
+ *
+ *    Engine            : TRANMERC_THOMAS or TRANMERC_KRUGER            (input)
+ */
+
+  return Set_UTM_Engine_Ctx(Default_UTM_Context(), Engine);
+} /* END OF Set_UTM_Engine */
+
+
+long Set_UTM_Engine_Ctx(UTM_Context *ctx,
+                        long Engine)
+{
+/*
+ * The function Set_UTM_Engine_Ctx selects the Transverse Mercator series
+ * engine, TRANMERC_THOMAS or TRANMERC_KRUGER, of every zone held in ctx.
+ * If Engine is invalid UTM_ENGINE_ERROR is returned, otherwise
+ * UTM_NO_ERROR.
+ *
+ *    ctx               : UTM context                                   (input/output)
+ *    Engine            : TRANMERC_THOMAS or TRANMERC_KRUGER            (input)
+ */
+
+  long zone;
+
+  if ((Engine != TRANMERC_THOMAS) && (Engine != TRANMERC_KRUGER))
+    return (UTM_ENGINE_ERROR);
+  ctx->Engine = Engine;
+  for (zone = 0; zone < UTM_ZONES; zone++)
+  {
+    Set_Transverse_Mercator_Engine_Ctx(&ctx->Zone_Parameters[zone][0], Engine);
+    Set_Transverse_Mercator_Engine_Ctx(&ctx->Zone_Parameters[zone][1], Engine);
+  }
+  return (UTM_NO_ERROR);
+} /* END OF Set_UTM_Engine_Ctx */
+
+
 long Convert_Geodetic_To_UTM (double Latitude,
                               double Longitude,
                               long   *Zone,
@@ -184,101 +481,320 @@ long Convert_Geodetic_To_UTM (double Latitude,
  *    Northing          : Northing (Y) in meters              (output)
  */
 
-  long Lat_Degrees;
-  long Long_Degrees;
+  return Convert_Geodetic_To_UTM_Ctx(Default_UTM_Context(), Latitude, Longitude,
+                                     Zone, Hemisphere, Easting, Northing);
+} /* END OF Convert_Geodetic_To_UTM */
+
+
+long Convert_Geodetic_To_UTM_Override (long   Override,
+                                       double Latitude,
+                                       double Longitude,
+                                       long   *Zone,
+                                       char   *Hemisphere,
+                                       double *Easting,
+                                       double *Northing)
+{
+/*
+ * The function Convert_Geodetic_To_UTM_Override converts geodetic (latitude
+ * and longitude) coordinates to UTM projection (zone, hemisphere, easting
+ * and northing) coordinates according to the current ellipsoid parameters
+ * and the UTM zone override Override.  If any errors occur, the error
+ * code(s) are returned by the function, otherwise UTM_NO_ERROR is returned.
+ *
+ *    Override          : UTM override zone, zero indicates no override (input)
+ *    Latitude          : Latitude in radians                           (input)
+ *    Longitude         : Longitude in radians                          (input)
+ *    Zone              : UTM zone                                      (output)
+ *    Hemisphere        : North or South hemisphere                     (output)
+ *    Easting           : Easting (X) in meters                         (output)
+ *    Northing          : Northing (Y) in meters                        (output)
+ */
+
+  return Convert_Geodetic_To_UTM_Override_Ctx(Default_UTM_Context(), Override, Latitude,
+                                              Longitude, Zone, Hemisphere, Easting, Northing);
+} /* END OF Convert_Geodetic_To_UTM_Override */
+
+
+long Convert_Geodetic_To_UTM_Ctx (const UTM_Context *ctx,
+                                  double Latitude,
+                                  double Longitude,
+                                  long   *Zone,
+                                  char   *Hemisphere,
+                                  double *Easting,
+                                  double *Northing)
+{
+/*
+ * The function Convert_Geodetic_To_UTM_Ctx converts geodetic (latitude and
+ * longitude) coordinates to UTM projection (zone, hemisphere, easting and
+ * northing) coordinates according to the ellipsoid and UTM zone override
+ * parameters held in ctx.  If any errors occur, the error code(s) are
+ * returned by the function, otherwise UTM_NO_ERROR is returned.
+ *
+ *    ctx               : UTM context                         (input)
+ *    Latitude          : Latitude in radians                 (input)
+ *    Longitude         : Longitude in radians                (input)
+ *    Zone              : UTM zone                            (output)
+ *    Hemisphere        : North or South hemisphere           (output)
+ *    Easting           : Easting (X) in meters               (output)
+ *    Northing          : Northing (Y) in meters              (output)
+ */
+
+  return Convert_Geodetic_To_UTM_Override_Ctx(ctx, ctx->Override, Latitude, Longitude,
+                                              Zone, Hemisphere, Easting, Northing);
+} /* END OF Convert_Geodetic_To_UTM_Ctx */
+
+
+long Convert_Geodetic_To_UTM_Override_Ctx (const UTM_Context *ctx,
+                                           long   Override,
+                                           double Latitude,
+                                           double Longitude,
+                                           long   *Zone,
+                                           char   *Hemisphere,
+                                           double *Easting,
+                                           double *Northing)
+{
+/*
+ * The function Convert_Geodetic_To_UTM_Override_Ctx converts geodetic
+ * (latitude and longitude) coordinates to UTM projection (zone, hemisphere,
+ * easting and northing) coordinates according to the ellipsoid held in ctx
+ * and the UTM zone override Override.  If any errors occur, the error
+ * code(s) are returned by the function, otherwise UTM_NO_ERROR is returned.
+ *
+ *    ctx               : UTM context                                   (input)
+ *    Override          : UTM override zone, zero indicates no override (input)
+ *    Latitude          : Latitude in radians                           (input)
+ *    Longitude         : Longitude in radians                          (input)
+ *    Zone              : UTM zone                                      (output)
+ *    Hemisphere        : North or South hemisphere                     (output)
+ *    Easting           : Easting (X) in meters                         (output)
+ *    Northing          : Northing (Y) in meters                        (output)
+ */
+
   long temp_zone;
-  long Error_Code = UTM_NO_ERROR;
-  double Origin_Latitude = 0;
-  double Central_Meridian = 0;
-  double False_Easting = 500000;
-  double False_Northing = 0;
-  double Scale = 0.9996;
+  long Error_Code;
 
-  if ((Latitude < MIN_LAT) || (Latitude > MAX_LAT))
-  { /* Latitude out of range */
-    Error_Code |= UTM_LAT_ERROR;
-  }
-  if ((Longitude < -PI) || (Longitude > (2*PI)))
-  { /* Longitude out of range */
-    Error_Code |= UTM_LON_ERROR;
-  }
+  Error_Code = UTM_Zone(Override, &Latitude, &Longitude, &temp_zone);
   if (!Error_Code)
-  { /* no errors */
-    if((Latitude > -1.0e-9) && (Latitude < 0))
-      Latitude = 0.0;
-    if (Longitude < 0)
-      Longitude += (2*PI) + 1.0e-10;
+  {
+    *Zone = temp_zone;
+    if (Latitude < 0)
+      *Hemisphere = 'S';
+    else
+      *Hemisphere = 'N';
+    Convert_Geodetic_To_Transverse_Mercator_Ctx(&ctx->Zone_Parameters[temp_zone - 1][Latitude < 0],
+                                                Latitude, Longitude, Easting, Northing);
+    if ((*Easting < MIN_EASTING) || (*Easting > MAX_EASTING))
+      Error_Code = UTM_EASTING_ERROR;
+    if ((*Northing < MIN_NORTHING) || (*Northing > MAX_NORTHING))
+      Error_Code |= UTM_NORTHING_ERROR;
+  }
+  return (Error_Code);
+} /* END OF Convert_Geodetic_To_UTM_Override_Ctx */
 
-    Lat_Degrees = (long)(Latitude * 180.0 / PI);
-    Long_Degrees = (long)(Longitude * 180.0 / PI);
 
-    if (Longitude < PI)
-      temp_zone = (long)(31 + ((Longitude * 180.0 / PI) / 6.0));
-    else
-      temp_zone = (long)(((Longitude * 180.0 / PI) / 6.0) - 29);
+long Convert_Geodetic_To_UTM_Batch (const double *Latitude,
+                                    const double *Longitude,
+                                    size_t Count,
+                                    long   *Zone,
+                                    char   *Hemisphere,
+                                    double *Easting,
+                                    double *Northing,
+                                    long   *Error_Codes)
+{
+/*
+ * The function Convert_Geodetic_To_UTM_Batch converts Count geodetic
+ * coordinates to UTM projection coordinates according to the current
+ * ellipsoid and UTM zone override parameters.  See
+ * Convert_Geodetic_To_UTM_Batch_Ctx.
+ */
 
-    if (temp_zone > 60)
-      temp_zone = 1;
-    /* UTM special cases */
-    if ((Lat_Degrees > 55) && (Lat_Degrees < 64) && (Long_Degrees > -1)
-        && (Long_Degrees < 3))
-      temp_zone = 31;
-    if ((Lat_Degrees > 55) && (Lat_Degrees < 64) && (Long_Degrees > 2)
-        && (Long_Degrees < 12))
-      temp_zone = 32;
-    if ((Lat_Degrees > 71) && (Long_Degrees > -1) && (Long_Degrees < 9))
-      temp_zone = 31;
-    if ((Lat_Degrees > 71) && (Long_Degrees > 8) && (Long_Degrees < 21))
-      temp_zone = 33;
-    if ((Lat_Degrees > 71) && (Long_Degrees > 20) && (Long_Degrees < 33))
-      temp_zone = 35;
-    if ((Lat_Degrees > 71) && (Long_Degrees > 32) && (Long_Degrees < 42))
-      temp_zone = 37;
+  return Convert_Geodetic_To_UTM_Batch_Ctx(Default_UTM_Context(), Latitude, Longitude, Count,
+                                           Zone, Hemisphere, Easting, Northing, Error_Codes);
+} /* END OF Convert_Geodetic_To_UTM_Batch */
+
+
+static long Geodetic_To_UTM_Rows (const UTM_Context *ctx,
+                                  const double *Latitude,
+                                  const double *Longitude,
+                                  size_t Count,
+                                  long   *Zone,
+                                  char   *Hemisphere,
+                                  double *Easting,
+                                  double *Northing,
+                                  long   *Error_Codes,
+                                  int    Fast)
+{
+/*
+ * The function Geodetic_To_UTM_Rows converts Count geodetic coordinates to
+ * UTM block by block, projecting each run of rows that share a zone and
+ * hemisphere with the fast Transverse Mercator kernel if Fast is set and
+ * with the double precision one otherwise.  The number of rows with errors
+ * is returned by the function.
+ *
+ *    ctx               : UTM context                           (input)
+ *    Latitude          : Latitudes in radians                  (input)
+ *    Longitude         : Longitudes in radians                 (input)
+ *    Count             : Number of coordinates                 (input)
+ *    Zone              : UTM zones                             (output)
+ *    Hemisphere        : North or South hemispheres            (output)
+ *    Easting           : Eastings (X) in meters                (output)
+ *    Northing          : Northings (Y) in meters               (output)
+ *    Error_Codes       : Error code of each row, or NULL       (output)
+ *    Fast              : Nonzero for the fast kernel           (input)
+ */
+
+  double lat[BATCH_BLOCK];
+  double lon[BATCH_BLOCK];
+  double east[BATCH_BLOCK];
+  double north[BATCH_BLOCK];
+  long   zone[BATCH_BLOCK];
+  long   code[BATCH_BLOCK];
+  size_t start;
+  size_t n;
+  size_t i;
+  size_t j;
+  int    south;
+  long   Error_Count = 0;
 
-    if (UTM_Override)
+  for (start = 0; start < Count; start += n)
+  {
+    n = Count - start;
+    if (n > BATCH_BLOCK)
+      n = BATCH_BLOCK;
+    for (i = 0; i < n; i++)
     {
-      if ((temp_zone == 1) && (UTM_Override == 60))
-        temp_zone = UTM_Override;
-      else if ((temp_zone == 60) && (UTM_Override == 1))
-        temp_zone = UTM_Override;
-      else if ((Lat_Degrees > 71) && (Long_Degrees > -1) && (Long_Degrees < 42))
-      {
-        if (((temp_zone-2) <= UTM_Override) && (UTM_Override <= (temp_zone+2)))
-          temp_zone = UTM_Override;
-        else
-          Error_Code = UTM_ZONE_OVERRIDE_ERROR;
-      }
-      else if (((temp_zone-1) <= UTM_Override) && (UTM_Override <= (temp_zone+1)))
-        temp_zone = UTM_Override;
+      lat[i] = Latitude[start + i];
+      lon[i] = Longitude[start + i];
+      code[i] = UTM_Zone(ctx->Override, &lat[i], &lon[i], &zone[i]);
+    }
+    for (i = 0; i < n; i = j)
+    { /* project each run of rows sharing a zone and hemisphere at once */
+      j = i + 1;
+      if (code[i])
+        continue;
+      south = (lat[i] < 0);
+      while ((j < n) && !code[j] && (zone[j] == zone[i]) && ((lat[j] < 0) == south))
+        j++;
+      if (Fast)
+        Convert_Geodetic_To_Transverse_Mercator_Fast_Batch_Ctx(&ctx->Zone_Parameters[zone[i] - 1][south],
+                                                               &lat[i], &lon[i], j - i,
+                                                               &east[i], &north[i], NULL);
       else
-        Error_Code = UTM_ZONE_OVERRIDE_ERROR;
+        Convert_Geodetic_To_Transverse_Mercator_Batch_Ctx(&ctx->Zone_Parameters[zone[i] - 1][south],
+                                                          &lat[i], &lon[i], j - i,
+                                                          &east[i], &north[i], NULL);
     }
-    if (!Error_Code)
+    for (i = 0; i < n; i++)
     {
-      if (temp_zone >= 31)
-        Central_Meridian = (6 * temp_zone - 183) * PI / 180.0;
-      else
-        Central_Meridian = (6 * temp_zone + 177) * PI / 180.0;
-      *Zone = temp_zone;
-      if (Latitude < 0)
+      if (!code[i])
       {
-        False_Northing = 10000000;
-        *Hemisphere = 'S';
+        Zone[start + i] = zone[i];
+        Hemisphere[start + i] = (lat[i] < 0) ? 'S' : 'N';
+        Easting[start + i] = east[i];
+        Northing[start + i] = north[i];
+        if ((east[i] < MIN_EASTING) || (east[i] > MAX_EASTING))
+          code[i] = UTM_EASTING_ERROR;
+        if ((north[i] < MIN_NORTHING) || (north[i] > MAX_NORTHING))
+          code[i] |= UTM_NORTHING_ERROR;
       }
-      else
-        *Hemisphere = 'N';
-      Set_Transverse_Mercator_Parameters(UTM_a, UTM_f, Origin_Latitude,
-                                         Central_Meridian, False_Easting, False_Northing, Scale);
-      Convert_Geodetic_To_Transverse_Mercator(Latitude, Longitude, Easting,
-                                              Northing);
-      if ((*Easting < MIN_EASTING) || (*Easting > MAX_EASTING))
-        Error_Code = UTM_EASTING_ERROR;
-      if ((*Northing < MIN_NORTHING) || (*Northing > MAX_NORTHING))
-        Error_Code |= UTM_NORTHING_ERROR;
+      if (code[i])
+        Error_Count++;
+      if (Error_Codes)
+        Error_Codes[start + i] = code[i];
     }
-  } /* END OF if (!Error_Code) */
-  return (Error_Code);
-} /* END OF Convert_Geodetic_To_UTM */
+  }
+  return (Error_Count);
+} /* END OF Geodetic_To_UTM_Rows */
+
+
+long Convert_Geodetic_To_UTM_Batch_Ctx (const UTM_Context *ctx,
+                                        const double *Latitude,
+                                        const double *Longitude,
+                                        size_t Count,
+                                        long   *Zone,
+                                        char   *Hemisphere,
+                                        double *Easting,
+                                        double *Northing,
+                                        long   *Error_Codes)
+{
+/*
+ * The function Convert_Geodetic_To_UTM_Batch_Ctx converts Count geodetic
+ * (latitude and longitude) coordinates to UTM projection (zone, hemisphere,
+ * easting and northing) coordinates according to the ellipsoid and UTM zone
+ * override held in ctx.  Consecutive rows in the same zone and hemisphere
+ * are projected together by the batch Transverse Mercator kernel; each row
+ * gets exactly what Convert_Geodetic_To_UTM_Ctx returns for it.  The number
+ * of rows with errors is returned by the function.
+ *
+ *    ctx               : UTM context                           (input)
+ *    Latitude          : Latitudes in radians                  (input)
+ *    Longitude         : Longitudes in radians                 (input)
+ *    Count             : Number of coordinates                 (input)
+ *    Zone              : UTM zones                             (output)
+ *    Hemisphere        : North or South hemispheres            (output)
+ *    Easting           : Eastings (X) in meters                (output)
+ *    Northing          : Northings (Y) in meters               (output)
+ *    Error_Codes       : Error code of each row, or NULL       (output)
+ */
+
+  return Geodetic_To_UTM_Rows(ctx, Latitude, Longitude, Count, Zone, Hemisphere,
+                              Easting, Northing, Error_Codes, 0);
+} /* END OF Convert_Geodetic_To_UTM_Batch_Ctx */
+
+
+long Convert_Geodetic_To_UTM_Fast_Batch (const double *Latitude,
+                                         const double *Longitude,
+                                         size_t Count,
+                                         long   *Zone,
+                                         char   *Hemisphere,
+                                         double *Easting,
+                                         double *Northing,
+                                         long   *Error_Codes)
+{
+/*
+ * The function Convert_Geodetic_To_UTM_Fast_Batch converts Count geodetic
+ * coordinates to UTM projection coordinates according to the current
+ * ellipsoid and UTM zone override parameters.  See
+ * Convert_Geodetic_To_UTM_Fast_Batch_Ctx.
+ */
+
+  return Convert_Geodetic_To_UTM_Fast_Batch_Ctx(Default_UTM_Context(), Latitude, Longitude, Count,
+                                                Zone, Hemisphere, Easting, Northing, Error_Codes);
+} /* END OF Convert_Geodetic_To_UTM_Fast_Batch */
+
+
+long Convert_Geodetic_To_UTM_Fast_Batch_Ctx (const UTM_Context *ctx,
+                                             const double *Latitude,
+                                             const double *Longitude,
+                                             size_t Count,
+                                             long   *Zone,
+                                             char   *Hemisphere,
+                                             double *Easting,
+                                             double *Northing,
+                                             long   *Error_Codes)
+{
+/*
+ * The function Convert_Geodetic_To_UTM_Fast_Batch_Ctx is
+ * Convert_Geodetic_To_UTM_Batch_Ctx with the single precision Transverse
+ * Mercator kernel (see Convert_Geodetic_To_Transverse_Mercator_Fast_Batch).
+ * Zones and hemispheres are the same; eastings and northings are within
+ * TRANMERC_FAST_TOLERANCE meters of the exact ones, and so are the
+ * easting and northing range errors decided on them.
+ *
+ *    ctx               : UTM context                           (input)
+ *    Latitude          : Latitudes in radians                  (input)
+ *    Longitude         : Longitudes in radians                 (input)
+ *    Count             : Number of coordinates                 (input)
+ *    Zone              : UTM zones                             (output)
+ *    Hemisphere        : North or South hemispheres            (output)
+ *    Easting           : Eastings (X) in meters                (output)
+ *    Northing          : Northings (Y) in meters               (output)
+ *    Error_Codes       : Error code of each row, or NULL       (output)
+ */
+
+  return Geodetic_To_UTM_Rows(ctx, Latitude, Longitude, Count, Zone, Hemisphere,
+                              Easting, Northing, Error_Codes, 1);
+} /* END OF Convert_Geodetic_To_UTM_Fast_Batch_Ctx */
 
 
 long Convert_UTM_To_Geodetic(long   Zone,
@@ -301,47 +817,172 @@ long Convert_UTM_To_Geodetic(long   Zone,
  *    Northing          : Northing (Y) in meters                 (input)
  *    Latitude          : Latitude in radians                    (output)
  *    Longitude         : Longitude in radians                   (output)
+ */
+
+  return Convert_UTM_To_Geodetic_Ctx(Default_UTM_Context(), Zone, Hemisphere,
+                                     Easting, Northing, Latitude, Longitude);
+} /* END OF Convert_UTM_To_Geodetic */
+
+
+long Convert_UTM_To_Geodetic_Ctx(const UTM_Context *ctx,
+                                 long   Zone,
+                                 char   Hemisphere,
+                                 double Easting,
+                                 double Northing,
+                                 double *Latitude,
+                                 double *Longitude)
+{
+/*
+ * The function Convert_UTM_To_Geodetic_Ctx converts UTM projection (zone,
+ * hemisphere, easting and northing) coordinates to geodetic(latitude
+ * and  longitude) coordinates, according to the ellipsoid parameters
+ * held in ctx.  If any errors occur, the error code(s) are returned
+ * by the function, otherwise UTM_NO_ERROR is returned.
+ *
+ *    ctx               : UTM context                            (input)
+ *    Zone              : UTM zone                               (input)
+ *    Hemisphere        : North or South hemisphere              (input)
+ *    Easting           : Easting (X) in meters                  (input)
+ *    Northing          : Northing (Y) in meters                 (input)
+ *    Latitude          : Latitude in radians                    (output)
+ *    Longitude         : Longitude in radians                   (output)
  */
   long Error_Code = UTM_NO_ERROR;
   long tm_error_code = UTM_NO_ERROR;
-  double Origin_Latitude = 0;
-  double Central_Meridian = 0;
-  double False_Easting = 500000;
-  double False_Northing = 0;
-  double Scale = 0.9996;
 
-  if ((Zone < 1) || (Zone > 60))
-    Error_Code |= UTM_ZONE_ERROR;
-  if ((Hemisphere != 'S') && (Hemisphere != 'N'))
-    Error_Code |= UTM_HEMISPHERE_ERROR;
-  if ((Easting < MIN_EASTING) || (Easting > MAX_EASTING))
-    Error_Code |= UTM_EASTING_ERROR;
-  if ((Northing < MIN_NORTHING) || (Northing > MAX_NORTHING))
-    Error_Code |= UTM_NORTHING_ERROR;
+  Error_Code = Check_UTM(Zone, Hemisphere, Easting, Northing);
   if (!Error_Code)
   { /* no errors */
-    if (Zone >= 31)
-      Central_Meridian = ((6 * Zone - 183) * PI / 180.0 /*+ 0.00000005*/);
+    tm_error_code = Convert_Transverse_Mercator_To_Geodetic_Ctx(&ctx->Zone_Parameters[Zone - 1][Hemisphere == 'S'],
+                                                                Easting, Northing, Latitude, Longitude);
+    if (tm_error_code & TM_REJECTED)
+      Error_Code = Check_UTM_Geodetic(tm_error_code, 0.0);
     else
-      Central_Meridian = ((6 * Zone + 177) * PI / 180.0 /*+ 0.00000005*/);
-    if (Hemisphere == 'S')
-      False_Northing = 10000000;
-    Set_Transverse_Mercator_Parameters(UTM_a, UTM_f, Origin_Latitude,
-                                       Central_Meridian, False_Easting, False_Northing, Scale);
-
-    tm_error_code = Convert_Transverse_Mercator_To_Geodetic(Easting, Northing, Latitude, Longitude);
-    if(tm_error_code)
+      Error_Code = Check_UTM_Geodetic(tm_error_code, *Latitude);
+  }
+  return (Error_Code);
+} /* END OF Convert_UTM_To_Geodetic_Ctx */
+
+
+long Convert_UTM_To_Geodetic_Batch (const long   *Zone,
+                                    const char   *Hemisphere,
+                                    const double *Easting,
+                                    const double *Northing,
+                                    size_t Count,
+                                    double *Latitude,
+                                    double *Longitude,
+                                    long   *Error_Codes)
+{
+/*
+ * The function Convert_UTM_To_Geodetic_Batch converts Count UTM projection
+ * coordinates to geodetic coordinates according to the current ellipsoid
+ * parameters.  See Convert_UTM_To_Geodetic_Batch_Ctx.
+ */
+
+  return Convert_UTM_To_Geodetic_Batch_Ctx(Default_UTM_Context(), Zone, Hemisphere, Easting,
+                                           Northing, Count, Latitude, Longitude, Error_Codes);
+} /* END OF Convert_UTM_To_Geodetic_Batch */
+
+
+long Convert_UTM_To_Geodetic_Batch_Ctx (const UTM_Context *ctx,
+                                        const long   *Zone,
+                                        const char   *Hemisphere,
+                                        const double *Easting,
+                                        const double *Northing,
+                                        size_t Count,
+                                        double *Latitude,
+                                        double *Longitude,
+                                        long   *Error_Codes)
+{
+/*
+ * The function Convert_UTM_To_Geodetic_Batch_Ctx converts Count UTM
+ * projection (zone, hemisphere, easting and northing) coordinates to
+ * geodetic (latitude and longitude) coordinates according to the ellipsoid
+ * held in ctx.  The rows of each block are grouped by zone and hemisphere
+ * and each group is converted at once by the batch Transverse Mercator
+ * kernel; each row gets exactly what Convert_UTM_To_Geodetic_Ctx returns
+ * for it.  The number of rows with errors is returned by the function.
+ *
+ *    ctx               : UTM context                           (input)
+ *    Zone              : UTM zones                             (input)
+ *    Hemisphere        : North or South hemispheres            (input)
+ *    Easting           : Eastings (X) in meters                (input)
+ *    Northing          : Northings (Y) in meters               (input)
+ *    Count             : Number of coordinates                 (input)
+ *    Latitude          : Latitudes in radians                  (output)
+ *    Longitude         : Longitudes in radians                 (output)
+ *    Error_Codes       : Error code of each row, or NULL       (output)
+ */
+
+  long   code[BATCH_BLOCK];
+  long   tm_code[BATCH_BLOCK];
+  size_t row[BATCH_BLOCK];            /* Block rows grouped by zone     */
+  double east[BATCH_BLOCK];
+  double north[BATCH_BLOCK];
+  double lat[BATCH_BLOCK];
+  double lon[BATCH_BLOCK];
+  size_t first[2 * UTM_ZONES + 1];    /* Start of each group in row[]   */
+  size_t start;
+  size_t n;
+  size_t i;
+  size_t k;
+  size_t key;
+  long   Error_Count = 0;
+
+  for (start = 0; start < Count; start += n)
+  {
+    n = Count - start;
+    if (n > BATCH_BLOCK)
+      n = BATCH_BLOCK;
+    for (key = 0; key <= 2 * UTM_ZONES; key++)
+      first[key] = 0;
+    for (i = 0; i < n; i++)
     {
-      if(tm_error_code & TRANMERC_EASTING_ERROR)
-        Error_Code |= UTM_EASTING_ERROR;
-      if(tm_error_code & TRANMERC_NORTHING_ERROR)
-        Error_Code |= UTM_NORTHING_ERROR;
+      code[i] = Check_UTM(Zone[start + i], Hemisphere[start + i],
+                          Easting[start + i], Northing[start + i]);
+      if (!code[i])
+        first[(Zone[start + i] - 1) * 2 + (Hemisphere[start + i] == 'S') + 1]++;
     }
-
-    if ((*Latitude < MIN_LAT) || (*Latitude > MAX_LAT))
-    { /* Latitude out of range */
-      Error_Code |= UTM_NORTHING_ERROR;
+    for (key = 1; key <= 2 * UTM_ZONES; key++)
+      first[key] += first[key - 1];
+    for (i = 0; i < n; i++)
+    {
+      if (code[i])
+        continue;
+      k = first[(Zone[start + i] - 1) * 2 + (Hemisphere[start + i] == 'S')]++;
+      row[k] = i;
+      east[k] = Easting[start + i];
+      north[k] = Northing[start + i];
+    }
+    /* first[key] is now the end of group key */
+    for (k = 0, key = 0; key < 2 * UTM_ZONES; key++)
+    {
+      if (first[key] > k)
+      {
+        Convert_Transverse_Mercator_To_Geodetic_Batch_Ctx(&ctx->Zone_Parameters[key / 2][key % 2],
+                                                          &east[k], &north[k], first[key] - k,
+                                                          &lat[k], &lon[k], &tm_code[k]);
+        k = first[key];
+      }
+    }
+    for (k = 0; k < first[2 * UTM_ZONES - 1]; k++)
+    { /* rows the kernel rejects are left unwritten */
+      if (tm_code[k] & TM_REJECTED)
+        code[row[k]] = Check_UTM_Geodetic(tm_code[k], 0.0);
+      else
+      {
+        Latitude[start + row[k]] = lat[k];
+        Longitude[start + row[k]] = lon[k];
+        code[row[k]] = Check_UTM_Geodetic(tm_code[k], lat[k]);
+      }
+    }
+    for (i = 0; i < n; i++)
+    {
+      if (code[i])
+        Error_Count++;
+      if (Error_Codes)
+        Error_Codes[start + i] = code[i];
     }
   }
-  return (Error_Code);
-} /* END OF Convert_UTM_To_Geodetic */
+  return (Error_Count);
+} /* END OF Convert_UTM_To_Geodetic_Batch_Ctx */
@@ -1,6 +1,8 @@
 #ifndef UTM_H
   #define UTM_H
 
+#include "tranmerc.h"
+
 /***************************************************************************/
 /* RSC IDENTIFIER: UTM
  *
@@ -33,6 +35,7 @@
  *          UTM_A_ERROR            : Semi-major axis less than or equal to zero
  *          UTM_INV_F_ERROR        : Inverse flattening outside of valid range
  *								  	                (250 to 350)
+ *          UTM_ENGINE_ERROR       : Invalid Transverse Mercator series engine
  *
  * REUSE NOTES
  *
@@ -87,6 +90,7 @@
   #define UTM_ZONE_OVERRIDE_ERROR 0x0040
   #define UTM_A_ERROR             0x0080
   #define UTM_INV_F_ERROR         0x0100
+  #define UTM_ENGINE_ERROR        0x0200
 
   #define PI           3.14159265358979323e0    /* PI                        */
   #define MIN_LAT      ( (-80.5 * PI) / 180.0 ) /* -80.5 degrees in radians    */
@@ -96,6 +100,33 @@
   #define MIN_NORTHING 0
   #define MAX_NORTHING 10000000
 
+
+/***************************************************************************/
+/*
+ *                              TYPES
+ */
+
+/*
+ * A UTM_Context holds the ellipsoid and zone override state that the
+ * non-reentrant functions below keep in file-scope variables, along with
+ * the Transverse Mercator parameters of every zone and hemisphere for that
+ * ellipsoid, and the series engine those zones evaluate.  A context must be
+ * set with Set_UTM_Parameters_Ctx before use.
+ */
+
+  #define UTM_ZONES 60
+
+  typedef struct UTM_Context_Value
+  {
+    double a;         /* Semi-major axis of ellipsoid in meters  */
+    double f;         /* Flattening of ellipsoid                 */
+    long   Override;  /* Zone override flag                      */
+    long   Engine;    /* Series engine of every zone             */
+    Transverse_Mercator_Context Zone_Parameters[UTM_ZONES][2];
+                      /* TM parameters by zone - 1 and hemisphere */
+                      /* (0 = 'N', 1 = 'S')                       */
+  } UTM_Context;
+
 /***************************************************************************/
 /*
  *                              FUNCTION PROTOTYPES
@@ -135,6 +166,18 @@ extern "C" {
  */
 
 
+  long Set_UTM_Engine(long Engine);
+/*
+ * The function Set_UTM_Engine selects the Transverse Mercator series the
+ * conversions of every zone evaluate, TRANMERC_THOMAS (the default) or
+ * TRANMERC_KRUGER; see Set_Transverse_Mercator_Engine.  The engine is kept
+ * when the parameters are set again.  If Engine is invalid
+ * UTM_ENGINE_ERROR is returned, otherwise UTM_NO_ERROR.
+ *
+ *    Engine            : TRANMERC_THOMAS or TRANMERC_KRUGER            (input)
+ */
+
+
   long Convert_Geodetic_To_UTM (double Latitude,
                                 double Longitude,
                                 long   *Zone,
@@ -157,6 +200,22 @@ extern "C" {
  */
 
 
+  long Convert_Geodetic_To_UTM_Override (long   Override,
+                                         double Latitude,
+                                         double Longitude,
+                                         long   *Zone,
+                                         char   *Hemisphere,
+                                         double *Easting,
+                                         double *Northing);
+/*
+ * The function Convert_Geodetic_To_UTM_Override is Convert_Geodetic_To_UTM
+ * with the UTM zone override given by Override in place of the current
+ * one, which is left unchanged.
+ *
+ *    Override          : UTM override zone, zero indicates no override (input)
+ */
+
+
   long Convert_UTM_To_Geodetic(long   Zone,
                                char   Hemisphere,
                                double Easting,
@@ -176,6 +235,227 @@ extern "C" {
  *    Northing          : Northing (Y) in meters                 (input)
  *    Latitude          : Latitude in radians                    (output)
  *    Longitude         : Longitude in radians                   (output)
+ */
+
+  long Set_UTM_Parameters_Ctx(UTM_Context *ctx,
+                              double a,
+                              double f,
+                              long   override);
+/*
+ * The function Set_UTM_Parameters_Ctx is the reentrant form of
+ * Set_UTM_Parameters.  It sets the state variables held in the context ctx
+ * and computes the Transverse Mercator parameters of every zone, keeping
+ * the engine of ctx: TRANMERC_KRUGER if Set_UTM_Engine_Ctx selected it,
+ * otherwise TRANMERC_THOMAS.
+ *
+ *    ctx               : UTM context                                   (output)
+ */
+
+
+  void Get_UTM_Parameters_Ctx(const UTM_Context *ctx,
+                              double *a,
+                              double *f,
+                              long   *override);
+/*
+ * The function Get_UTM_Parameters_Ctx returns the ellipsoid parameters and
+ * UTM zone override parameter held in the context ctx.
+ *
+ *    ctx               : UTM context                                   (input)
+ */
+
+
+  long Set_UTM_Engine_Ctx(UTM_Context *ctx,
+                          long Engine);
+/*
+ * The function Set_UTM_Engine_Ctx is the reentrant form of Set_UTM_Engine.
+ * It selects the engine of the zones held in the context ctx.
+ *
+ *    ctx               : UTM context                                   (input/output)
+ */
+
+
+  long Convert_Geodetic_To_UTM_Ctx (const UTM_Context *ctx,
+                                    double Latitude,
+                                    double Longitude,
+                                    long   *Zone,
+                                    char   *Hemisphere,
+                                    double *Easting,
+                                    double *Northing);
+/*
+ * The function Convert_Geodetic_To_UTM_Ctx is the reentrant form of
+ * Convert_Geodetic_To_UTM.  It uses the ellipsoid and UTM zone override
+ * parameters held in the context ctx.
+ *
+ *    ctx               : UTM context                         (input)
+ */
+
+
+  long Convert_Geodetic_To_UTM_Override_Ctx (const UTM_Context *ctx,
+                                             long   Override,
+                                             double Latitude,
+                                             double Longitude,
+                                             long   *Zone,
+                                             char   *Hemisphere,
+                                             double *Easting,
+                                             double *Northing);
+/*
+ * The function Convert_Geodetic_To_UTM_Override_Ctx is
+ * Convert_Geodetic_To_UTM_Ctx with the UTM zone override given by Override
+ * in place of the one held in the context ctx.
+ *
+ *    ctx               : UTM context                                   (input)
+ *    Override          : UTM override zone, zero indicates no override (input)
+ */
+
+
+  long Convert_Geodetic_To_UTM_Batch (const double *Latitude,
+                                      const double *Longitude,
+                                      size_t Count,
+                                      long   *Zone,
+                                      char   *Hemisphere,
+                                      double *Easting,
+                                      double *Northing,
+                                      long   *Error_Codes);
+/*
+ * The function Convert_Geodetic_To_UTM_Batch converts Count geodetic
+ * coordinates to UTM projection coordinates according to the current
+ * ellipsoid and UTM zone override parameters, projecting rows that share a
+ * zone and hemisphere with the vectorized Transverse Mercator kernel.  Each
+ * row gets the result and error code that Convert_Geodetic_To_UTM returns
+ * for it.  The number of rows with errors is returned by the function.
+ *
+ *    Latitude          : Latitudes in radians                  (input)
+ *    Longitude         : Longitudes in radians                 (input)
+ *    Count             : Number of coordinates                 (input)
+ *    Zone              : UTM zones                             (output)
+ *    Hemisphere        : North or South hemispheres            (output)
+ *    Easting           : Eastings (X) in meters                (output)
+ *    Northing          : Northings (Y) in meters               (output)
+ *    Error_Codes       : Error code of each row, or NULL       (output)
+ */
+
+
+  long Convert_Geodetic_To_UTM_Batch_Ctx (const UTM_Context *ctx,
+                                          const double *Latitude,
+                                          const double *Longitude,
+                                          size_t Count,
+                                          long   *Zone,
+                                          char   *Hemisphere,
+                                          double *Easting,
+                                          double *Northing,
+                                          long   *Error_Codes);
+/*
+ * The function Convert_Geodetic_To_UTM_Batch_Ctx is the reentrant form of
+ * Convert_Geodetic_To_UTM_Batch.  It uses the ellipsoid parameters and UTM
+ * zone override held in the context ctx.
+ *
+ *    ctx               : UTM context                           (input)
+ */
+
+
+  long Convert_UTM_To_Geodetic_Ctx(const UTM_Context *ctx,
+                                   long   Zone,
+                                   char   Hemisphere,
+                                   double Easting,
+                                   double Northing,
+                                   double *Latitude,
+                                   double *Longitude);
+/*
+ * The function Convert_UTM_To_Geodetic_Ctx is the reentrant form of
+ * Convert_UTM_To_Geodetic.  It uses the ellipsoid parameters held in the
+ * context ctx.
+ *
+ *    ctx               : UTM context                            (input)
+ */
+
+
+  long Convert_Geodetic_To_UTM_Fast_Batch (const double *Latitude,
+                                           const double *Longitude,
+                                           size_t Count,
+                                           long   *Zone,
+                                           char   *Hemisphere,
+                                           double *Easting,
+                                           double *Northing,
+                                           long   *Error_Codes);
+/*
+ * The function Convert_Geodetic_To_UTM_Fast_Batch is
+ * Convert_Geodetic_To_UTM_Batch with the single precision Transverse
+ * Mercator kernel of Convert_Geodetic_To_Transverse_Mercator_Fast_Batch.
+ * Zones and hemispheres are the same; eastings and northings, and the range
+ * errors decided on them, are within TRANMERC_FAST_TOLERANCE meters of the
+ * exact ones.
+ *
+ *    Latitude          : Latitudes in radians                  (input)
+ *    Longitude         : Longitudes in radians                 (input)
+ *    Count             : Number of coordinates                 (input)
+ *    Zone              : UTM zones                             (output)
+ *    Hemisphere        : North or South hemispheres            (output)
+ *    Easting           : Eastings (X) in meters                (output)
+ *    Northing          : Northings (Y) in meters               (output)
+ *    Error_Codes       : Error code of each row, or NULL       (output)
+ */
+
+
+  long Convert_Geodetic_To_UTM_Fast_Batch_Ctx (const UTM_Context *ctx,
+                                               const double *Latitude,
+                                               const double *Longitude,
+                                               size_t Count,
+                                               long   *Zone,
+                                               char   *Hemisphere,
+                                               double *Easting,
+                                               double *Northing,
+                                               long   *Error_Codes);
+/*
+ * The function Convert_Geodetic_To_UTM_Fast_Batch_Ctx is the reentrant form
+ * of Convert_Geodetic_To_UTM_Fast_Batch.  It uses the ellipsoid parameters
+ * and UTM zone override held in the context ctx.
+ *
+ *    ctx               : UTM context                           (input)
+ */
+
+
+  long Convert_UTM_To_Geodetic_Batch (const long   *Zone,
+                                      const char   *Hemisphere,
+                                      const double *Easting,
+                                      const double *Northing,
+                                      size_t Count,
+                                      double *Latitude,
+                                      double *Longitude,
+                                      long   *Error_Codes);
+/*
+ * The function Convert_UTM_To_Geodetic_Batch converts Count UTM projection
+ * coordinates to geodetic coordinates according to the current ellipsoid
+ * parameters, converting rows that share a zone and hemisphere with the
+ * vectorized Transverse Mercator kernel.  Each row gets the result and
+ * error code that Convert_UTM_To_Geodetic returns for it.  The number of
+ * rows with errors is returned by the function.
+ *
+ *    Zone              : UTM zones                             (input)
+ *    Hemisphere        : North or South hemispheres            (input)
+ *    Easting           : Eastings (X) in meters                (input)
+ *    Northing          : Northings (Y) in meters               (input)
+ *    Count             : Number of coordinates                 (input)
+ *    Latitude          : Latitudes in radians                  (output)
+ *    Longitude         : Longitudes in radians                 (output)
+ *    Error_Codes       : Error code of each row, or NULL       (output)
+ */
+
+
+  long Convert_UTM_To_Geodetic_Batch_Ctx (const UTM_Context *ctx,
+                                          const long   *Zone,
+                                          const char   *Hemisphere,
+                                          const double *Easting,
+                                          const double *Northing,
+                                          size_t Count,
+                                          double *Latitude,
+                                          double *Longitude,
+                                          long   *Error_Codes);
+/*
+ * The function Convert_UTM_To_Geodetic_Batch_Ctx is the reentrant form of
+ * Convert_UTM_To_Geodetic_Batch.  It uses the ellipsoid parameters held in
+ * the context ctx.
+ *
+ *    ctx               : UTM context                           (input)
  */
 
   #ifdef __cplusplus
@@ -0,0 +1,247 @@
+/*
+ * Tests of the batch C interface: every batch function must give each row
+ * exactly the result and error code of the per-point _Ctx function.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include "mgrs_batch.h"
+
+#define DEG_TO_RAD  0.017453292519943295
+#define ROWS        4661  /* 59 latitudes by 79 longitudes */
+
+static int failures = 0;
+
+#define CHECK(cond) \
+  do { if (!(cond)) { failures++; fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, #cond); } } while (0)
+
+static double lat[ROWS], lon[ROWS];
+static char mgrs[ROWS * MGRS_STRING_LENGTH], fast[ROWS * MGRS_STRING_LENGTH];
+static const char *strings[ROWS];
+static long codes[ROWS], zone[ROWS];
+static char hemisphere[ROWS];
+static double easting[ROWS], northing[ROWS], out_lat[ROWS], out_lon[ROWS];
+
+
+static void test_context (void)
+{
+  long error_code = MGRS_NO_ERROR;
+  mgrs_context *ctx;
+
+  CHECK(mgrs_context_create (-1.0, 1 / 298.257223563, "WE", &error_code) == NULL);
+  CHECK(error_code == MGRS_A_ERROR);
+  CHECK(mgrs_context_create (6378137.0, 1 / 100.0, "WE", NULL) == NULL);
+
+  ctx = mgrs_context_create (6378137.0, 1 / 298.257223563, "WE", &error_code);
+  CHECK(ctx != NULL);
+  CHECK(error_code == MGRS_NO_ERROR);
+  CHECK(mgrs_context_set_engine (ctx, 7) == UTM_ENGINE_ERROR);
+  CHECK(mgrs_context_set_engine (ctx, TRANMERC_KRUGER) == UTM_NO_ERROR);
+  mgrs_context_destroy (ctx);
+  mgrs_context_destroy (NULL);
+}
+
+
+static void test_mgrs (const mgrs_context *ctx)
+{
+  const MGRS_Context *mc = mgrs_context_get (ctx);
+  const long precision[] = {5, 0, 3, 1, 4, 2};
+  char one[MGRS_STRING_LENGTH];
+  double la, lo;
+  long z, error_code, error_count = 0;
+  char h;
+  double e, n;
+  size_t i;
+
+  CHECK(mgrs_encode_batch (ctx, lat, lon, ROWS, precision, 6, mgrs, codes) > 0);
+  for (i = 0; i < ROWS; i++)
+  {
+    error_code = Convert_Geodetic_To_MGRS_Ctx (mc, lat[i], lon[i], precision[i % 6], one);
+    CHECK(codes[i] == error_code);
+    CHECK(strcmp (mgrs + i * MGRS_STRING_LENGTH, error_code ? "" : one) == 0);
+    error_count += (error_code != MGRS_NO_ERROR);
+    strings[i] = mgrs + i * MGRS_STRING_LENGTH;
+  }
+
+  CHECK(mgrs_encode_fast_batch (ctx, lat, lon, ROWS, precision, 6, fast, NULL) == error_count);
+  for (i = 0; i < ROWS; i++)
+    CHECK(strcmp (fast + i * MGRS_STRING_LENGTH, strings[i]) == 0);
+
+  mgrs_decode_batch (ctx, strings, ROWS, out_lat, out_lon, codes);
+  for (i = 0; i < ROWS; i++)
+  {
+    error_code = Convert_MGRS_To_Geodetic_Ctx (mc, strings[i], &la, &lo);
+    CHECK(codes[i] == error_code);
+    if (!error_code)
+      CHECK((out_lat[i] == la) && (out_lon[i] == lo));
+  }
+
+  mgrs_to_utm_batch (ctx, strings, ROWS, zone, hemisphere, easting, northing, codes);
+  for (i = 0; i < ROWS; i++)
+  {
+    error_code = Convert_MGRS_To_UTM_Ctx (mc, strings[i], &z, &h, &e, &n);
+    CHECK(codes[i] == error_code);
+    if (!error_code)
+      CHECK((zone[i] == z) && (hemisphere[i] == h) && (easting[i] == e) && (northing[i] == n));
+  }
+
+  mgrs_to_ups_batch (ctx, strings, ROWS, hemisphere, easting, northing, codes);
+  for (i = 0; i < ROWS; i++)
+  {
+    error_code = Convert_MGRS_To_UPS_Ctx (mc, strings[i], &h, &e, &n);
+    CHECK(codes[i] == error_code);
+    if (!error_code)
+      CHECK((hemisphere[i] == h) && (easting[i] == e) && (northing[i] == n));
+  }
+  CHECK(mgrs_encode_batch (ctx, lat, lon, ROWS, precision, 0, mgrs, codes) == ROWS);
+  CHECK(codes[0] & MGRS_PRECISION_ERROR);
+}
+
+
+static void test_utm (const mgrs_context *ctx,
+                      int wgs84)
+{
+  const MGRS_Context *mc = mgrs_context_get (ctx);
+  const long utm_zone[] = {48, 48, 3, 3, 33, 61};
+  const char utm_hemisphere[] = {'N', 'N', 'N', 'N', 'S', 'N'};
+  const double utm_easting[] = {377299.0, 377299.0, 899999.0, 900000.0, NAN, 500000.0};
+  const double utm_northing[] = {1483035.0, 1483035.0, 5000000.0, 5000000.0, 5000000.0, 0.0};
+  const long precision[] = {5, 2};
+  char one[MGRS_STRING_LENGTH];
+  double la, lo;
+  long z, error_code;
+  char h;
+  double e, n;
+  size_t i;
+
+  CHECK(utm_to_mgrs_batch (ctx, utm_zone, utm_hemisphere, utm_easting, utm_northing, 6,
+                           precision, 2, mgrs, codes) == 3);
+  CHECK((codes[3] == MGRS_EASTING_ERROR) && (mgrs[3 * MGRS_STRING_LENGTH] == '\0'));
+  CHECK(codes[4] & MGRS_EASTING_ERROR);
+  CHECK(codes[5] & MGRS_ZONE_ERROR);
+
+  utm_to_geodetic_batch (ctx, utm_zone, utm_hemisphere, utm_easting, utm_northing, 6,
+                         out_lat, out_lon, codes);
+  CHECK(codes[4] == UTM_EASTING_ERROR);
+  CHECK(codes[5] == UTM_ZONE_ERROR);
+  if (wgs84)
+  {
+    CHECK(strcmp (mgrs, "48PUV7729983035") == 0);
+    CHECK(strcmp (mgrs + MGRS_STRING_LENGTH, "48PUV7783") == 0);
+    CHECK(strcmp (mgrs + 2 * MGRS_STRING_LENGTH, "03TZL9999900000") == 0);
+    CHECK(fabs (out_lat[0] / DEG_TO_RAD - 13.4125018762) < 1e-10);
+    CHECK(fabs (out_lon[0] / DEG_TO_RAD - 103.8666690138) < 1e-10);
+  }
+
+  geodetic_to_utm_batch (ctx, lat, lon, ROWS, zone, hemisphere, easting, northing, codes);
+  for (i = 0; i < ROWS; i++)
+  {
+    error_code = Convert_Geodetic_To_UTM_Ctx (&mc->utm, lat[i], lon[i], &z, &h, &e, &n);
+    CHECK(codes[i] == error_code);
+    if (!error_code)
+      CHECK((zone[i] == z) && (hemisphere[i] == h) && (easting[i] == e) && (northing[i] == n));
+  }
+
+  for (i = 0; i < ROWS; i++)
+    if (codes[i])
+      zone[i] = 0;
+  utm_to_geodetic_batch (ctx, zone, hemisphere, easting, northing, ROWS, out_lat, out_lon, codes);
+  for (i = 0; i < ROWS; i++)
+  {
+    error_code = Convert_UTM_To_Geodetic_Ctx (&mc->utm, zone[i], hemisphere[i], easting[i],
+                                              northing[i], &la, &lo);
+    CHECK(codes[i] == error_code);
+    if (!error_code)
+      CHECK((out_lat[i] == la) && (out_lon[i] == lo));
+  }
+
+  CHECK(utm_to_mgrs_batch (ctx, zone, hemisphere, easting, northing, ROWS, precision, 1,
+                           mgrs, codes) > 0);
+  for (i = 0; i < ROWS; i++)
+  {
+    error_code = Convert_UTM_To_MGRS_Ctx (mc, zone[i], hemisphere[i], easting[i], northing[i],
+                                          5, one);
+    CHECK(codes[i] == error_code);
+    CHECK(strcmp (mgrs + i * MGRS_STRING_LENGTH, error_code ? "" : one) == 0);
+  }
+}
+
+
+static void test_ups (const mgrs_context *ctx)
+{
+  const MGRS_Context *mc = mgrs_context_get (ctx);
+  const long precision[] = {5};
+  char one[MGRS_STRING_LENGTH];
+  double la, lo;
+  long error_code;
+  char h;
+  double e, n;
+  size_t i;
+
+  geodetic_to_ups_batch (ctx, lat, lon, ROWS, hemisphere, easting, northing, codes);
+  for (i = 0; i < ROWS; i++)
+  {
+    error_code = Convert_Geodetic_To_UPS_Ctx (&mc->ups, lat[i], lon[i], &h, &e, &n);
+    CHECK(codes[i] == error_code);
+    if (!error_code)
+      CHECK((hemisphere[i] == h) && (easting[i] == e) && (northing[i] == n));
+    else
+      hemisphere[i] = '?';
+  }
+
+  ups_to_geodetic_batch (ctx, hemisphere, easting, northing, ROWS, out_lat, out_lon, codes);
+  for (i = 0; i < ROWS; i++)
+  {
+    error_code = Convert_UPS_To_Geodetic_Ctx (&mc->ups, hemisphere[i], easting[i], northing[i],
+                                              &la, &lo);
+    CHECK(codes[i] == error_code);
+    if (!error_code)
+      CHECK((out_lat[i] == la) && (out_lon[i] == lo));
+  }
+
+  ups_to_mgrs_batch (ctx, hemisphere, easting, northing, ROWS, precision, 1, mgrs, codes);
+  for (i = 0; i < ROWS; i++)
+  {
+    error_code = Convert_UPS_To_MGRS_Ctx (mc, hemisphere[i], easting[i], northing[i], 5, one);
+    CHECK(codes[i] == error_code);
+    CHECK(strcmp (mgrs + i * MGRS_STRING_LENGTH, error_code ? "" : one) == 0);
+  }
+}
+
+
+int main (void)
+{
+  const double a[] = {6378137.0, 6378206.4};
+  const double inv_f[] = {298.257223563, 294.9786982};
+  const char *code[] = {"WE", "CC"};
+  mgrs_context *ctx;
+  size_t i;
+  int k;
+
+  /* a grid over both poles and the antimeridian, plus missing values */
+  for (i = 0; i < ROWS; i++)
+  {
+    lat[i] = (-87.0 + 3.0 * (double)(i / 79)) * DEG_TO_RAD;
+    lon[i] = (-181.0 + 4.63 * (double)(i % 79)) * DEG_TO_RAD;
+  }
+  lat[100] = NAN;
+  lon[200] = NAN;
+
+  test_context ();
+  for (k = 0; k < 2; k++)
+  {
+    ctx = mgrs_context_create (a[k], 1 / inv_f[k], code[k], NULL);
+    CHECK(ctx != NULL);
+    test_mgrs (ctx);
+    test_utm (ctx, !k);
+    test_ups (ctx);
+    CHECK(mgrs_context_set_engine (ctx, TRANMERC_KRUGER) == UTM_NO_ERROR);
+    test_utm (ctx, !k);
+    mgrs_context_destroy (ctx);
+  }
+
+  if (failures)
+    fprintf (stderr, "%d checks failed\n", failures);
+  return (failures ? 1 : 0);
+}
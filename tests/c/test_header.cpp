@@ -0,0 +1,315 @@
+/*
+ * Tests of the header-only C++ interface: every mgrs.hpp function must give
+ * exactly the result and error code of the C function it repeats.
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "mgrs_batch.h"
+#include "mgrs.hpp"
+
+#define DEG_TO_RAD  0.017453292519943295
+
+static int failures = 0;
+
+#define CHECK(cond) \
+  do { if (!(cond)) { failures++; fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, #cond); } } while (0)
+
+static std::vector < double > lat, lon;
+static std::vector < std::string > strings;
+
+
+static bool same (double x, double y)
+{
+  return (std::memcmp (&x, &y, sizeof (x)) == 0);
+}
+
+
+static void test_tm (const UTM_Context &uc)
+{
+  const Transverse_Mercator_Context &tc = uc.Zone_Parameters[32][0];
+  double e, n, la, lo;
+  long error_code;
+
+  for (size_t i = 0; i < lat.size (); i++)
+  {
+    mgrs::tm_result tm = mgrs::geodetic_to_tm (tc, lat[i], lon[i]);
+    error_code = Convert_Geodetic_To_Transverse_Mercator_Ctx (&tc, lat[i], lon[i], &e, &n);
+    CHECK(tm.error == error_code);
+    if (!(error_code & ~TRANMERC_LON_WARNING))
+    {
+      CHECK(same (tm.easting, e) && same (tm.northing, n));
+      mgrs::geodetic_result geo = mgrs::tm_to_geodetic (tc, e, n);
+      error_code = Convert_Transverse_Mercator_To_Geodetic_Ctx (&tc, e, n, &la, &lo);
+      CHECK(geo.error == error_code);
+      if (!(error_code & ~TRANMERC_LON_WARNING))
+        CHECK(same (geo.latitude, la) && same (geo.longitude, lo));
+    }
+  }
+}
+
+
+static void test_utm (const UTM_Context &uc)
+{
+  const long overrides[] = {0, 30, 32, 60, 1, 61, -1};
+  double la, lo;
+  long z, error_code;
+  char h;
+  double e, n;
+
+  for (size_t i = 0; i < lat.size (); i++)
+  {
+    for (long zone_override : overrides)
+    {
+      mgrs::utm_result utm = mgrs::geodetic_to_utm_override (uc, zone_override, lat[i], lon[i]);
+      error_code = Convert_Geodetic_To_UTM_Override_Ctx (&uc, zone_override, lat[i], lon[i],
+                                                         &z, &h, &e, &n);
+      CHECK(utm.error == error_code);
+      if (!error_code)
+        CHECK((utm.zone == z) && (utm.hemisphere == h) && same (utm.easting, e) &&
+              same (utm.northing, n));
+    }
+
+    mgrs::utm_result utm = mgrs::geodetic_to_utm (uc, lat[i], lon[i]);
+    for (long dz = -1; dz <= 1; dz++)
+    {
+      mgrs::geodetic_result geo = mgrs::utm_to_geodetic (uc, utm.zone + dz, utm.hemisphere,
+                                                         utm.easting, utm.northing);
+      error_code = Convert_UTM_To_Geodetic_Ctx (&uc, utm.zone + dz, utm.hemisphere, utm.easting,
+                                                utm.northing, &la, &lo);
+      CHECK(geo.error == error_code);
+      if (!error_code)
+        CHECK(same (geo.latitude, la) && same (geo.longitude, lo));
+    }
+  }
+
+  /* zone 61 is within one zone of 60, but there is no table for it */
+  CHECK(mgrs::geodetic_to_utm_override (uc, 61, 0.5 * DEG_TO_RAD, 179.5 * DEG_TO_RAD).error ==
+        UTM_ZONE_OVERRIDE_ERROR);
+  CHECK(Convert_Geodetic_To_UTM_Override_Ctx (&uc, 61, 0.5 * DEG_TO_RAD, 179.5 * DEG_TO_RAD,
+                                              &z, &h, &e, &n) == UTM_ZONE_OVERRIDE_ERROR);
+}
+
+
+static void test_mgrs (const MGRS_Context &mc)
+{
+  char one[MGRS_STRING_LENGTH];
+  double la, lo;
+  long z, error_code;
+  char h;
+  double e, n;
+  long precision;
+
+  for (size_t i = 0; i < lat.size (); i++)
+  {
+    precision = (long)(i % 7) - (i % 13 == 0);  /* -1 to 6 */
+    mgrs::mgrs_result m = mgrs::geodetic_to_mgrs (mc, lat[i], lon[i], precision);
+    error_code = Convert_Geodetic_To_MGRS_Ctx (&mc, lat[i], lon[i], precision, one);
+    CHECK(m.error == error_code);
+    CHECK(std::strcmp (m.mgrs, error_code ? "" : one) == 0);
+
+    mgrs::utm_result utm = mgrs::geodetic_to_utm (mc.utm, lat[i], lon[i]);
+    for (double de : {0.0, 0.5, -0.5, 900000.0 - utm.easting, 500000.0 - utm.easting})
+    {
+      m = mgrs::utm_to_mgrs (mc, utm.zone, utm.hemisphere, utm.easting + de, utm.northing, 5);
+      error_code = Convert_UTM_To_MGRS_Ctx (&mc, utm.zone, utm.hemisphere, utm.easting + de,
+                                            utm.northing, 5, one);
+      CHECK(m.error == error_code);
+      CHECK(std::strcmp (m.mgrs, error_code ? "" : one) == 0);
+    }
+  }
+
+  for (const std::string &s : strings)
+  {
+    mgrs::geodetic_result geo = mgrs::mgrs_to_geodetic (mc, s.c_str ());
+    error_code = Convert_MGRS_To_Geodetic_Ctx (&mc, s.c_str (), &la, &lo);
+    CHECK(geo.error == error_code);
+    if (!error_code || (error_code == MGRS_LAT_WARNING))
+      CHECK(same (geo.latitude, la) && same (geo.longitude, lo));
+
+    mgrs::utm_result utm = mgrs::mgrs_to_utm (mc, s.c_str ());
+    error_code = Convert_MGRS_To_UTM_Ctx (&mc, s.c_str (), &z, &h, &e, &n);
+    CHECK(utm.error == error_code);
+    if (!error_code || (error_code == MGRS_LAT_WARNING))
+      CHECK((utm.zone == z) && (utm.hemisphere == h) && same (utm.easting, e) &&
+            same (utm.northing, n));
+  }
+}
+
+
+static void test_batch (const MGRS_Context &mc)
+{
+  const size_t rows = lat.size ();
+  const long precision[] = {5, 0, 3};
+  std::vector < mgrs::mgrs_result > m (rows);
+  std::vector < mgrs::utm_result > utm (rows);
+  std::vector < mgrs::ups_result > ups (rows);
+  std::vector < mgrs::geodetic_result > geo (rows);
+  std::vector < const char * > mgrs (rows);
+  std::vector < long > zone (rows);
+  std::vector < char > hemisphere (rows);
+  std::vector < double > easting (rows), northing (rows);
+  long failed = 0;
+
+  CHECK(mgrs::geodetic_to_mgrs (mc, lat, lon, precision, m) > 0);
+  for (size_t i = 0; i < rows; i++)
+  {
+    mgrs::mgrs_result one = mgrs::geodetic_to_mgrs (mc, lat[i], lon[i], precision[i % 3]);
+    CHECK((m[i].error == one.error) && (std::strcmp (m[i].mgrs, one.mgrs) == 0));
+    mgrs[i] = m[i].mgrs;
+  }
+  CHECK(mgrs::geodetic_to_mgrs (mc, lat, lon, mgrs::span < const long > (), m) == (long)rows);
+  CHECK((m[0].error == MGRS_PRECISION_ERROR) && (m[0].mgrs[0] == '\0'));
+  CHECK(mgrs::geodetic_to_mgrs (mc, lat, lon, precision, m) > 0);
+
+  mgrs::mgrs_to_geodetic (mc, mgrs, geo);
+  for (size_t i = 0; i < rows; i++)
+  {
+    mgrs::geodetic_result one = mgrs::mgrs_to_geodetic (mc, mgrs[i]);
+    CHECK((geo[i].error == one.error) && same (geo[i].latitude, one.latitude) &&
+          same (geo[i].longitude, one.longitude));
+  }
+
+  failed = mgrs::geodetic_to_utm (mc.utm, lat, lon, utm);
+  for (size_t i = 0; i < rows; i++)
+  {
+    mgrs::utm_result one = mgrs::geodetic_to_utm (mc.utm, lat[i], lon[i]);
+    CHECK((utm[i].error == one.error) && (utm[i].zone == one.zone) && same (utm[i].easting, one.easting));
+    failed -= (one.error != 0);
+    zone[i] = utm[i].zone;
+    hemisphere[i] = utm[i].hemisphere;
+    easting[i] = utm[i].easting;
+    northing[i] = utm[i].northing;
+  }
+  CHECK(failed == 0);
+
+  mgrs::utm_to_geodetic (mc.utm, zone, hemisphere, easting, northing, geo);
+  mgrs::utm_to_mgrs (mc, zone, hemisphere, easting, northing, precision, m);
+  mgrs::mgrs_to_utm (mc, mgrs::span < const char *const > (mgrs.data (), rows), utm);
+  for (size_t i = 0; i < rows; i++)
+  {
+    mgrs::geodetic_result g = mgrs::utm_to_geodetic (mc.utm, zone[i], hemisphere[i], easting[i], northing[i]);
+    CHECK((geo[i].error == g.error) && same (geo[i].latitude, g.latitude));
+    mgrs::mgrs_result s = mgrs::utm_to_mgrs (mc, zone[i], hemisphere[i], easting[i], northing[i],
+                                             precision[i % 3]);
+    CHECK((m[i].error == s.error) && (std::strcmp (m[i].mgrs, s.mgrs) == 0));
+  }
+
+  /* the polar rows go through the C functions */
+  mgrs::geodetic_to_ups (mc.ups, lat, lon, ups);
+  for (size_t i = 0; i < rows; i++)
+  {
+    CHECK(ups[i].error == Convert_Geodetic_To_UPS_Ctx (&mc.ups, lat[i], lon[i], &hemisphere[i],
+                                                       &easting[i], &northing[i]));
+    if (ups[i].error)
+      hemisphere[i] = '?';
+  }
+  mgrs::ups_to_geodetic (mc.ups, hemisphere, easting, northing, geo);
+  mgrs::ups_to_mgrs (mc, hemisphere, easting, northing, precision, m);
+  mgrs::mgrs_to_ups (mc, mgrs::span < const char *const > (mgrs.data (), rows), ups);
+  for (size_t i = 0; i < rows; i++)
+  {
+    char one[MGRS_STRING_LENGTH];
+    double la, lo;
+    long error_code = Convert_UPS_To_MGRS_Ctx (&mc, hemisphere[i], easting[i], northing[i],
+                                               precision[i % 3], one);
+    CHECK((m[i].error == error_code) && (std::strcmp (m[i].mgrs, error_code ? "" : one) == 0));
+    error_code = Convert_UPS_To_Geodetic_Ctx (&mc.ups, hemisphere[i], easting[i], northing[i], &la, &lo);
+    CHECK(geo[i].error == error_code);
+    if (!error_code)
+      CHECK(same (geo[i].latitude, la) && same (geo[i].longitude, lo));
+  }
+}
+
+
+int main (void)
+{
+  const double a[] = {6378137.0, 6378206.4};
+  const double inv_f[] = {298.257223563, 294.9786982};
+  const char *code[] = {"WE", "CC"};
+  const char *bad[] = {"", "   ", "4QFJ1234567", "48PUV772983035", "148PUV7729983035",
+                       "48PUV77299830355", "48IUV77299830355", "48puv7729983035",
+                       "  48PUV7729983035", "61PUV7729983035", "00PUV7729983035",
+                       "32XUV12345678", "48PUVV7729983035", "48PU7729983035", "AJZ1234567",
+                       "ZAH12345678", "YZG1234567890", "48PUV 7729983035"};
+  const char letters[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+  char s[MGRS_STRING_LENGTH + 8];
+  unsigned long seed = 12345;
+  mgrs_context *ctx;
+  int k, engine;
+
+  /* a grid over both poles and the antimeridian, denser around Norway and
+     Svalbard, pseudo-random points, and missing values */
+  for (double la = -90.0; la <= 90.0; la += 1.3)
+    for (double lo = -181.0; lo <= 361.0; lo += 2.9)
+    {
+      lat.push_back (la * DEG_TO_RAD);
+      lon.push_back (lo * DEG_TO_RAD);
+    }
+  for (double la = 54.05; la <= 84.6; la += 0.25)
+    for (double lo = -1.05; lo <= 43.0; lo += 0.25)
+    {
+      lat.push_back (la * DEG_TO_RAD);
+      lon.push_back (lo * DEG_TO_RAD);
+    }
+  for (int i = 0; i < 50000; i++)
+  {
+    seed = (seed * 1103515245UL + 12345UL) % 2147483648UL;
+    lat.push_back ((seed / 2147483648.0 * 180.0 - 90.0) * DEG_TO_RAD);
+    seed = (seed * 1103515245UL + 12345UL) % 2147483648UL;
+    lon.push_back ((seed / 2147483648.0 * 540.0 - 180.0) * DEG_TO_RAD);
+  }
+  for (double edge : {0.0, 56.0, 64.0, 72.0, 84.0, 84.5, -80.0, -80.5})
+  {
+    lat.push_back (edge * DEG_TO_RAD);
+    lon.push_back (3.0 * DEG_TO_RAD);
+  }
+  lat.push_back (-5.0e-10);  /* rounded up to the equator */
+  lon.push_back (3.0 * DEG_TO_RAD);
+  lat.push_back (NAN);
+  lon.push_back (0.0);
+  lat.push_back (0.0);
+  lon.push_back (NAN);
+
+  /* every zone, band and square letter, and malformed strings */
+  for (int zone = 1; zone <= 60; zone += 1 + (zone % 7 == 3))
+    for (int b = 2; b < 24; b++)
+      for (int c = 0; c < 26; c++)
+        for (int r = 0; r < 26; r++)
+        {
+          std::snprintf (s, sizeof (s), "%02d%c%c%c%05d%05d", zone, letters[b], letters[c],
+                         letters[r], (zone * 7919 + r) % 100000, (c * 104729 + b) % 100000);
+          /* keep the leading (zone + r) % 6 digits of the easting and northing */
+          std::memmove (s + 5 + (zone + r) % 6, s + 10, (zone + r) % 6);
+          s[5 + 2 * ((zone + r) % 6)] = '\0';
+          strings.push_back (s);
+        }
+  for (const char *b : bad)
+    strings.push_back (b);
+
+  static_assert(noexcept(mgrs::geodetic_to_mgrs (std::declval < const MGRS_Context & > (), 0.0, 0.0, 5L)),
+                "conversions do not throw");
+
+  for (k = 0; k < 2; k++)
+  {
+    ctx = mgrs_context_create (a[k], 1 / inv_f[k], code[k], NULL);
+    CHECK(ctx != NULL);
+    for (engine = TRANMERC_THOMAS; engine <= TRANMERC_KRUGER; engine++)
+    {
+      CHECK(mgrs_context_set_engine (ctx, engine) == UTM_NO_ERROR);
+      const MGRS_Context &mc = *mgrs_context_get (ctx);
+      test_tm (mc.utm);
+      test_utm (mc.utm);
+      test_mgrs (mc);
+      test_batch (mc);
+    }
+    mgrs_context_destroy (ctx);
+  }
+
+  if (failures)
+    fprintf (stderr, "%d checks failed\n", failures);
+  return (failures ? 1 : 0);
+}